@@ -0,0 +1,47 @@
+#ifndef AUDIO_COMMAND_QUEUE_H
+#define AUDIO_COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Control messages from the loop to the A2DP callback. The callback owns
+// every voice's playback state; the loop only prepares idle voices and
+// asks for changes through here.
+enum AudioCommandType : uint8_t {
+    AUDIO_CMD_START,     // Voice was set up by the loop, start mixing it
+    AUDIO_CMD_CHAIN,     // Start voice `next` on the frame this voice's data ends
+    AUDIO_CMD_STOP,      // Cut one voice
+    AUDIO_CMD_FADE_OUT,  // Release one voice over the crossfade time (choke, steal)
+    AUDIO_CMD_CROSSFADE, // Same, equal-power: the retriggered clip fades in over it
+    AUDIO_CMD_RELEASE,   // Release one voice over the end-of-clip fade (loop stop)
+    AUDIO_CMD_STOP_ALL,  // Cut every voice (the bed keeps playing)
+    AUDIO_CMD_BED_START, // Background bed was set up by the loop
+    AUDIO_CMD_BED_STOP,  // Fade the bed out, then release it
+    AUDIO_CMD_TEST_TONE  // Play one second of 1kHz in place of the mix
+};
+
+struct AudioCommand {
+    uint8_t type;
+    uint8_t voice;
+    uint8_t next;        // AUDIO_CMD_CHAIN: the voice that follows
+    uint32_t seq;        // Reported back once the callback has applied it
+};
+
+// Bounded lock-free single-producer / single-consumer queue.
+// Producer = loop task, consumer = A2DP data callback.
+class AudioCommandQueue {
+public:
+    static const uint32_t CAPACITY = 16;  // Power of two
+
+    AudioCommandQueue();
+
+    bool push(const AudioCommand& cmd);  // false if full, never blocks
+    bool pop(AudioCommand& cmd);         // false if empty
+
+private:
+    AudioCommand slots[CAPACITY];
+    std::atomic<uint32_t> head;  // Free-running, written by the producer
+    std::atomic<uint32_t> tail;  // Free-running, written by the consumer
+};
+
+#endif
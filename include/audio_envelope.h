@@ -0,0 +1,48 @@
+#ifndef AUDIO_ENVELOPE_H
+#define AUDIO_ENVELOPE_H
+
+#include <stdint.h>
+
+// Sample-counted gain ramp in Q15 (32768 = 1.0).
+// The ramp position is kept with 16 extra fraction bits and stepped once
+// per frame, so the output depends only on the input samples and the
+// frame counts - no clocks, no floats, bit-exact on every platform.
+class AudioEnvelope {
+public:
+    static const int32_t UNITY = 32768;
+
+    // How the ramp position maps to gain
+    enum Shape : uint8_t {
+        SHAPE_LINEAR,       // Gain = position
+        SHAPE_EQUAL_POWER   // Quarter sine of the position: a fade-out and a
+                            // fade-in of the same length sum to constant power
+    };
+
+    AudioEnvelope();
+
+    // Switching keeps the current gain: the ramp position is re-expressed
+    // in the new shape and a running ramp continues from there
+    void setShape(Shape s);
+
+    void set(int32_t gainQ15);                                  // Jump, no ramp
+    void start(int32_t fromQ15, int32_t toQ15, uint32_t frames); // Linear ramp
+    void rampTo(int32_t toQ15, uint32_t frames);                // From current gain
+
+    bool isRamping() const { return remaining > 0; }
+    int32_t gain() const { return (int32_t)(acc >> 16); }  // Ramp position
+
+    // Scale interleaved stereo in place, advancing the ramp by frames
+    void apply(int16_t* stereo, int frames);
+
+private:
+    int64_t acc;         // Current gain, Q15 << 16
+    int64_t step;        // Per-frame increment, Q15 << 16
+    int32_t target;      // Gain at the end of the ramp
+    uint32_t remaining;  // Frames left in the ramp
+    Shape shape;
+
+    int32_t shaped(int32_t position) const;
+    static int32_t equalPowerPosition(int32_t gainQ15);  // Inverse of the quarter sine
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef AUDIO_LOG_H
+#define AUDIO_LOG_H
+
+#include <Arduino.h>
+#include "pin_config.h"
+
+// Deferred logging for the audio path. Callers store a fixed-size binary
+// record (timestamp, message id, integer args, optional short text) in a
+// lock-free ring; a low-priority task formats and prints them. Pushing
+// never blocks, never allocates and never touches the UART, so it is safe
+// in the A2DP callback, the stream task and on the trigger path. When the
+// ring is full the record is dropped and counted.
+
+#define AUDIO_LOG_ERROR 1
+#define AUDIO_LOG_WARN  2
+#define AUDIO_LOG_INFO  3
+#define AUDIO_LOG_DEBUG 4
+
+// Message table: id, printf format. Formats with a %s take the text first,
+// then the integer args in order.
+#define AUDIO_LOG_MESSAGES(X) \
+    X(LOG_CALLBACK_STARTED,  "[AUDIO] Callback started") \
+    X(LOG_PLAY_REQUEST,      "[PLAY] %s (button %d)") \
+    X(LOG_PLAY_NOT_CONNECTED,"[PLAY] Cannot play - Bluetooth not connected") \
+    X(LOG_PLAY_NOT_FOUND,    "[PLAY] Flash jingle not found: %s") \
+    X(LOG_PLAY_OPEN_FAILED,  "[PLAY] Failed to open %s") \
+    X(LOG_PLAY_INVALID,      "[PLAY] Invalid WAV file: %s") \
+    X(LOG_PLAY_NO_VOICE,     "[PLAY] No free voice (audio callback not running?)") \
+    X(LOG_PLAY_QUEUE_FULL,   "[AUDIO] Command queue full (command %d, voice %d)") \
+    X(LOG_PLAY_SD,           "[PLAY] %s on voice %d") \
+    X(LOG_PLAY_PREFETCHED,   "[PLAY] %s on voice %d (prefetched)") \
+    X(LOG_PLAY_ATTACK,       "[PLAY] %s on voice %d (attack cache)") \
+    X(LOG_PLAY_CLIP_CACHE,   "[PLAY] %s on voice %d (clip cache)") \
+    X(LOG_PLAY_FLASH,        "[PLAY] %s on voice %d (flash)") \
+    X(LOG_SEQ_CHAINED,       "[SEQ] %s primed on voice %d, follows voice %d") \
+    X(LOG_SEQ_SKIPPED,       "[SEQ] Skipping %s") \
+    X(LOG_BED_START,         "[BED] %s looping") \
+    X(LOG_BED_FAILED,        "[BED] Cannot play %s") \
+    X(LOG_STREAM_OPEN_FAILED,"[AUDIO] Stream open failed: %s") \
+    X(LOG_WAV_PACK_ENTRY,    "[WAV] Pack entry not found: %s") \
+    X(LOG_WAV_NOT_RIFF,      "[WAV] Not a RIFF/WAVE file or no data chunk") \
+    X(LOG_WAV_CHANNELS,      "[WAV] Channel count %d not supported (need 1 or 2)") \
+    X(LOG_WAV_ADPCM_HEADER,  "[WAV] Malformed IMA-ADPCM header") \
+    X(LOG_WAV_FORMAT,        "[WAV] Format %d / %d-bit not supported") \
+    X(LOG_WAV_BLOCK_ALIGN,   "[WAV] Block align %d does not match format") \
+    X(LOG_WAV_RATE,          "[WAV] Sample rate %d not supported (need 8000-48000)") \
+    X(LOG_WAV_VALID,         "[WAV] Header OK: %d ch, %d Hz, %d-bit, format 0x%x") \
+    X(LOG_STATS_LATENCY,     "[LATENCY] %s: n=%d p50=%d p95=%d p99=%d max=%d us") \
+    X(LOG_STATS_STREAM,      "[AUDIO] Stream low-water %d/%d bytes, %d underruns (%d frames)") \
+    X(LOG_STATS_CALLBACK,    "[PROFILE] %d calls, %d/%d/%d us min/avg/max, read %d%%, %d underruns") \
+    X(LOG_STATS_BED,         "[PROFILE] Bed %d cycles/frame, %d ms total") \
+    X(LOG_STATS_CACHE,       "[CACHE] %d clips, %d/%d KB, %d hits, %d misses, %d evictions")
+
+enum AudioLogId : uint16_t {
+#define AUDIO_LOG_ENUM(id, fmt) id,
+    AUDIO_LOG_MESSAGES(AUDIO_LOG_ENUM)
+#undef AUDIO_LOG_ENUM
+    LOG_MESSAGE_COUNT
+};
+
+#define AUDIO_LOG_ARGS 6
+#define AUDIO_LOG_TEXT_LEN 24  // Longer text keeps its tail (end of the path)
+
+bool audioLogBegin();  // Start the drain task
+void audioLogPush(uint8_t level, uint16_t id, const char* text,
+                  int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0,
+                  int32_t a3 = 0, int32_t a4 = 0, int32_t a5 = 0);
+
+// Level-filtered entry points. Disabled levels compile to nothing (the
+// dead call only keeps the arguments type-checked and "used").
+#if AUDIO_LOG_LEVEL >= AUDIO_LOG_ERROR
+#define ALOG_ERROR(id, text, ...) audioLogPush(AUDIO_LOG_ERROR, id, text, ##__VA_ARGS__)
+#else
+#define ALOG_ERROR(id, text, ...) do { if (0) audioLogPush(AUDIO_LOG_ERROR, id, text, ##__VA_ARGS__); } while (0)
+#endif
+#if AUDIO_LOG_LEVEL >= AUDIO_LOG_WARN
+#define ALOG_WARN(id, text, ...) audioLogPush(AUDIO_LOG_WARN, id, text, ##__VA_ARGS__)
+#else
+#define ALOG_WARN(id, text, ...) do { if (0) audioLogPush(AUDIO_LOG_WARN, id, text, ##__VA_ARGS__); } while (0)
+#endif
+#if AUDIO_LOG_LEVEL >= AUDIO_LOG_INFO
+#define ALOG_INFO(id, text, ...) audioLogPush(AUDIO_LOG_INFO, id, text, ##__VA_ARGS__)
+#else
+#define ALOG_INFO(id, text, ...) do { if (0) audioLogPush(AUDIO_LOG_INFO, id, text, ##__VA_ARGS__); } while (0)
+#endif
+#if AUDIO_LOG_LEVEL >= AUDIO_LOG_DEBUG
+#define ALOG_DEBUG(id, text, ...) audioLogPush(AUDIO_LOG_DEBUG, id, text, ##__VA_ARGS__)
+#else
+#define ALOG_DEBUG(id, text, ...) do { if (0) audioLogPush(AUDIO_LOG_DEBUG, id, text, ##__VA_ARGS__); } while (0)
+#endif
+
+#endif
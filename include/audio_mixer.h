@@ -0,0 +1,21 @@
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+#include <Arduino.h>
+
+// Fixed-point mixing kernels for the A2DP callback.
+// Samples are interleaved stereo int16, the accumulator is int32 so any
+// number of voices can be summed before a single saturating store.
+// Kernels are flat counted loops over restrict pointers with no branches
+// in the body, which lets GCC unroll them and keeps them drop-in
+// replaceable by esp-dsp (dsps_mulc / dsps_add) on targets that have it.
+
+#define MIX_UNITY_GAIN 32768  // Q15 1.0
+#define MIX_MAX_GAIN   65536  // Q15 2.0 - sample * gain still fits in int32
+
+void mixClear(int32_t* acc, int samples);
+void mixAccumulate(int32_t* __restrict acc, const int16_t* __restrict src,
+                   int32_t gainQ15, int samples);
+void mixToInt16(const int32_t* __restrict acc, int16_t* __restrict out, int samples);
+
+#endif
@@ -4,7 +4,28 @@
 #include <Arduino.h>
 #include <SD.h>
 #include <vector>
+#include <atomic>
 #include "BluetoothA2DPSource.h"
+#include "audio_ring_buffer.h"
+#include "audio_envelope.h"
+#include "resampler.h"
+#include "wav_format.h"
+#include "pcm_convert.h"
+#include "ima_adpcm.h"
+#include "jingle_catalog.h"
+#include "flash_jingles.h"
+#include "audio_source.h"
+#include "clip_cache.h"
+#include "audio_command_queue.h"
+#include "latency_histogram.h"
+#include "pin_config.h"
+
+// What happens when a button fires while jingles are already sounding
+enum TriggerPolicy {
+    TRIGGER_OVERLAP,  // Start another voice, leave everything else playing
+    TRIGGER_RESTART,  // Cut this button's previous voice, keep the others
+    TRIGGER_CHOKE     // Cut every voice in the same choke group
+};
 
 class AudioPlayer {
 public:
@@ -12,8 +33,57 @@ public:
 
     bool begin(const char* deviceName = "JBL Flip 5", const char* deviceMac = nullptr, bool clearPairing = false);
     void end();  // Stop A2DP (call before starting WiFi AP)
-    bool playFile(const String& filepath);
-    void stop();
+    // filepath is an audio source: "sd:/jingles/x.wav", "/jingles/x.wav" or "flash:<slot>"
+    bool playFile(const String& filepath);  // Legacy: chokes group 0 (cuts other jingles)
+    // Trigger path: src comes parsed (parseAudioSource() at config load), so
+    // playing it builds no strings. Only a fresh SD open, the cold path,
+    // has the file system allocate.
+    // triggerUs: esp_timer_get_time() of the touch that caused this play, for
+    // the latency histograms (0 = not a touch, not measured).
+    // startMs/endMs: non-destructive trim, only [startMs, endMs) of the file
+    // plays (endMs 0 = to the end). Reading starts with a seek to startMs.
+    bool playFile(const AudioSource& src, int buttonId, TriggerPolicy policy,
+                  int chokeGroup = 0, int32_t gainQ15 = 32768, uint32_t triggerUs = 0,
+                  uint32_t startMs = 0, uint32_t endMs = 0);
+    void stop();  // Stop all voices
+
+    // Button sequence: play files[0..count) back to back with no gap. The
+    // first starts like playFile(); each next one is opened and primed on a
+    // spare voice while the one before plays, and the callback switches
+    // over on the exact frame its data ends. gainsQ15 has one gain per file.
+    // The trim applies to files[0]. files is not copied: it has to stay as
+    // it is while the sequence runs (the caller's button table).
+    bool playSequence(const AudioSource* files, int count, const int32_t* gainsQ15, int buttonId,
+                      TriggerPolicy policy, int chokeGroup = 0, uint32_t triggerUs = 0,
+                      uint32_t startMs = 0, uint32_t endMs = 0);
+    void updateSequences();  // Loop: prime the next item of running sequences
+
+    // Looping cue (toggle buttons): plays into the loop, then repeats
+    // [loopStart, loopEnd) in file frames until stopButton(). loopEnd 0 =
+    // the file's smpl loop, or the whole file if it has none.
+    bool playLoop(const AudioSource& src, int buttonId, TriggerPolicy policy, int chokeGroup,
+                  int32_t gainQ15, uint32_t triggerUs, uint32_t loopStart = 0, uint32_t loopEnd = 0);
+    void stopButton(int buttonId);       // Fade out whatever this button is playing
+    bool isButtonPlaying(int buttonId);
+
+    // Finger-down prefetch: the stream task opens, validates and buffers the
+    // file in the background; a playFile() with the same path then starts
+    // from that buffer instead of the SD card. startMs: the trim it will
+    // be played with, the buffer starts there. src is not copied: cancel the
+    // prefetch before changing it.
+    void prefetch(const AudioSource& src, uint32_t startMs = 0);
+    void cancelPrefetch();
+
+    // Background bed: one long track looping under the jingles from SD,
+    // with its own ring that is refilled after the jingle voices. A
+    // sidechain follower on the jingle mix ducks it while they sound.
+    bool playBed(const String& filepath);
+    void stopBed();                          // Fades out
+    bool isBedPlaying();
+    void setBedLevel(int32_t gainQ15);       // Bed level with no jingle playing
+    // duckGainQ15: bed gain (relative to its level) under a loud jingle.
+    // attackMs / releaseMs: time constants for ducking / recovering.
+    void setDucking(int32_t duckGainQ15, uint32_t attackMs, uint32_t releaseMs);
     bool isPlaying();
     bool isConnected();
     void setVolume(uint8_t volume); // 0-127
@@ -21,6 +91,55 @@ public:
     void checkAndReconnectWiFi(); // Check if WiFi reconnection needed after playback
     static void resetAudioBuffers(); // Reset static buffers in callback
 
+    // Streaming headroom (SD prefetch ring buffer)
+    struct StreamStats {
+        uint32_t capacity;        // Ring size in bytes
+        uint32_t fill;            // Bytes currently buffered
+        uint32_t minFill;         // Low-water mark since last reset
+        uint32_t underruns;       // Callbacks that ran dry mid-file
+        uint32_t underrunFrames;  // Frames zero-filled because of that
+    };
+    StreamStats getStreamStats();
+    void resetStreamStats();
+
+    // Mixer load: average CPU cycles per output frame, by active voice count
+    struct MixerStats {
+        uint8_t voices;                                  // Currently active
+        uint32_t cyclesPerFrame[AUDIO_MAX_VOICES + 1];   // Index = voices mixed
+    };
+    MixerStats getMixerStats();
+
+    // Attack cache: first AUDIO_ATTACK_CACHE_MS of each button's jingle in RAM
+    // so a tap starts sounding before the SD file is even opened. A trimmed
+    // button caches from its startMs; only plays with that trim hit it.
+    bool cacheAttack(int slot, const AudioSource& src, uint32_t startMs = 0);
+    void clearAttackCache();
+
+    // Whole-clip LRU cache in PSRAM / RAM, filled as clips play from SD.
+    // Budget 0 = auto; set before begin()
+    void setClipCacheBudget(size_t bytes);
+    ClipCache::Stats getClipCacheStats();
+
+    // Audio engine entry point, independent of the Bluetooth stack: apply
+    // queued commands and mix frameCount frames of interleaved 44.1kHz
+    // stereo into out. audioCallback() is only the A2DP adapter around it,
+    // so another sink (I2S, a host harness) can drive the same engine.
+    static int32_t render(int16_t* out, int32_t frameCount);
+
+    // Retrigger crossfade: voices cut by the trigger policy fade out over
+    // this many ms while the new clip fades in; equal-power when a button
+    // retriggers its own clip, linear otherwise. 0 = hard cut.
+    void setCrossfade(uint32_t ms);
+
+    // Sample-rate conversion quality for non-44.1kHz files (next play onwards)
+    void setResampleQuality(Resampler::Quality quality);
+
+    // Pre-parsed headers from the on-card index (optional)
+    void setCatalog(JingleCatalog* cat);
+
+    // Memory-mapped "jingles" flash partition for flash:<slot> sources (optional)
+    void setFlashJingles(FlashJingles* store);
+
     // NEW: Scanning and pairing methods (Settings Mode only)
     struct BTDevice {
         String name;
@@ -41,15 +160,144 @@ public:
 
 private:
     BluetoothA2DPSource a2dp_source;
-    static File currentFile;
-    static bool playing;
-    static bool isMono;  // Track if current file is mono (1 channel)
-    static uint32_t fileSize;
-    static uint32_t bytesRead;
+    JingleCatalog* catalog;
+    FlashJingles* flash;
     static bool needsWiFiReconnect;  // Flag to trigger WiFi reconnection after playback
 
+    enum VoiceState : uint8_t {
+        VOICE_IDLE,
+        VOICE_PLAYING,
+        VOICE_TAIL      // File finished, silence padding before going idle
+    };
+
+    // One mixer voice: its own SD stream, cached attack, gain and fades.
+    // Set up by the loop while free, then started/stopped only through the
+    // command queue. Playback fields (state included) belong to the
+    // callback, file fields to the stream task (under streamMutex).
+    struct Voice {
+        std::atomic<uint8_t> state;
+        bool looping;                 // Repeats its region (bed, loop cues)
+        bool releasing;               // Fading out after a cut, idle once the ramp ends
+        int8_t next;                  // Sequence: voice started where this one's data ends, -1 = none
+        int buttonId;
+        int chokeGroup;               // -1 = not in a choke group
+        uint32_t startSeq;            // For stealing the oldest voice
+        uint32_t triggerUs;           // Touch time, cleared once the fade-in is done
+        bool firstFrameOut;           // Latency stage LATENCY_FIRST_FRAME recorded
+        int32_t gain;                 // Q15
+        WavInfo info;
+        PcmConvertFn convert;         // Ring format -> stereo int16
+        uint16_t frameBytes;          // Bytes per frame in the ring / attack cache
+        uint32_t dither;              // TPDF noise state for >16-bit files
+        uint32_t bytesRead;           // Data bytes consumed by the callback
+        uint32_t regionStart;         // File frames played, end exclusive: the
+        uint32_t regionEnd;           // loop, or the trim of a one-shot
+
+        const uint8_t* attackData;    // Attack cache hit / mapped flash clip, or nullptr
+        uint32_t attackLen;
+        uint32_t attackPos;
+
+        Resampler rs;                 // File rate -> 44.1kHz (bypass if equal)
+        AudioEnvelope env;            // Fade-in / fade-out, sample counted
+        uint32_t fadeInFrames;
+        uint32_t framesPlayed;        // Output (44.1kHz) frames so far
+        uint32_t totalFrames;         // Expected output frames for the clip
+        uint32_t fadeOutFrame;        // Frame where the fade-out ramp begins
+        bool inFadeOut;
+        uint32_t tailFramesLeft;      // Silence padding after the file
+
+        AudioRingBuffer ring;         // SD prefetch, stream task -> callback
+        std::atomic<bool> flushPending;
+        uint32_t flushIndex;
+        File file;
+        uint32_t streamBytesLeft;     // Data bytes not yet read from SD
+        std::atomic<bool> streamEof;  // Whole data chunk is in the ring
+        std::atomic<bool> releaseStream;  // Cut by the callback, stream task closes the file
+        ImaAdpcmDecoder adpcm;        // Stream-side decoder for ADPCM files
+        uint32_t streamFrame;         // ADPCM: next file frame the decoder yields
+        uint32_t skipFrames;          // ADPCM: frames to drop ahead of a region start mid-block
+        const String* openPath;       // Deferred open (attack cache hit): the slot's file
+        uint32_t openOffset;
+        bool openPending;
+        ClipCache::Clip* fillClip;    // Clip cache entry this stream is filling
+        uint32_t fillPos;
+    };
+
+    // Loop side: a running button sequence. Item `nextItem` goes on a
+    // free voice as soon as `voice` is playing and is chained to it there.
+    struct Sequence {
+        const AudioSource* files;     // The caller's, see playSequence()
+        int32_t gains[AUDIO_SEQUENCE_MAX];
+        int count;                    // 0 = not running
+        int nextItem;
+        int voice;                    // Voice playing the current item
+        int next;                     // Voice primed with the next item, -1 = none yet
+        int buttonId;
+        TriggerPolicy policy;
+        int chokeGroup;
+    };
+
+    static Voice voices[AUDIO_VOICE_SLOTS];
+    static Voice bed;                       // Background bed, outside the jingle voice pool
+    static Sequence sequences[AUDIO_MAX_VOICES];
+    static uint32_t voiceSeq;
+    static TaskHandle_t streamTaskHandle;
+    static SemaphoreHandle_t streamMutex;   // Guards voice files between loop and stream task
+
+    static bool startStreamTask(AudioPlayer* owner);
+    static void streamTask(void* param);
+    static bool fillRing(Voice& v);
+    static bool fillRingAdpcm(Voice& v);
+    static bool openPendingStream(Voice& v);
+    static bool rewindStream(Voice& v);
+    bool runPrefetch();
+    bool takePrefetch(const String& uri, uint32_t startMs, File& file, WavInfo& info);
+    static void teeClip(Voice& v, const uint8_t* data, size_t len);
+    static void abortClipFill(Voice& v);
+    static bool clipInUse(const uint8_t* data);
+    // after < 0: trigger a voice (policy, fade-in, START). Otherwise prime a
+    // free voice to follow voice `after` (no fades at the join, CHAIN).
+    // Returns the voice index, or -1.
+    // loop: repeat loopStart..loopEnd (see playLoop()) instead of ending.
+    // startMs/endMs: one-shot trim (see playFile()), ignored by loops.
+    int startVoice(const AudioSource& src, int buttonId, TriggerPolicy policy, int chokeGroup,
+                   int32_t gainQ15, uint32_t triggerUs, int after, bool fadeOut,
+                   bool loop = false, uint32_t loopStart = 0, uint32_t loopEnd = 0,
+                   uint32_t startMs = 0, uint32_t endMs = 0);
+    // startVoice() steps, one find* / prime* pair per source path
+    struct StartPlan;
+    bool findSource(const AudioSource& src, uint32_t startMs, uint32_t endMs, bool sequenceItem,
+                    StartPlan& plan);
+    bool findFlashClip(const AudioSource& src, StartPlan& plan);
+    static bool findCachedClip(const AudioSource& src, uint32_t startMs, uint32_t endMs, StartPlan& plan);
+    static bool findAttack(const AudioSource& src, uint32_t startMs, StartPlan& plan);
+    bool openSdClip(const AudioSource& src, StartPlan& plan);
+    static bool planRegion(StartPlan& plan, bool loop, uint32_t loopStart, uint32_t loopEnd,
+                           uint32_t startMs, uint32_t endMs);
+    static void primeMapped(Voice& v);
+    static void primeFromAttack(Voice& v, const StartPlan& plan);
+    static void primeFromPrefetch(Voice& v, const StartPlan& plan);
+    static void primeFromSd(Voice& v, const StartPlan& plan, bool sequenceItem);
+    static bool voiceInSequence(int index);
+    static void cancelSequence(int index, uint8_t type);
+    static void stopVoice(Voice& v, bool crossfade); // Loop side: queue a cut
+    static Voice* allocateVoice(int buttonId, TriggerPolicy policy, int chokeGroup,
+                                bool& replaced, bool& retriggered);
+    static bool voiceFree(int index);            // Loop side: idle and no command in flight
+    static bool bedFree();
+    static bool sendCommand(uint8_t type, int voice, int next = -1);
+    static bool waitForCallback(uint32_t timeoutMs);
+    static void applyCommand(const AudioCommand& cmd);
+    static void startRelease(Voice& v, uint32_t frames,
+                             AudioEnvelope::Shape shape = AudioEnvelope::SHAPE_LINEAR);
+    static void publishSnapshot();
+    static void releaseVoiceStream(Voice& v);
+    static int readVoiceFrames(Voice& v, int16_t* out, int maxFrames);
+    static int renderVoice(Voice& v, int32_t* acc, int frameCount);
+    static void mixBed(int32_t* acc, int frameCount);
+
     static int32_t audioCallback(Frame *data, int32_t frameCount);
-    bool validateWAVHeader(File& file);
+    bool validateWAVHeader(File& file, const String& filepath, WavInfo& info);
 
     // NEW: Static callback for scanning
     static bool scanCallback(const char* ssid, esp_bd_addr_t address, int rssi);
@@ -0,0 +1,57 @@
+#ifndef AUDIO_PROFILER_H
+#define AUDIO_PROFILER_H
+
+#include <Arduino.h>
+#include "pin_config.h"
+
+// A2DP callback profiler. The callback times itself with the CPU cycle
+// counter and hands one summary per call to profilerCallback(). Underruns
+// (frames zero-filled because a voice's ring ran dry) are counted, and the
+// worst PROFILER_EVENTS of them are kept with a timestamp. Everything lives in RTC memory so /api/profile in
+// Settings Mode can show the last Normal Mode session.
+
+#define PROFILER_EVENTS 16
+#define PROFILER_VOICE_BED 0xFE  // ProfilerEvent.voice of the background bed
+
+struct ProfilerEvent {
+    uint32_t timeMs;        // Since boot
+    uint8_t voice;
+    int8_t buttonId;
+    uint16_t frames;        // Zero-filled frames in that callback
+    uint32_t ringFill;      // Bytes left in the ring
+};
+
+struct ProfilerStats {
+    uint32_t calls;
+    uint64_t framesRequested;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint32_t avgUs;
+    uint64_t readUs;         // Ring / attack cache reads
+    uint64_t processUs;      // Conversion, resampling, fades and mixing
+    uint32_t underruns;      // Voice-callbacks that ran dry mid-file
+    uint64_t underrunFrames; // Frames zero-filled because of that
+    uint64_t paddingFrames;  // Intentional silence (tail padding after a clip)
+    uint64_t bedUs;          // Background bed: stream read, ducking and mix
+    uint32_t bedCyclesPerFrame;  // ... averaged over the frames it played
+    ProfilerEvent events[PROFILER_EVENTS];  // Worst (most frames) first
+    uint8_t eventCount;
+};
+
+void profilerBegin();
+void profilerReset();
+void profilerSnapshot(ProfilerStats& out);
+
+#if AUDIO_PROFILER
+// Callback side, one writer
+void profilerCallback(uint32_t frames, uint32_t cycles, uint32_t readCycles, uint32_t paddingFrames,
+                      uint32_t bedCycles, uint32_t bedFrames);
+void profilerUnderrun(uint8_t voice, int buttonId, uint32_t frames, uint32_t ringFill);
+#define PROFILER_CYCLES() ESP.getCycleCount()
+#else
+inline void profilerCallback(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t) {}
+inline void profilerUnderrun(uint8_t, int, uint32_t, uint32_t) {}
+#define PROFILER_CYCLES() 0u
+#endif
+
+#endif
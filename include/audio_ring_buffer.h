@@ -0,0 +1,42 @@
+#ifndef AUDIO_RING_BUFFER_H
+#define AUDIO_RING_BUFFER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Lock-free single-producer / single-consumer byte ring.
+// Producer = SD streaming task, consumer = A2DP data callback.
+// head is only written by the producer, tail only by the consumer, so
+// neither side ever blocks or takes a lock.
+class AudioRingBuffer {
+public:
+    AudioRingBuffer();
+    ~AudioRingBuffer();
+
+    bool allocate(size_t bytes);  // Rounded up to a power of two
+    void release();
+
+    size_t capacity() const { return size; }
+    size_t available() const;     // Bytes ready for the consumer
+    size_t freeSpace() const;     // Bytes the producer may write
+
+    // Producer side
+    size_t write(const uint8_t* src, size_t len);
+    size_t writeRegion(uint8_t** ptr);  // Contiguous writable span, no copy
+    void commitWrite(size_t len);
+    uint32_t writeIndex() const { return head.load(std::memory_order_relaxed); }
+
+    // Consumer side
+    size_t read(uint8_t* dst, size_t len);
+    void skip(size_t len);
+    void discardUntil(uint32_t index);  // Drop everything written before index
+
+private:
+    uint8_t* buf;
+    size_t size;
+    size_t mask;
+    std::atomic<uint32_t> head;  // Free-running write counter
+    std::atomic<uint32_t> tail;  // Free-running read counter
+};
+
+#endif
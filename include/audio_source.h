@@ -0,0 +1,26 @@
+#ifndef AUDIO_SOURCE_H
+#define AUDIO_SOURCE_H
+
+#include <Arduino.h>
+
+// Where a jingle lives. Button "file" values are one of
+//   sd:/jingles/x.wav      file (or pack entry) on the SD card
+//   /jingles/x.wav         same, the format configs used before sd: existed
+//   flash:<slot>           entry of the "jingles" flash partition, by index or name
+enum AudioSourceType {
+    SOURCE_SD,
+    SOURCE_FLASH
+};
+
+// Parsed once when the config is loaded, so a trigger only compares and
+// reads these strings and never builds one
+struct AudioSource {
+    AudioSourceType type;
+    String uri;   // As configured: the key for the caches and the prefetch
+    String path;  // SD path, or flash slot
+    String file;  // SD file to open: the pack for "pack.jpk#entry", else path
+};
+
+AudioSource parseAudioSource(const String& uri);
+
+#endif
@@ -13,6 +13,7 @@ struct Button {
     String filepath;
     uint16_t color;
     uint16_t textColor;
+    bool latched;  // Toggle (loop) button that is on: drawn highlighted
 };
 
 class ButtonManager {
@@ -22,8 +23,13 @@ public:
     void loadConfig(const JsonDocument& config);
     void draw();
     int checkTouch();
+    int buttonAt(int x, int y) const;     // Button under a screen point, or -1
     void setSimulatedTouch(bool enabled);  // Enable/disable simulated touch for testing
     void highlightButton(int id);
+    void setHighlight(int id, bool on);  // Non-blocking variant: caller clears it
+    // Toggle buttons: stay highlighted while on, whatever flashes in between
+    void setLatched(int id, bool on);
+    bool isLatched(int id) const;
     String getButtonFile(int id);
 
 private:
@@ -0,0 +1,73 @@
+#ifndef CLIP_CACHE_H
+#define CLIP_CACHE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "pin_config.h"
+#include "wav_format.h"
+#include "pcm_convert.h"
+
+// Whole-clip LRU cache with a byte budget. Clips are stored in ring format
+// (what the callback reads: PCM as on SD, ADPCM already decoded) and are
+// filled as a side effect of the first play, so a miss costs nothing
+// extra. Structure changes (lookup/reserve/abort/evict) happen on the loop
+// task only; the stream task just copies into a reserved clip and flags it
+// complete.
+class ClipCache {
+public:
+    struct Clip {
+        String path;                   // Audio source as passed to playFile
+        uint32_t startMs;              // Trim the clip holds, 0/0 = whole file
+        uint32_t endMs;
+        uint8_t* data;                 // nullptr = free slot
+        uint32_t len;
+        WavInfo info;
+        PcmConvertFn convert;
+        uint16_t frameBytes;
+        uint32_t lastUse;              // LRU stamp
+        std::atomic<bool> complete;    // Set by the stream task once filled
+    };
+
+    struct Stats {
+        uint32_t budget;       // Bytes
+        uint32_t used;         // Bytes allocated (complete + filling)
+        uint8_t clips;         // Complete clips
+        uint32_t hits;
+        uint32_t misses;
+        uint32_t evictions;
+        bool psram;
+    };
+
+    // Clips a voice is still reading from must not be evicted
+    typedef bool (*InUseFn)(const uint8_t* data);
+
+    ClipCache();
+
+    void begin(size_t budgetBytes, InUseFn inUse);  // 0 = auto (PSRAM / internal)
+    // A trimmed play has its own entry, holding only its part: the trim is
+    // part of the key
+    const Clip* lookup(const String& path, uint32_t startMs = 0, uint32_t endMs = 0);  // Complete clip or nullptr
+    bool contains(const String& path, uint32_t startMs = 0, uint32_t endMs = 0) const; // Same, no hit/miss count
+    Clip* reserve(const String& path, uint32_t startMs, uint32_t endMs, uint32_t len,
+                  const WavInfo& info, PcmConvertFn convert, uint16_t frameBytes);  // Starts a fill
+    void abort(Clip* clip);                         // Drop an unfinished fill
+    void clear();
+    Stats getStats();
+
+private:
+    Clip clips[AUDIO_CLIP_CACHE_SLOTS];
+    size_t budget;
+    size_t used;
+    bool usePsram;
+    uint32_t useCounter;
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    InUseFn inUse;
+
+    static bool matches(const Clip& clip, const String& path, uint32_t startMs, uint32_t endMs);
+    bool evictOne();
+    void release(Clip& clip);
+};
+
+#endif
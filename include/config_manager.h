@@ -6,6 +6,9 @@
 #include <LittleFS.h>
 #include <ArduinoJson.h>
 
+// Largest config document accepted from NVS or /api/config
+#define CONFIG_MAX_JSON_BYTES 8192
+
 class ConfigManager {
 public:
     ConfigManager();
@@ -15,18 +18,46 @@ public:
     bool saveConfig(const JsonDocument& config);
     const JsonDocument& getConfig();
 
+    // Shape check before a document replaces the running config: an object,
+    // with "buttons" (if present) an array of at most 8 objects
+    static bool isValidConfig(const JsonDocument& doc);
+    // Remove whatever isValidConfig() rejects inside an object, keep the rest
+    static void repairConfig(JsonDocument& doc);
+
     bool isSettingsMode();
     void enterSettingsMode();
     void exitSettingsMode();
     void clearSettingsModeFlag();  // Clear flag without restarting
 
     String getButtonFile(int id);
+    // "file" then the files in "then": up to maxFiles paths, returns the count
+    int     getButtonSequence(int id, String* files, int maxFiles);
+    // "loop": true (file's smpl loop, else whole file) or [start, end] in
+    // file frames. Looping buttons toggle. start = end = 0: the file decides
+    bool    getButtonLoop(int id, uint32_t& start, uint32_t& end);
+    // "startMs"/"endMs": play only that part of "file", the file itself is
+    // never touched. endMs 0 = to the end. Returns false if untrimmed
+    bool    getButtonTrim(int id, uint32_t& startMs, uint32_t& endMs);
+    int     getButtonGainDb(int id);     // "gainDb" x10 (-24 to +12 dB), default 0
     String getButtonColor(int id);
+    String getButtonMode(int id);        // "choke" (default), "restart", "overlap"
+    int     getButtonChokeGroup(int id); // default 0
     String getBTDeviceName();
     String getBTDeviceMac();
     uint8_t getBTVolume();
     uint8_t getBrightness();       // 10..255, default 200
     int     getTouchThreshold();   // 50..500, default 200
+    int     getResampleQuality();  // 0=low, 1=medium (default), 2=high
+    uint32_t getClipCacheKB();     // 0 = auto (default)
+    bool    getTriggerOnPress();   // "triggerOn": "release" (default) or "press"
+    int     getRetriggerMs();      // 5..500, default 40 (press mode only)
+    int     getCrossfadeMs();      // 0..200, default 30; 0 = hard cut on retrigger
+    int     getLoudnessTarget();   // LUFS x10, -400..-50, default -160; 0 = normalisation off
+    String  getBedFile();          // Background bed audio source, "" = none
+    int     getBedLevel();         // 0..100 %, default 40
+    int     getDuckDb();           // -40..0 dB, default -12
+    int     getDuckAttackMs();     // 5..2000, default 50
+    int     getDuckReleaseMs();    // 20..5000, default 800
 
 private:
     Preferences prefs;
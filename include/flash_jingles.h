@@ -0,0 +1,49 @@
+#ifndef FLASH_JINGLES_H
+#define FLASH_JINGLES_H
+
+#include <Arduino.h>
+#include <vector>
+#include <esp_partition.h>
+#include "jingle_pack_format.h"
+#include "wav_format.h"
+
+#define FLASH_JINGLES_LABEL   "jingles"
+#define FLASH_JINGLES_SUBTYPE 0x40  // Custom data subtype, see partitions.csv
+
+// Jingle pack image in a raw flash partition, memory mapped once at boot.
+// Playback reads samples straight through the flash cache (no SD, no FAT,
+// no copy), so the stingers stored here keep working with a bad or busy
+// SD card.
+class FlashJingles {
+public:
+    FlashJingles();
+
+    bool begin();                       // Find, map and parse the partition
+    bool isAvailable() { return base != nullptr; }
+    size_t capacity();                  // Partition size in bytes
+
+    // slot = entry index ("0", "1", ...) or entry name
+    bool find(const String& slot, const uint8_t*& data, WavInfo& info);
+    std::vector<JPackEntry> entries() { return toc; }
+
+    // Replace the whole image (settings mode, nothing playing from flash).
+    // Sectors are erased just ahead of the write position, so no single
+    // call blocks for the whole partition erase.
+    bool beginWrite();
+    bool write(const uint8_t* data, size_t len);
+    bool endWrite();                    // Re-map and validate
+
+private:
+    const esp_partition_t* part;
+    const uint8_t* base;
+    esp_partition_mmap_handle_t mapHandle;
+    std::vector<JPackEntry> toc;
+    size_t writePos;
+    size_t erasedUpTo;
+    bool writeOk;
+
+    bool map();
+    void unmap();
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef IMA_ADPCM_H
+#define IMA_ADPCM_H
+
+#include <Arduino.h>
+
+// IMA/DVI ADPCM (WAV format tag 0x11), 4 bits per sample.
+// Decoding runs in the SD stream task, so the ring and the callback only
+// ever see 16-bit PCM. It is incremental: the ring is smaller than one
+// decoded block, so the caller asks nextReadSize() how many compressed
+// bytes fit, reads exactly that much and hands it to decode(). maxBytes is
+// the caller's read buffer: a block layout is never trusted to stay in it.
+class ImaAdpcmDecoder {
+public:
+    ImaAdpcmDecoder();
+
+    void begin(uint16_t channels, uint16_t blockAlign);
+    // Compressed bytes for <= maxFrames frames, never more than maxBytes
+    size_t nextReadSize(int maxFrames, size_t maxBytes) const;
+    int decode(const uint8_t* src, size_t len, int16_t* out);  // Interleaved, returns frames
+
+    static uint32_t samplesPerBlock(uint16_t channels, uint16_t blockAlign);
+    // Mono/stereo, and blocks of a header plus whole 8-sample units per channel
+    static bool validBlockAlign(uint16_t channels, uint16_t blockAlign);
+
+private:
+    struct ChannelState {
+        int32_t predictor;
+        int32_t index;
+    };
+    ChannelState ch[2];
+    uint16_t channels;
+    uint16_t blockAlign;
+    uint32_t blockLeft;  // Compressed bytes left in the current block
+};
+
+// Re-encode a 16-bit PCM WAV as IMA-ADPCM (4:1). Used after web uploads.
+bool imaAdpcmEncodeFile(const String& srcPath, const String& dstPath);
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef JINGLE_CATALOG_H
+#define JINGLE_CATALOG_H
+
+#include <Arduino.h>
+#include <vector>
+#include "wav_format.h"
+#include "loudness_meter.h"
+
+#define CATALOG_DIR   "/jingles"
+#define CATALOG_PATH  "/jingles/.catalog"
+#define CATALOG_NAME_LEN 48
+
+#define SILENCE_THRESHOLD  104   // |sample| at 16-bit (-50 dBFS): quieter counts as silence
+#define TRIM_MIN_MS        30    // Leading silence shorter than this is left alone
+#define TRIM_PREROLL_MS    10    // Kept ahead of the first sound
+#define TRIM_TAIL_KEEP_MS  150   // Kept after the last sound (the fade-out runs in there)
+
+// Binary index of /jingles/ kept on the card: parsed header, duration,
+// levels and loudness per file (and per entry of each *.jpk pack, named "pack.jpk#entry"),
+// so playback and the file list never re-scan the directory or re-parse
+// headers. Uploads/deletes update it record by
+// record; a background verify pass picks up cards edited on a PC.
+class JingleCatalog {
+public:
+    // One fixed-size record in CATALOG_PATH
+    struct Entry {
+        char name[CATALOG_NAME_LEN];  // File name inside /jingles/ (or "pack.jpk#entry")
+        uint32_t fileSize;            // Size + mtime detect edits behind our back
+        uint32_t mtime;
+        WavInfo info;
+        uint32_t durationMs;
+        uint16_t peak;                // Max |sample| at 16-bit (0..32767)
+        uint16_t rms;                 // Over both channels, same scale
+        int16_t loudness;             // Integrated LUFS x10 (LOUDNESS_UNMEASURED for packs/silence)
+        int16_t truePeak;             // dBTP x10
+        uint16_t leadMs;              // Silence before the first / after the
+        uint16_t tailMs;              // last sound (0 for packs / silent files)
+    };
+
+    JingleCatalog();
+
+    bool begin();                                      // Load index (after SD.begin)
+    bool lookup(const String& path, Entry& out);       // "/jingles/x.wav" or "x.wav"
+    bool update(const String& filename);               // Analyze one file, add/replace record
+    bool remove(const String& filename);
+    std::vector<Entry> entries();                      // Snapshot
+
+    // Trim proposed for a file's leading / trailing silence, in the units of
+    // the button "startMs" / "endMs" keys (0 = leave that end). Only ever
+    // offered by the settings page, never applied to the file.
+    static bool proposeTrim(const Entry& e, uint32_t& startMs, uint32_t& endMs);
+
+    void startVerify();                                // Background rebuild against the card
+    bool isVerifying() { return verifying; }
+
+private:
+    std::vector<Entry> list;
+    SemaphoreHandle_t mutex;    // list + index file (loop, web task, verify task)
+    volatile bool verifying;
+    uint32_t updateSeq;         // Bumped by update/remove, verify re-runs if it moved
+
+    static void verifyTask(void* param);
+    void verify();
+    bool analyze(const String& filename, Entry& e);
+    bool analyzePack(const String& pack, std::vector<Entry>& out);
+    bool updatePack(const String& pack);
+    void dropPackRecords(const String& pack);  // Caller holds mutex
+    bool saveAll();                            // Caller holds mutex
+    bool saveRecord(int index);                // Caller holds mutex
+    int find(const String& filename);          // Caller holds mutex
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef JINGLE_PACK_H
+#define JINGLE_PACK_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <vector>
+#include "jingle_pack_format.h"
+#include "wav_format.h"
+
+// Pack entries are addressed as "<pack path>#<entry name>",
+// e.g. "/jingles/show.jpk#intro"
+#define JPACK_SEPARATOR '#'
+
+// Read and sanity-check the table of contents of an open pack
+bool packReadToc(File& file, std::vector<JPackEntry>& toc);
+
+// Same for a pack image in memory (flash partition)
+bool packParseToc(const uint8_t* image, size_t imageSize, std::vector<JPackEntry>& toc);
+
+// Find one entry by name and describe its payload as a 16-bit PCM WAV
+bool packFindEntry(File& file, const String& name, WavInfo& info);
+
+// WavInfo for a table-of-contents entry
+void packEntryInfo(const JPackEntry& entry, WavInfo& info);
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef JINGLE_PACK_FORMAT_H
+#define JINGLE_PACK_FORMAT_H
+
+// On-card layout of a jingle pack (*.jpk). Shared by the firmware and the
+// host builder in tools/pack_builder, so no Arduino types in here.
+//
+//   offset 0        JPackHeader
+//   tocOffset       JPackEntry[entryCount]
+//   entry.offset    44.1 kHz stereo s16 PCM, every payload starts on a
+//                   JPACK_ALIGN boundary (zero padded in between)
+//
+// The builder writes the file in one sequential pass, so once it is copied
+// to a card the payloads are contiguous and a play is one seek + linear
+// reads with no FAT cluster-chain walks. All fields are little endian.
+
+#include <stdint.h>
+
+#define JPACK_MAGIC         0x4B41504A  // "JPAK"
+#define JPACK_VERSION       1
+#define JPACK_ALIGN         512         // SD sector
+#define JPACK_NAME_LEN      32          // Including the terminating NUL
+#define JPACK_MAX_ENTRIES   256
+#define JPACK_SAMPLE_RATE   44100
+#define JPACK_CHANNELS      2
+
+#pragma pack(push, 1)
+struct JPackHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entryCount;
+    uint32_t sampleRate;     // Always JPACK_SAMPLE_RATE
+    uint16_t channels;       // Always JPACK_CHANNELS
+    uint16_t bitsPerSample;  // Always 16
+    uint32_t tocOffset;
+    uint32_t totalSize;      // Whole pack, for truncation checks
+    uint8_t reserved[8];
+};
+
+struct JPackEntry {
+    char name[JPACK_NAME_LEN];  // Without extension, no '/' or '#'
+    uint32_t offset;            // Payload start, JPACK_ALIGN aligned
+    uint32_t size;              // Payload bytes
+    uint32_t frames;
+    uint16_t peak;              // Max |sample| (0..32767)
+    uint16_t rms;
+};
+#pragma pack(pop)
+
+#endif
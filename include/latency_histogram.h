@@ -0,0 +1,38 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <Arduino.h>
+
+// Trigger latency, touch -> sound, per stage. Every stage is timed from
+// the touch sample (esp_timer_get_time) and counted into fixed log-spaced
+// buckets: bucket b covers up to 100us * 2^(b/4), so 48 buckets reach ~350ms
+// at about 19% resolution. The counters live in RTC memory and survive the
+// software restart into Settings Mode, where /api/latency serves them.
+enum LatencyStage : uint8_t {
+    LATENCY_PLAY_ENTRY,      // playFile() called
+    LATENCY_SOURCE_READY,    // File opened + validated (or RAM/flash source found)
+    LATENCY_FIRST_FRAME,     // First block with clip data left the callback
+    LATENCY_FADE_IN_DONE,    // Fade-in ramp reached full level
+    LATENCY_STAGE_COUNT
+};
+
+#define LATENCY_BUCKETS 48
+
+struct LatencySummary {
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint32_t p50Us;   // Percentiles are bucket upper bounds (capped at max)
+    uint32_t p95Us;
+    uint32_t p99Us;
+};
+
+void latencyBegin();                                // Keep counts from before a soft restart
+void latencyRecord(uint8_t stage, uint32_t us);     // One writer per stage, no locks
+void latencyReset();
+LatencySummary latencySummary(uint8_t stage);
+uint32_t latencyBucketCount(uint8_t stage, int bucket);
+uint32_t latencyBucketUpperUs(int bucket);
+const char* latencyStageName(uint8_t stage);
+
+#endif
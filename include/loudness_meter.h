@@ -0,0 +1,59 @@
+#ifndef LOUDNESS_METER_H
+#define LOUDNESS_METER_H
+
+#include <stdint.h>
+
+#define LOUDNESS_UNMEASURED    INT16_MIN  // Silent / not analysed
+#define LOUDNESS_PEAK_CEILING  -10        // dBTP x10 a boost may not push past
+#define LOUDNESS_MAX_BOOST     60         // dB x10 (Q15 gain stays below MIX_MAX_GAIN)
+#define LOUDNESS_MAX_CUT       -240       // dB x10
+
+// Integrated loudness (ITU-R BS.1770 K-weighting, 400ms blocks with 75%
+// overlap, -70 LUFS absolute and -10 LU relative gates) and true-peak
+// (4x oversampled) of interleaved stereo int16, fed in blocks of any
+// size. Runs once per file when the catalog analyses it, never on the
+// audio path. Float math; the gating histogram is heap-allocated in
+// begin() and freed in end().
+class LoudnessMeter {
+public:
+    LoudnessMeter();
+    ~LoudnessMeter();
+
+    bool begin(uint32_t sampleRate);
+    void push(const int16_t* stereo, int frames);
+    void end(int16_t& lufsX10, int16_t& truePeakX10);  // LOUDNESS_UNMEASURED if silent
+
+private:
+    static const int TP_TAPS = 12;       // Per phase of the 4x interpolator
+    static const int HIST_BINS = 300;    // 0.25 LU steps from -70 LUFS
+
+    struct Biquad {
+        float b0, b1, b2, a1, a2;
+        float z1[2], z2[2];              // Per channel state
+        float run(float x, int ch);
+    };
+
+    Biquad shelf;                        // Stage 1: high-frequency shelf
+    Biquad highpass;                     // Stage 2: RLB high-pass
+    uint32_t stepFrames;                 // 100ms hop
+    uint32_t stepLeft;
+    float stepEnergy;                    // Sum of squares in the current hop
+    float hops[4];                       // Last four hops = one 400ms block
+    uint32_t hopCount;
+    float clipEnergy;                    // Whole clip, for clips under 400ms
+    uint32_t clipFrames;
+    uint32_t* histCount;
+    float* histEnergy;
+    float tpHist[2][TP_TAPS * 2];        // Mirrored ring, window read in one run
+    int tpPos;
+    float truePeak;                      // Linear, 1.0 = full scale
+
+    void addBlock(float meanSquare);
+};
+
+// Q15 gain that brings a clip of the given loudness to targetX10 (LUFS x10),
+// limited so a boost never drives the true peak past LOUDNESS_PEAK_CEILING.
+// Unity for unmeasured clips or target 0 (normalisation off).
+int32_t loudnessGainQ15(int16_t lufsX10, int16_t truePeakX10, int targetX10);
+
+#endif
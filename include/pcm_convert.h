@@ -0,0 +1,16 @@
+#ifndef PCM_CONVERT_H
+#define PCM_CONVERT_H
+
+#include <Arduino.h>
+
+// Block converters from WAV sample formats to interleaved stereo int16.
+// One is picked per file (pcmSelectConverter) so the per-frame loop has no
+// format or channel branches. Formats wider than 16 bits get TPDF dither
+// before truncation; dither is a caller-owned xorshift state so every
+// voice has its own, reproducible noise.
+typedef void (*PcmConvertFn)(const uint8_t* src, int16_t* dst, int frames, uint32_t& dither);
+
+// nullptr if the combination is not supported
+PcmConvertFn pcmSelectConverter(uint16_t format, uint16_t bitsPerSample, uint16_t channels);
+
+#endif
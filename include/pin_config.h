@@ -38,4 +38,57 @@
 #define BITS_PER_SAMPLE 16
 #define CHANNELS 2
 
+// Mixer voices (jingles that can sound at the same time)
+#ifndef AUDIO_MAX_VOICES
+#define AUDIO_MAX_VOICES 4
+#endif
+// Deferred audio log (see audio_log.h). 1=error 2=warn 3=info 4=debug;
+// records above this level are compiled out
+#ifndef AUDIO_LOG_LEVEL
+#define AUDIO_LOG_LEVEL 3
+#endif
+
+// Audio callback profiler (cycle counts, underrun events); 0 compiles it out
+#ifndef AUDIO_PROFILER
+#define AUDIO_PROFILER 1
+#endif
+
+// One spare slot so a cut voice can be replaced before the callback has
+// released it (voices are handed back through the command queue)
+#define AUDIO_VOICE_SLOTS (AUDIO_MAX_VOICES + 1)
+
+// Button sequences: files one button plays back to back, gapless
+#define AUDIO_SEQUENCE_MAX 8
+
+// SD streaming (prefetch task fills a ring buffer per voice ahead of the A2DP callback)
+#ifndef AUDIO_STREAM_BUFFER_BYTES
+#define AUDIO_STREAM_BUFFER_BYTES 8192   // Per voice, ~46ms of 44.1kHz stereo headroom
+#endif
+#define AUDIO_STREAM_CHUNK_BYTES 2048    // SD read size per refill
+#define AUDIO_STREAM_TASK_CORE 1         // BT stack runs on core 0
+#define AUDIO_STREAM_TASK_PRIORITY 3     // Above loop(), below BT
+#define AUDIO_STREAM_TASK_STACK 4096
+
+// Background bed: its own ring, refilled only once the jingle voices and
+// the finger-down prefetch have what they need
+#ifndef AUDIO_BED_BUFFER_BYTES
+#define AUDIO_BED_BUFFER_BYTES 32768     // ~186ms of 44.1kHz stereo
+#endif
+
+// Attack cache (first N ms of every button's jingle preloaded into RAM)
+#ifndef AUDIO_ATTACK_CACHE_MS
+#define AUDIO_ATTACK_CACHE_MS 60         // ~10KB per stereo jingle
+#endif
+#define AUDIO_ATTACK_SLOTS 8             // One per button
+
+// Whole-clip LRU cache. Budget 0 (config "clipCacheKB") = pick by board:
+// PSRAM if present, otherwise a small internal-RAM budget
+#ifndef AUDIO_CLIP_CACHE_PSRAM_BYTES
+#define AUDIO_CLIP_CACHE_PSRAM_BYTES (2 * 1024 * 1024)
+#endif
+#ifndef AUDIO_CLIP_CACHE_INTERNAL_BYTES
+#define AUDIO_CLIP_CACHE_INTERNAL_BYTES (48 * 1024)
+#endif
+#define AUDIO_CLIP_CACHE_SLOTS 16
+
 #endif
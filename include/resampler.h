@@ -0,0 +1,47 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <stdint.h>
+
+// Streaming polyphase sample-rate converter, interleaved stereo int16 in
+// and out, fixed-point throughout. Input frames are pushed, output frames
+// pulled; the filter history lives inside the object so blocks of any size
+// give identical output. Coefficient tables are const (flash), see
+// resampler_coeffs.h.
+class Resampler {
+public:
+    enum Quality {
+        QUALITY_LOW,     // 2-tap linear interpolation
+        QUALITY_MEDIUM,  // 8-tap windowed sinc
+        QUALITY_HIGH     // 16-tap windowed sinc
+    };
+
+    static const int MAX_TAPS = 16;
+    static const int BLOCK_FRAMES = 128;  // Input frames buffered per push
+
+    Resampler();
+
+    static bool supports(uint32_t inRate);  // 8k..48k into 44.1k
+    bool configure(uint32_t inRate, uint32_t outRate, Quality quality);
+    void reset();                          // Clear history, keep ratio
+
+    bool isBypass() const { return bypass; }
+    int space() const;                     // Input frames push() accepts
+    void push(const int16_t* in, int frames);
+    int pull(int16_t* out, int maxFrames); // Returns frames produced
+
+private:
+    const int16_t* coeffs;
+    int taps;
+    int phaseShift;     // frac >> phaseShift = phase index
+    uint32_t stepInt;   // Input frames per output frame, integer part
+    uint32_t stepFrac;  // ... and fraction (Q32)
+    bool bypass;
+
+    int16_t hist[(MAX_TAPS + BLOCK_FRAMES) * 2];
+    int histFrames;     // Valid frames in hist
+    int pos;            // Integer read position in hist
+    uint32_t frac;      // Fractional read position (Q32)
+};
+
+#endif
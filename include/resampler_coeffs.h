@@ -0,0 +1,284 @@
+// Generated by tools/gen_resampler_coeffs.py - do not edit
+#ifndef RESAMPLER_COEFFS_H
+#define RESAMPLER_COEFFS_H
+
+#include <stdint.h>
+
+// const tables land in flash (.rodata/DROM), not in DRAM
+
+#define RS_LOW_TAPS 2
+#define RS_LOW_PHASE_BITS 6
+static const int16_t RS_LOW_UP[64 * 2] = {
+    16384, 0,
+    16128, 256,
+    15872, 512,
+    15616, 768,
+    15360, 1024,
+    15104, 1280,
+    14848, 1536,
+    14592, 1792,
+    14336, 2048,
+    14080, 2304,
+    13824, 2560,
+    13568, 2816,
+    13312, 3072,
+    13056, 3328,
+    12800, 3584,
+    12544, 3840,
+    12288, 4096,
+    12032, 4352,
+    11776, 4608,
+    11520, 4864,
+    11264, 5120,
+    11008, 5376,
+    10752, 5632,
+    10496, 5888,
+    10240, 6144,
+    9984, 6400,
+    9728, 6656,
+    9472, 6912,
+    9216, 7168,
+    8960, 7424,
+    8704, 7680,
+    8448, 7936,
+    8192, 8192,
+    7936, 8448,
+    7680, 8704,
+    7424, 8960,
+    7168, 9216,
+    6912, 9472,
+    6656, 9728,
+    6400, 9984,
+    6144, 10240,
+    5888, 10496,
+    5632, 10752,
+    5376, 11008,
+    5120, 11264,
+    4864, 11520,
+    4608, 11776,
+    4352, 12032,
+    4096, 12288,
+    3840, 12544,
+    3584, 12800,
+    3328, 13056,
+    3072, 13312,
+    2816, 13568,
+    2560, 13824,
+    2304, 14080,
+    2048, 14336,
+    1792, 14592,
+    1536, 14848,
+    1280, 15104,
+    1024, 15360,
+    768, 15616,
+    512, 15872,
+    256, 16128,
+};
+
+#define RS_MEDIUM_TAPS 8
+#define RS_MEDIUM_PHASE_BITS 5
+static const int16_t RS_MEDIUM_UP[32 * 8] = {
+    230, -739, 1352, 14716, 1352, -739, 230, -18,
+    202, -621, 940, 14698, 1789, -859, 257, -22,
+    176, -506, 552, 14635, 2248, -981, 285, -25,
+    150, -396, 190, 14530, 2729, -1103, 313, -29,
+    125, -290, -146, 14385, 3228, -1225, 340, -33,
+    102, -190, -454, 14195, 3745, -1344, 366, -36,
+    80, -97, -735, 13967, 4277, -1459, 391, -40,
+    60, -9, -988, 13698, 4822, -1569, 413, -43,
+    41, 71, -1214, 13395, 5377, -1673, 433, -46,
+    24, 144, -1412, 13055, 5940, -1769, 451, -49,
+    9, 210, -1583, 12680, 6509, -1855, 465, -51,
+    -4, 268, -1727, 12275, 7079, -1930, 475, -52,
+    -16, 319, -1846, 11842, 7650, -1992, 480, -53,
+    -26, 363, -1939, 11381, 8216, -2039, 481, -53,
+    -34, 399, -2009, 10897, 8777, -2071, 477, -52,
+    -40, 428, -2055, 10390, 9328, -2085, 467, -49,
+    -45, 451, -2080, 9865, 9867, -2080, 451, -45,
+    -49, 467, -2085, 9328, 10390, -2055, 428, -40,
+    -52, 477, -2071, 8777, 10897, -2009, 399, -34,
+    -53, 481, -2039, 8216, 11381, -1939, 363, -26,
+    -53, 480, -1992, 7650, 11842, -1846, 319, -16,
+    -52, 475, -1930, 7079, 12275, -1727, 268, -4,
+    -51, 465, -1855, 6509, 12680, -1583, 210, 9,
+    -49, 451, -1769, 5940, 13055, -1412, 144, 24,
+    -46, 433, -1673, 5377, 13395, -1214, 71, 41,
+    -43, 413, -1569, 4822, 13698, -988, -9, 60,
+    -40, 391, -1459, 4277, 13967, -735, -97, 80,
+    -36, 366, -1344, 3745, 14195, -454, -190, 102,
+    -33, 340, -1225, 3228, 14385, -146, -290, 125,
+    -29, 313, -1103, 2729, 14530, 190, -396, 150,
+    -25, 285, -981, 2248, 14635, 552, -506, 176,
+    -22, 257, -859, 1789, 14698, 940, -621, 202,
+};
+static const int16_t RS_MEDIUM_DOWN[32 * 8] = {
+    284, -1114, 2266, 13528, 2266, -1114, 284, -16,
+    268, -1021, 1874, 13514, 2674, -1205, 297, -17,
+    252, -927, 1500, 13462, 3097, -1292, 310, -18,
+    235, -833, 1144, 13380, 3533, -1376, 320, -19,
+    217, -740, 808, 13264, 3982, -1455, 328, -20,
+    200, -647, 491, 13112, 4442, -1528, 333, -19,
+    182, -557, 195, 12931, 4910, -1593, 335, -19,
+    164, -469, -80, 12719, 5384, -1650, 334, -18,
+    146, -385, -334, 12476, 5864, -1697, 330, -16,
+    129, -304, -567, 12205, 6347, -1734, 321, -13,
+    113, -227, -777, 11904, 6830, -1759, 309, -9,
+    97, -154, -967, 11580, 7312, -1771, 292, -5,
+    82, -87, -1134, 11230, 7791, -1769, 270, 1,
+    68, -24, -1281, 10858, 8264, -1752, 244, 7,
+    55, 34, -1408, 10466, 8729, -1719, 212, 15,
+    43, 86, -1514, 10055, 9184, -1669, 176, 23,
+    33, 134, -1601, 9626, 9626, -1601, 134, 33,
+    23, 176, -1669, 9184, 10055, -1514, 86, 43,
+    15, 212, -1719, 8729, 10466, -1408, 34, 55,
+    7, 244, -1752, 8264, 10858, -1281, -24, 68,
+    1, 270, -1769, 7791, 11230, -1134, -87, 82,
+    -5, 292, -1771, 7312, 11580, -967, -154, 97,
+    -9, 309, -1759, 6830, 11904, -777, -227, 113,
+    -13, 321, -1734, 6347, 12205, -567, -304, 129,
+    -16, 330, -1697, 5864, 12476, -334, -385, 146,
+    -18, 334, -1650, 5384, 12719, -80, -469, 164,
+    -19, 335, -1593, 4910, 12931, 195, -557, 182,
+    -19, 333, -1528, 4442, 13112, 491, -647, 200,
+    -20, 328, -1455, 3982, 13264, 808, -740, 217,
+    -19, 320, -1376, 3533, 13380, 1144, -833, 235,
+    -18, 310, -1292, 3097, 13462, 1500, -927, 252,
+    -17, 297, -1205, 2674, 13514, 1874, -1021, 268,
+};
+
+#define RS_HIGH_TAPS 16
+#define RS_HIGH_PHASE_BITS 6
+static const int16_t RS_HIGH_UP[64 * 16] = {
+    14, -68, 205, -457, 816, -1209, 1520, 14743, 1520, -1209, 816, -457, 205, -68, 14, -1,
+    14, -68, 202, -445, 780, -1121, 1289, 14740, 1755, -1296, 851, -469, 208, -69, 14, -1,
+    14, -68, 198, -432, 744, -1033, 1064, 14726, 1996, -1383, 884, -480, 210, -69, 14, -1,
+    14, -67, 195, -418, 706, -945, 844, 14700, 2241, -1468, 917, -491, 212, -69, 14, -1,
+    14, -66, 190, -404, 669, -857, 629, 14665, 2490, -1553, 948, -500, 214, -68, 14, -1,
+    14, -65, 186, -389, 630, -769, 421, 14620, 2744, -1637, 979, -509, 215, -68, 13, -1,
+    14, -64, 181, -374, 591, -682, 218, 14566, 3002, -1719, 1007, -517, 216, -67, 13, -1,
+    14, -63, 176, -358, 552, -595, 21, 14500, 3263, -1799, 1035, -524, 216, -66, 13, -1,
+    14, -62, 171, -342, 513, -509, -169, 14426, 3528, -1878, 1060, -530, 216, -65, 12, -1,
+    13, -60, 166, -326, 473, -424, -353, 14343, 3796, -1955, 1084, -535, 215, -64, 12, -1,
+    13, -59, 160, -309, 433, -340, -531, 14250, 4066, -2029, 1107, -539, 214, -63, 11, 0,
+    13, -57, 154, -292, 393, -257, -702, 14146, 4340, -2101, 1127, -541, 212, -61, 10, 0,
+    13, -56, 148, -275, 354, -176, -866, 14032, 4616, -2170, 1146, -543, 210, -59, 10, 0,
+    12, -54, 142, -258, 314, -96, -1024, 13914, 4894, -2237, 1162, -544, 207, -57, 9, 0,
+    12, -52, 136, -241, 275, -17, -1175, 13783, 5173, -2301, 1177, -543, 204, -55, 8, 0,
+    12, -51, 129, -223, 236, 60, -1319, 13646, 5454, -2361, 1189, -542, 200, -53, 7, 0,
+    11, -49, 123, -206, 197, 135, -1456, 13497, 5737, -2418, 1200, -539, 196, -50, 6, 0,
+    11, -47, 116, -188, 159, 208, -1587, 13342, 6020, -2471, 1207, -535, 191, -47, 5, 0,
+    10, -45, 110, -171, 121, 278, -1710, 13179, 6303, -2521, 1213, -529, 185, -44, 4, 1,
+    10, -43, 103, -154, 84, 347, -1826, 13007, 6587, -2566, 1216, -523, 179, -41, 3, 1,
+    10, -41, 96, -136, 47, 414, -1936, 12825, 6871, -2607, 1217, -515, 173, -37, 2, 1,
+    9, -39, 90, -119, 12, 478, -2038, 12639, 7154, -2644, 1215, -506, 166, -34, 0, 1,
+    9, -37, 83, -102, -23, 540, -2134, 12444, 7437, -2677, 1210, -495, 158, -30, -1, 2,
+    8, -35, 76, -86, -57, 600, -2222, 12243, 7719, -2704, 1203, -484, 149, -26, -2, 2,
+    8, -33, 70, -69, -91, 656, -2303, 12035, 7999, -2727, 1193, -471, 140, -21, -4, 2,
+    8, -31, 63, -53, -123, 711, -2378, 11819, 8277, -2745, 1181, -456, 131, -17, -5, 2,
+    7, -29, 57, -37, -154, 762, -2446, 11596, 8554, -2757, 1166, -440, 121, -12, -7, 3,
+    7, -27, 50, -22, -184, 811, -2507, 11370, 8828, -2764, 1147, -423, 110, -7, -8, 3,
+    6, -25, 44, -7, -214, 858, -2561, 11137, 9100, -2766, 1127, -405, 99, -2, -10, 3,
+    6, -23, 38, 8, -242, 901, -2609, 10898, 9368, -2761, 1103, -386, 88, 3, -12, 4,
+    5, -21, 31, 23, -269, 942, -2650, 10656, 9633, -2751, 1076, -365, 76, 8, -14, 4,
+    5, -19, 25, 37, -295, 980, -2685, 10406, 9895, -2735, 1047, -343, 63, 14, -15, 4,
+    5, -17, 20, 50, -319, 1015, -2713, 10150, 10152, -2713, 1015, -319, 50, 20, -17, 5,
+    4, -15, 14, 63, -343, 1047, -2735, 9895, 10406, -2685, 980, -295, 37, 25, -19, 5,
+    4, -14, 8, 76, -365, 1076, -2751, 9633, 10656, -2650, 942, -269, 23, 31, -21, 5,
+    4, -12, 3, 88, -386, 1103, -2761, 9368, 10898, -2609, 901, -242, 8, 38, -23, 6,
+    3, -10, -2, 99, -405, 1127, -2766, 9100, 11137, -2561, 858, -214, -7, 44, -25, 6,
+    3, -8, -7, 110, -423, 1147, -2764, 8828, 11370, -2507, 811, -184, -22, 50, -27, 7,
+    3, -7, -12, 121, -440, 1166, -2757, 8554, 11596, -2446, 762, -154, -37, 57, -29, 7,
+    2, -5, -17, 131, -456, 1181, -2745, 8277, 11819, -2378, 711, -123, -53, 63, -31, 8,
+    2, -4, -21, 140, -471, 1193, -2727, 7999, 12035, -2303, 656, -91, -69, 70, -33, 8,
+    2, -2, -26, 149, -484, 1203, -2704, 7719, 12243, -2222, 600, -57, -86, 76, -35, 8,
+    2, -1, -30, 158, -495, 1210, -2677, 7437, 12444, -2134, 540, -23, -102, 83, -37, 9,
+    1, 0, -34, 166, -506, 1215, -2644, 7154, 12639, -2038, 478, 12, -119, 90, -39, 9,
+    1, 2, -37, 173, -515, 1217, -2607, 6871, 12825, -1936, 414, 47, -136, 96, -41, 10,
+    1, 3, -41, 179, -523, 1216, -2566, 6587, 13007, -1826, 347, 84, -154, 103, -43, 10,
+    1, 4, -44, 185, -529, 1213, -2521, 6303, 13179, -1710, 278, 121, -171, 110, -45, 10,
+    0, 5, -47, 191, -535, 1207, -2471, 6020, 13342, -1587, 208, 159, -188, 116, -47, 11,
+    0, 6, -50, 196, -539, 1200, -2418, 5737, 13497, -1456, 135, 197, -206, 123, -49, 11,
+    0, 7, -53, 200, -542, 1189, -2361, 5454, 13646, -1319, 60, 236, -223, 129, -51, 12,
+    0, 8, -55, 204, -543, 1177, -2301, 5173, 13783, -1175, -17, 275, -241, 136, -52, 12,
+    0, 9, -57, 207, -544, 1162, -2237, 4894, 13914, -1024, -96, 314, -258, 142, -54, 12,
+    0, 10, -59, 210, -543, 1146, -2170, 4616, 14032, -866, -176, 354, -275, 148, -56, 13,
+    0, 10, -61, 212, -541, 1127, -2101, 4340, 14146, -702, -257, 393, -292, 154, -57, 13,
+    0, 11, -63, 214, -539, 1107, -2029, 4066, 14250, -531, -340, 433, -309, 160, -59, 13,
+    -1, 12, -64, 215, -535, 1084, -1955, 3796, 14343, -353, -424, 473, -326, 166, -60, 13,
+    -1, 12, -65, 216, -530, 1060, -1878, 3528, 14426, -169, -509, 513, -342, 171, -62, 14,
+    -1, 13, -66, 216, -524, 1035, -1799, 3263, 14500, 21, -595, 552, -358, 176, -63, 14,
+    -1, 13, -67, 216, -517, 1007, -1719, 3002, 14566, 218, -682, 591, -374, 181, -64, 14,
+    -1, 13, -68, 215, -509, 979, -1637, 2744, 14620, 421, -769, 630, -389, 186, -65, 14,
+    -1, 14, -68, 214, -500, 948, -1553, 2490, 14665, 629, -857, 669, -404, 190, -66, 14,
+    -1, 14, -69, 212, -491, 917, -1468, 2241, 14700, 844, -945, 706, -418, 195, -67, 14,
+    -1, 14, -69, 210, -480, 884, -1383, 1996, 14726, 1064, -1033, 744, -432, 198, -68, 14,
+    -1, 14, -69, 208, -469, 851, -1296, 1755, 14740, 1289, -1121, 780, -445, 202, -68, 14,
+};
+static const int16_t RS_HIGH_DOWN[64 * 16] = {
+    -11, 9, 84, -396, 1007, -1822, 2545, 13551, 2545, -1822, 1007, -396, 84, 9, -11, 1,
+    -10, 6, 90, -402, 997, -1761, 2332, 13545, 2762, -1881, 1015, -389, 78, 12, -12, 2,
+    -9, 3, 96, -407, 986, -1699, 2121, 13535, 2982, -1938, 1021, -382, 71, 15, -13, 2,
+    -8, 0, 102, -411, 974, -1635, 1914, 13516, 3204, -1993, 1025, -373, 63, 18, -14, 2,
+    -8, -3, 107, -414, 960, -1569, 1711, 13486, 3429, -2045, 1028, -364, 56, 22, -14, 2,
+    -7, -5, 112, -416, 945, -1503, 1511, 13449, 3657, -2095, 1029, -353, 48, 25, -15, 2,
+    -6, -8, 116, -418, 928, -1435, 1315, 13408, 3886, -2143, 1028, -342, 40, 29, -16, 2,
+    -5, -10, 120, -419, 910, -1366, 1123, 13357, 4118, -2188, 1026, -330, 31, 32, -17, 2,
+    -5, -12, 124, -419, 891, -1297, 936, 13300, 4351, -2231, 1021, -317, 22, 36, -18, 2,
+    -4, -15, 127, -418, 871, -1227, 753, 13233, 4586, -2270, 1014, -303, 13, 40, -19, 3,
+    -3, -17, 130, -417, 849, -1156, 574, 13161, 4822, -2306, 1006, -289, 4, 43, -20, 3,
+    -3, -19, 133, -414, 827, -1085, 399, 13081, 5059, -2339, 995, -273, -6, 47, -21, 3,
+    -2, -20, 135, -412, 803, -1014, 230, 12993, 5297, -2369, 983, -256, -16, 51, -22, 3,
+    -2, -22, 138, -408, 779, -942, 65, 12898, 5536, -2396, 968, -239, -26, 55, -23, 3,
+    -1, -24, 139, -404, 754, -871, -96, 12796, 5776, -2418, 952, -221, -36, 59, -24, 3,
+    -1, -25, 141, -399, 728, -799, -251, 12687, 6015, -2437, 933, -202, -47, 63, -25, 3,
+    0, -27, 142, -394, 702, -728, -401, 12571, 6255, -2452, 912, -182, -58, 67, -26, 3,
+    0, -28, 143, -388, 674, -657, -546, 12447, 6494, -2464, 890, -161, -69, 71, -26, 4,
+    1, -29, 143, -381, 647, -586, -686, 12315, 6733, -2471, 865, -139, -80, 75, -27, 4,
+    1, -30, 143, -374, 618, -516, -821, 12182, 6972, -2474, 837, -117, -92, 79, -28, 4,
+    1, -31, 143, -366, 589, -447, -950, 12040, 7209, -2472, 808, -94, -103, 82, -29, 4,
+    2, -32, 143, -358, 560, -378, -1075, 11891, 7445, -2466, 777, -70, -115, 86, -30, 4,
+    2, -33, 142, -350, 531, -310, -1194, 11737, 7680, -2456, 744, -46, -127, 90, -30, 4,
+    2, -33, 141, -341, 501, -244, -1307, 11578, 7913, -2441, 708, -21, -139, 94, -31, 4,
+    3, -34, 140, -332, 471, -178, -1415, 11411, 8145, -2422, 671, 5, -151, 98, -32, 4,
+    3, -34, 139, -322, 441, -113, -1518, 11238, 8374, -2397, 631, 32, -163, 101, -32, 4,
+    3, -35, 137, -312, 410, -50, -1616, 11065, 8601, -2368, 590, 58, -175, 105, -33, 4,
+    3, -35, 136, -301, 380, 12, -1708, 10882, 8825, -2334, 546, 86, -187, 108, -33, 4,
+    3, -35, 134, -291, 350, 73, -1794, 10694, 9047, -2295, 501, 114, -199, 112, -34, 4,
+    4, -35, 132, -280, 320, 132, -1875, 10500, 9266, -2250, 454, 142, -211, 115, -34, 4,
+    4, -35, 129, -269, 289, 190, -1951, 10308, 9481, -2201, 404, 171, -223, 118, -35, 4,
+    4, -35, 127, -258, 259, 246, -2022, 10108, 9693, -2147, 353, 200, -234, 121, -35, 4,
+    4, -35, 124, -246, 230, 301, -2087, 9901, 9901, -2087, 301, 230, -246, 124, -35, 4,
+    4, -35, 121, -234, 200, 353, -2147, 9693, 10108, -2022, 246, 259, -258, 127, -35, 4,
+    4, -35, 118, -223, 171, 404, -2201, 9481, 10308, -1951, 190, 289, -269, 129, -35, 4,
+    4, -34, 115, -211, 142, 454, -2250, 9266, 10500, -1875, 132, 320, -280, 132, -35, 4,
+    4, -34, 112, -199, 114, 501, -2295, 9047, 10694, -1794, 73, 350, -291, 134, -35, 3,
+    4, -33, 108, -187, 86, 546, -2334, 8825, 10882, -1708, 12, 380, -301, 136, -35, 3,
+    4, -33, 105, -175, 58, 590, -2368, 8601, 11065, -1616, -50, 410, -312, 137, -35, 3,
+    4, -32, 101, -163, 32, 631, -2397, 8374, 11238, -1518, -113, 441, -322, 139, -34, 3,
+    4, -32, 98, -151, 5, 671, -2422, 8145, 11411, -1415, -178, 471, -332, 140, -34, 3,
+    4, -31, 94, -139, -21, 708, -2441, 7913, 11578, -1307, -244, 501, -341, 141, -33, 2,
+    4, -30, 90, -127, -46, 744, -2456, 7680, 11737, -1194, -310, 531, -350, 142, -33, 2,
+    4, -30, 86, -115, -70, 777, -2466, 7445, 11891, -1075, -378, 560, -358, 143, -32, 2,
+    4, -29, 82, -103, -94, 808, -2472, 7209, 12040, -950, -447, 589, -366, 143, -31, 1,
+    4, -28, 79, -92, -117, 837, -2474, 6972, 12182, -821, -516, 618, -374, 143, -30, 1,
+    4, -27, 75, -80, -139, 865, -2471, 6733, 12315, -686, -586, 647, -381, 143, -29, 1,
+    4, -26, 71, -69, -161, 890, -2464, 6494, 12447, -546, -657, 674, -388, 143, -28, 0,
+    3, -26, 67, -58, -182, 912, -2452, 6255, 12571, -401, -728, 702, -394, 142, -27, 0,
+    3, -25, 63, -47, -202, 933, -2437, 6015, 12687, -251, -799, 728, -399, 141, -25, -1,
+    3, -24, 59, -36, -221, 952, -2418, 5776, 12796, -96, -871, 754, -404, 139, -24, -1,
+    3, -23, 55, -26, -239, 968, -2396, 5536, 12898, 65, -942, 779, -408, 138, -22, -2,
+    3, -22, 51, -16, -256, 983, -2369, 5297, 12993, 230, -1014, 803, -412, 135, -20, -2,
+    3, -21, 47, -6, -273, 995, -2339, 5059, 13081, 399, -1085, 827, -414, 133, -19, -3,
+    3, -20, 43, 4, -289, 1006, -2306, 4822, 13161, 574, -1156, 849, -417, 130, -17, -3,
+    3, -19, 40, 13, -303, 1014, -2270, 4586, 13233, 753, -1227, 871, -418, 127, -15, -4,
+    2, -18, 36, 22, -317, 1021, -2231, 4351, 13300, 936, -1297, 891, -419, 124, -12, -5,
+    2, -17, 32, 31, -330, 1026, -2188, 4118, 13357, 1123, -1366, 910, -419, 120, -10, -5,
+    2, -16, 29, 40, -342, 1028, -2143, 3886, 13408, 1315, -1435, 928, -418, 116, -8, -6,
+    2, -15, 25, 48, -353, 1029, -2095, 3657, 13449, 1511, -1503, 945, -416, 112, -5, -7,
+    2, -14, 22, 56, -364, 1028, -2045, 3429, 13486, 1711, -1569, 960, -414, 107, -3, -8,
+    2, -14, 18, 63, -373, 1025, -1993, 3204, 13516, 1914, -1635, 974, -411, 102, 0, -8,
+    2, -13, 15, 71, -382, 1021, -1938, 2982, 13535, 2121, -1699, 986, -407, 96, 3, -9,
+    2, -12, 12, 78, -389, 1015, -1881, 2762, 13545, 2332, -1761, 997, -402, 90, 6, -10,
+};
+
+#endif
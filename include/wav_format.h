@@ -0,0 +1,35 @@
+#ifndef WAV_FORMAT_H
+#define WAV_FORMAT_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+#define WAV_FORMAT_PCM        0x0001
+#define WAV_FORMAT_FLOAT      0x0003
+#define WAV_FORMAT_IMA_ADPCM  0x0011
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+// Chunks looked at before giving up on finding "data"
+#define WAV_MAX_CHUNKS        64
+
+// Parsed RIFF/WAVE header
+struct WavInfo {
+    uint16_t format;         // WAV_FORMAT_* (extensible resolved)
+    uint16_t channels;
+    uint16_t bitsPerSample;
+    uint16_t blockAlign;     // Bytes per frame (per block for ADPCM)
+    uint32_t sampleRate;     // Resampled to 44.1kHz if different
+    uint32_t dataOffset;     // File offset of the first sample byte
+    uint32_t dataSize;       // Length of the data chunk in bytes
+    uint32_t frames;         // Sample frames in the data chunk
+    uint32_t loopStart;      // First "smpl" loop in frames, end exclusive;
+    uint32_t loopEnd;        // loopEnd 0 = the file has no (valid) loop
+};
+
+// Walk the RIFF chunk list (skipping LIST/fact/etc.) for fmt and data, and
+// past data for a smpl chunk (loop points usually come last). Leaves the
+// file positioned at dataOffset on success. Never trusts the header:
+// sizes are clamped to the file and the walk is bounded.
+bool wavReadInfo(File& file, WavInfo& info);
+
+#endif
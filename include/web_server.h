@@ -8,6 +8,12 @@
 #include <ElegantOTA.h>
 #include "config_manager.h"
 #include "audio_player.h"
+#include "ima_adpcm.h"
+#include "jingle_catalog.h"
+#include "latency_histogram.h"
+#include "audio_profiler.h"
+#include "jingle_pack.h"
+#include "flash_jingles.h"
 
 // Simple Server for Normal Mode
 class SimpleServer {
@@ -28,15 +34,19 @@ private:
 class SettingsServer {
 public:
     SettingsServer();
-    void begin(ConfigManager* mgr, AudioPlayer* player);  // Modified to accept AudioPlayer
+    void begin(ConfigManager* mgr, AudioPlayer* player, JingleCatalog* cat);
     void resetTimeout();  // Reset the inactivity timer
     unsigned long getLastActivity();  // Get last activity timestamp
+    void handle();  // Deferred upload work (ADPCM, catalog), call from loop()
 
 private:
     AsyncWebServer server;
     ConfigManager* configMgr;
     AudioPlayer* audioPlayer;  // NEW: AudioPlayer reference for BT scanning
+    JingleCatalog* catalog;
     unsigned long lastActivityTime;
+    QueueHandle_t uploadQueue;  // Finished uploads (upload task -> loop)
+    bool flashUploadOk;
 
     void setupRoutes();
     void handleFileUpload(AsyncWebServerRequest *request, String filename,
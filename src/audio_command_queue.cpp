@@ -0,0 +1,20 @@
+#include "audio_command_queue.h"
+
+AudioCommandQueue::AudioCommandQueue() : head(0), tail(0) {
+}
+
+bool AudioCommandQueue::push(const AudioCommand& cmd) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= CAPACITY) return false;
+    slots[h & (CAPACITY - 1)] = cmd;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+bool AudioCommandQueue::pop(AudioCommand& cmd) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+    cmd = slots[t & (CAPACITY - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
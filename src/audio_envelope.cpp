@@ -0,0 +1,84 @@
+#include "audio_envelope.h"
+
+// sin(i/64 * pi/2) in Q15, i = 0..64
+static const int16_t quarterSine[65] = {
+    0, 804, 1608, 2411, 3212, 4011, 4808, 5602, 6393, 7180, 7962, 8740, 9512,
+    10279, 11039, 11793, 12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+    18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595, 23170, 23732, 24279,
+    24812, 25330, 25833, 26320, 26791, 27246, 27684, 28106, 28511, 28899, 29269,
+    29622, 29957, 30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972, 32138,
+    32286, 32413, 32522, 32610, 32679, 32729, 32758, 32767
+};
+
+AudioEnvelope::AudioEnvelope()
+    : acc((int64_t)UNITY << 16), step(0), target(UNITY), remaining(0), shape(SHAPE_LINEAR) {
+}
+
+int32_t AudioEnvelope::shaped(int32_t position) const {
+    if (shape == SHAPE_LINEAR || position >= UNITY) return position;
+    if (position <= 0) return 0;
+    int i = position >> 9;
+    int32_t frac = position & 511;
+    return quarterSine[i] + (((quarterSine[i + 1] - quarterSine[i]) * frac) >> 9);
+}
+
+int32_t AudioEnvelope::equalPowerPosition(int32_t gainQ15) {
+    if (gainQ15 <= 0) return 0;
+    if (gainQ15 >= quarterSine[64]) return UNITY;
+    int i = 0;
+    while (quarterSine[i + 1] <= gainQ15) i++;
+    int32_t span = quarterSine[i + 1] - quarterSine[i];
+    return (i << 9) + ((gainQ15 - quarterSine[i]) << 9) / span;
+}
+
+void AudioEnvelope::setShape(Shape s) {
+    if (s == shape) return;
+    int32_t g = shaped(gain());
+    shape = s;
+    int32_t position = (s == SHAPE_LINEAR) ? g : equalPowerPosition(g);
+    if (position == gain()) return;  // 0 and unity map to themselves
+    acc = (int64_t)position << 16;
+    if (remaining > 0) step = (((int64_t)target << 16) - acc) / (int64_t)remaining;
+}
+
+void AudioEnvelope::set(int32_t gainQ15) {
+    acc = (int64_t)gainQ15 << 16;
+    step = 0;
+    target = gainQ15;
+    remaining = 0;
+}
+
+void AudioEnvelope::start(int32_t fromQ15, int32_t toQ15, uint32_t frames) {
+    set(fromQ15);
+    rampTo(toQ15, frames);
+}
+
+void AudioEnvelope::rampTo(int32_t toQ15, uint32_t frames) {
+    if (frames == 0) {
+        set(toQ15);
+        return;
+    }
+    target = toQ15;
+    step = (((int64_t)toQ15 << 16) - acc) / (int64_t)frames;
+    remaining = frames;
+}
+
+void AudioEnvelope::apply(int16_t* stereo, int frames) {
+    int f = 0;
+
+    // Ramp section: one gain step per frame
+    for (; f < frames && remaining > 0; f++) {
+        int32_t g = shaped((int32_t)(acc >> 16));
+        stereo[2 * f]     = (int16_t)((stereo[2 * f] * g) >> 15);
+        stereo[2 * f + 1] = (int16_t)((stereo[2 * f + 1] * g) >> 15);
+        acc += step;
+        if (--remaining == 0) acc = (int64_t)target << 16;  // Land exactly
+    }
+
+    // Steady section: constant gain, skipped entirely at unity
+    int32_t g = shaped((int32_t)(acc >> 16));
+    if (g == UNITY) return;
+    for (int i = 2 * f; i < 2 * frames; i++) {
+        stereo[i] = (int16_t)((stereo[i] * g) >> 15);
+    }
+}
@@ -0,0 +1,124 @@
+#include "audio_log.h"
+#include <atomic>
+
+struct LogRecord {
+    uint32_t timeUs;
+    uint16_t id;
+    uint8_t level;
+    int32_t args[AUDIO_LOG_ARGS];
+    char text[AUDIO_LOG_TEXT_LEN];
+};
+
+// Bounded multi-producer / single-consumer ring (Vyukov). Each cell has a
+// sequence number telling producers and the drain task whose turn it is,
+// so producers only race on one compare-and-swap of the head. Sequences
+// are stored minus the cell index so the zero-initialised ring is valid
+// before anything runs.
+static const uint32_t LOG_RING_RECORDS = 64;  // Power of two
+struct LogCell {
+    std::atomic<uint32_t> seq;
+    LogRecord rec;
+};
+static LogCell logRing[LOG_RING_RECORDS];
+static std::atomic<uint32_t> logHead(0);
+static uint32_t logTail = 0;                  // Drain task only
+static std::atomic<uint32_t> logDropped(0);
+static TaskHandle_t logTaskHandle = nullptr;
+
+static const char* const logFormats[LOG_MESSAGE_COUNT] = {
+#define AUDIO_LOG_FORMAT(id, fmt) fmt,
+    AUDIO_LOG_MESSAGES(AUDIO_LOG_FORMAT)
+#undef AUDIO_LOG_FORMAT
+};
+
+static const uint32_t LOG_TASK_STACK = 3072;
+static const UBaseType_t LOG_TASK_PRIORITY = 1;  // Just above idle
+static const int LOG_TASK_CORE = 0;
+static const uint32_t LOG_DRAIN_MS = 20;
+
+void audioLogPush(uint8_t level, uint16_t id, const char* text,
+                  int32_t a0, int32_t a1, int32_t a2, int32_t a3, int32_t a4, int32_t a5) {
+    uint32_t pos = logHead.load(std::memory_order_relaxed);
+    LogCell* cell;
+    for (;;) {
+        cell = &logRing[pos & (LOG_RING_RECORDS - 1)];
+        uint32_t base = pos - (pos & (LOG_RING_RECORDS - 1));
+        int32_t dif = (int32_t)(cell->seq.load(std::memory_order_acquire) - base);
+        if (dif == 0) {
+            if (logHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (dif < 0) {
+            logDropped.fetch_add(1, std::memory_order_relaxed);  // Full
+            return;
+        } else {
+            pos = logHead.load(std::memory_order_relaxed);
+        }
+    }
+
+    LogRecord& r = cell->rec;
+    r.timeUs = micros();
+    r.id = id;
+    r.level = level;
+    r.args[0] = a0;
+    r.args[1] = a1;
+    r.args[2] = a2;
+    r.args[3] = a3;
+    r.args[4] = a4;
+    r.args[5] = a5;
+    r.text[0] = '\0';
+    if (text) {
+        size_t len = strlen(text);
+        if (len >= AUDIO_LOG_TEXT_LEN) text += len - (AUDIO_LOG_TEXT_LEN - 1);
+        strncpy(r.text, text, AUDIO_LOG_TEXT_LEN - 1);
+        r.text[AUDIO_LOG_TEXT_LEN - 1] = '\0';
+    }
+    cell->seq.store(pos - (pos & (LOG_RING_RECORDS - 1)) + 1, std::memory_order_release);
+}
+
+static void printRecord(const LogRecord& r) {
+    static const char levelTag[] = "?EWID";
+    const char* fmt = r.id < LOG_MESSAGE_COUNT ? logFormats[r.id] : "[LOG] Unknown id %d";
+    const int32_t* a = r.args;
+
+    char line[160];
+    if (strstr(fmt, "%s")) {
+        snprintf(line, sizeof(line), fmt, r.text, a[0], a[1], a[2], a[3], a[4], a[5]);
+    } else if (r.id < LOG_MESSAGE_COUNT) {
+        snprintf(line, sizeof(line), fmt, a[0], a[1], a[2], a[3], a[4], a[5]);
+    } else {
+        snprintf(line, sizeof(line), fmt, r.id);
+    }
+    Serial.printf("%lu.%03lu %c %s\n", (unsigned long)(r.timeUs / 1000000),
+                  (unsigned long)(r.timeUs / 1000 % 1000), levelTag[r.level <= 4 ? r.level : 0], line);
+}
+
+static void logTask(void* param) {
+    for (;;) {
+        for (;;) {
+            uint32_t base = logTail - (logTail & (LOG_RING_RECORDS - 1));
+            LogCell& cell = logRing[logTail & (LOG_RING_RECORDS - 1)];
+            if (cell.seq.load(std::memory_order_acquire) != base + 1) break;
+            LogRecord r = cell.rec;
+            cell.seq.store(base + LOG_RING_RECORDS, std::memory_order_release);
+            logTail++;
+            printRecord(r);
+        }
+
+        uint32_t dropped = logDropped.exchange(0, std::memory_order_relaxed);
+        if (dropped) Serial.printf("[LOG] %u records dropped (ring full)\n", (unsigned)dropped);
+
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_MS));
+    }
+}
+
+bool audioLogBegin() {
+    if (logTaskHandle) return true;
+
+    BaseType_t ok = xTaskCreatePinnedToCore(logTask, "audio_log", LOG_TASK_STACK, nullptr,
+                                            LOG_TASK_PRIORITY, &logTaskHandle, LOG_TASK_CORE);
+    if (ok != pdPASS) {
+        logTaskHandle = nullptr;
+        Serial.println("[LOG] Could not start log task");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,27 @@
+#include "audio_mixer.h"
+
+void mixClear(int32_t* acc, int samples) {
+    memset(acc, 0, samples * sizeof(int32_t));
+}
+
+void mixAccumulate(int32_t* __restrict acc, const int16_t* __restrict src,
+                   int32_t gainQ15, int samples) {
+    if (gainQ15 == MIX_UNITY_GAIN) {
+        for (int i = 0; i < samples; i++) {
+            acc[i] += src[i];
+        }
+        return;
+    }
+    for (int i = 0; i < samples; i++) {
+        acc[i] += (src[i] * gainQ15) >> 15;
+    }
+}
+
+void mixToInt16(const int32_t* __restrict acc, int16_t* __restrict out, int samples) {
+    for (int i = 0; i < samples; i++) {
+        int32_t v = acc[i];
+        v = v > 32767 ? 32767 : v;
+        v = v < -32768 ? -32768 : v;
+        out[i] = (int16_t)v;
+    }
+}
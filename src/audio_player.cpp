@@ -1,4 +1,9 @@
 #include "audio_player.h"
+#include "audio_mixer.h"
+#include "jingle_pack.h"
+#include "audio_log.h"
+#include "audio_profiler.h"
+#include <esp_timer.h>
 #include "pin_config.h"
 #include <Preferences.h>
 #include <nvs_flash.h>
@@ -11,21 +16,159 @@
 #include <TFT_eSPI.h>
 
 // Static members
-File AudioPlayer::currentFile;
-bool AudioPlayer::playing = false;
-bool AudioPlayer::isMono = false;
-uint32_t AudioPlayer::fileSize = 0;
-uint32_t AudioPlayer::bytesRead = 0;
 bool AudioPlayer::needsWiFiReconnect = false;
-static unsigned long silencePaddingStart = 0;  // Track when to start silence padding
-static const unsigned long SILENCE_PADDING_MS = 200;  // 200ms silence after WAV to prevent click
-static bool inSilencePadding = false;  // Flag to track if we're in silence padding mode
-static const unsigned long FADEIN_MS = 100;  // Fade in first 100ms of WAV to prevent click
-static unsigned long fadeInStart = 0;  // When fade-in started
-static bool inFadeIn = false;  // Flag for fade-in mode
-static const unsigned long FADEOUT_MS = 100;  // Fade out last 100ms of WAV to prevent click
-static unsigned long fadeOutStart = 0;  // When fade-out started
-static bool inFadeOut = false;  // Flag for fade-out mode
+AudioPlayer::Voice AudioPlayer::voices[AUDIO_VOICE_SLOTS];
+AudioPlayer::Voice AudioPlayer::bed;
+AudioPlayer::Sequence AudioPlayer::sequences[AUDIO_MAX_VOICES];
+uint32_t AudioPlayer::voiceSeq = 0;
+TaskHandle_t AudioPlayer::streamTaskHandle = nullptr;
+SemaphoreHandle_t AudioPlayer::streamMutex = nullptr;
+
+// Attack cache (filled at boot, read-only while playing)
+struct AttackSlot {
+    String path;                 // Audio source, as played
+    String file;                 // SD file the stream opens behind the attack
+    uint8_t* pcm;
+    uint32_t len;                // Decoded PCM bytes
+    uint32_t fileBytes;          // Data chunk offset the stream resumes at
+    uint32_t startMs;            // Trim the attack starts at
+    uint32_t skipFrames;         // ADPCM: frames still to drop ahead of it
+    WavInfo info;
+    PcmConvertFn convert;
+    ImaAdpcmDecoder adpcm;       // Decoder state where the stream resumes
+};
+static AttackSlot attackSlots[AUDIO_ATTACK_SLOTS];
+
+// Loop -> callback control. The callback reports back through one atomic
+// word: bits 0-7 = voices it is mixing, bits 8-31 = last command applied.
+static AudioCommandQueue commandQueue;
+static std::atomic<uint32_t> audioSnapshot(0);
+static uint32_t commandSeq = 0;                     // Loop side
+static uint32_t voiceCommandSeq[AUDIO_VOICE_SLOTS]; // Loop side: last command per voice
+static bool voiceClaimed[AUDIO_VOICE_SLOTS];        // Loop side: started and not cut since
+static uint32_t appliedSeq = 0;                     // Callback side
+static_assert(AUDIO_VOICE_SLOTS <= 8, "voice mask is 8 bits");
+
+#define SNAPSHOT_SEQ_MASK 0xFFFFFFu
+
+static bool seqReached(uint32_t snapshot, uint32_t seq) {
+    return (((snapshot >> 8) - seq) & SNAPSHOT_SEQ_MASK) < 0x800000u;
+}
+
+// Stream headroom counters (written by callback, read by loop)
+static uint32_t streamMinFill = 0;
+static uint32_t streamUnderruns = 0;
+static uint32_t streamUnderrunFrames = 0;
+
+// Profiler accumulators for the callback in progress (callback only)
+static uint32_t cbReadCycles = 0;
+static uint32_t cbPaddingFrames = 0;
+static uint32_t cbBedCycles = 0;
+static uint32_t cbBedFrames = 0;
+
+// Mixer cost, averaged per active-voice count (cycles per frame, EMA)
+static uint32_t mixCyclesPerFrame[AUDIO_MAX_VOICES + 1];
+static uint8_t mixActiveVoices = 0;
+
+static Resampler::Quality resampleQuality = Resampler::QUALITY_MEDIUM;
+
+// Whole clips kept after their first play from SD
+static ClipCache clipCache;
+static size_t clipCacheBudget = 0;  // 0 = auto
+
+// Fades and padding in frames at 44.1kHz (no clock reads in the callback)
+static const uint32_t SILENCE_PADDING_FRAMES = 200 * 44100 / 1000;  // 200ms silence after WAV to prevent click
+static const uint32_t FADEIN_FRAMES = 100 * 44100 / 1000;  // Fade in first 100ms of WAV to prevent click
+static const uint32_t FADEOUT_FRAMES = 100 * 44100 / 1000;  // Fade out last 100ms of WAV to prevent click
+static const uint32_t BED_FADE_FRAMES = 44100;              // Bed fades in / out over 1s
+static uint32_t crossfadeFrames = 30 * 44100 / 1000;        // Retrigger crossfade, set by the loop
+
+// Background bed ducking. Level, depth and coefficients are set by the
+// loop (plain 32-bit stores), the follower state belongs to the callback.
+#define DUCK_BLOCK_FRAMES 16   // Follower step; the gain is ramped across it
+#define DUCK_THRESHOLD 1036    // Jingle peak (-30 dBFS) that ducks the bed fully
+static uint32_t bedCommandSeq = 0;                     // Loop side
+static int32_t bedLevel = MIX_UNITY_GAIN / 2;
+static int32_t duckDepth = MIX_UNITY_GAIN - 8231;      // Ducked to -12 dB
+static int32_t duckAttackCoef = 474;                   // Q16 per step, 50ms
+static int32_t duckReleaseCoef = 30;                   // Q16 per step, 800ms
+static int32_t duckGain = MIX_UNITY_GAIN << 8;         // Callback side, Q23
+
+// Layout of the ring / attack cache for a file: ADPCM is decoded to 16-bit
+// PCM by the stream task, everything else is stored as read from SD
+static PcmConvertFn pcmConverterFor(const WavInfo& info) {
+    if (info.format == WAV_FORMAT_IMA_ADPCM) {
+        return pcmSelectConverter(WAV_FORMAT_PCM, 16, info.channels);
+    }
+    return pcmSelectConverter(info.format, info.bitsPerSample, info.channels);
+}
+
+static uint16_t pcmFrameBytes(const WavInfo& info) {
+    return info.format == WAV_FORMAT_IMA_ADPCM ? info.channels * 2 : info.blockAlign;
+}
+
+// Trim in ms to the file frames played, end exclusive. A start past the
+// file plays from the top, an end before the start plays to the end. The
+// start depends on startMs alone: attack cache, prefetch and playFile()
+// all go through here and agree on where a trimmed clip starts.
+static void trimFrames(const WavInfo& info, uint32_t startMs, uint32_t endMs,
+                       uint32_t& start, uint32_t& end) {
+    start = (uint64_t)startMs * info.sampleRate / 1000;
+    if (start >= info.frames) start = 0;
+    end = info.frames;
+    if (endMs) end = min((uint64_t)end, (uint64_t)endMs * info.sampleRate / 1000);
+    if (end <= start) end = info.frames;
+}
+
+// Data chunk offset to read from to play from file frame `frame`, and the
+// frame the first decoded sample belongs to. ADPCM starts at the block
+// holding the frame; the frames ahead of it are decoded and dropped.
+static uint32_t streamOffsetFor(const WavInfo& info, uint32_t frame, uint32_t& firstFrame) {
+    if (info.format == WAV_FORMAT_IMA_ADPCM) {
+        uint32_t spb = ImaAdpcmDecoder::samplesPerBlock(info.channels, info.blockAlign);
+        firstFrame = frame / spb * spb;
+        return frame / spb * info.blockAlign;
+    }
+    firstFrame = frame;
+    return frame * info.blockAlign;
+}
+
+// Decode into out and drop the first `skip` frames of the result
+static uint32_t decodeSkipping(ImaAdpcmDecoder& dec, const uint8_t* in, size_t n, uint8_t* out,
+                               uint16_t frameBytes, uint32_t& skip) {
+    uint32_t frames = dec.decode(in, n, (int16_t*)out);
+    uint32_t drop = min(frames, skip);
+    if (drop) memmove(out, out + drop * frameBytes, (frames - drop) * frameBytes);
+    skip -= drop;
+    return frames - drop;
+}
+
+// Finger-down prefetch, one at a time. Requested by the loop, filled by the
+// stream task and handed to playFile(), all under streamMutex.
+enum PrefetchState : uint8_t {
+    PREFETCH_IDLE,
+    PREFETCH_REQUESTED,
+    PREFETCH_READY
+};
+struct Prefetch {
+    std::atomic<uint8_t> state;
+    const AudioSource* source;   // The caller's, see prefetch()
+    File file;                   // Positioned right after the buffered data
+    WavInfo info;
+    ImaAdpcmDecoder adpcm;       // Decoder state where the stream resumes
+    uint32_t startMs;            // Trim the buffer starts at
+    uint32_t fileBytes;          // Data chunk offset the stream resumes at
+    uint32_t skipFrames;         // ADPCM: frames still to drop ahead of startMs
+    uint32_t len;                // Ring-format bytes in prefetchBuf
+};
+static Prefetch prefetchJob;  // Zero-initialised: PREFETCH_IDLE
+static uint8_t prefetchBuf[AUDIO_STREAM_CHUNK_BYTES * 2];  // Same as the playFile() priming
+
+// Size of file frames [start, end) in ring format, i.e. what the stream
+// task will write for them
+static uint32_t ringBytes(const WavInfo& info, uint32_t start, uint32_t end) {
+    return (end - start) * pcmFrameBytes(info);
+}
 
 // NEW: Static variables for BT scanning
 static std::vector<AudioPlayer::BTDevice> scannedDevices;
@@ -37,7 +180,7 @@ static int testToneRemaining = 0;
 static float testTonePhase = 0.0;
 static float testToneFreq = 1000.0;
 
-AudioPlayer::AudioPlayer() {
+AudioPlayer::AudioPlayer() : catalog(nullptr), flash(nullptr) {
 }
 
 void AudioPlayer::clearBluetoothPairing() {
@@ -71,6 +214,11 @@ bool AudioPlayer::begin(const char* deviceName, const char* deviceMac, bool clea
         clearBluetoothPairing();
     }
 
+    if (!startStreamTask(this)) {
+        Serial.println("ERROR: SD stream task could not be started");
+        return false;
+    }
+
     a2dp_source.set_data_callback_in_frames(audioCallback);
 
     // Helper to parse and apply MAC-based reconnect
@@ -116,92 +264,696 @@ bool AudioPlayer::begin(const char* deviceName, const char* deviceMac, bool clea
 
 void AudioPlayer::end() {
     Serial.println("[BT] Stopping A2DP source...");
-    playing = false;
-    if (currentFile) currentFile.close();
+    stop();
     a2dp_source.end(false);
     delay(300);
     Serial.println("[BT] A2DP stopped");
 }
 
 bool AudioPlayer::playFile(const String& filepath) {
-    Serial.println("=== playFile() called ===");
-    Serial.print("File: ");
-    Serial.println(filepath);
-    Serial.print("BT Connected: ");
-    Serial.println(a2dp_source.is_connected() ? "YES" : "NO");
+    return playFile(parseAudioSource(filepath), -1, TRIGGER_CHOKE, 0, MIX_UNITY_GAIN);
+}
+
+bool AudioPlayer::playFile(const AudioSource& src, int buttonId, TriggerPolicy policy,
+                           int chokeGroup, int32_t gainQ15, uint32_t triggerUs,
+                           uint32_t startMs, uint32_t endMs) {
+    return startVoice(src, buttonId, policy, chokeGroup, gainQ15, triggerUs, -1, true,
+                      false, 0, 0, startMs, endMs) >= 0;
+}
+
+// How a starting clip gets its data: the source path findSource() took,
+// and what planRegion() worked out from there
+struct AudioPlayer::StartPlan {
+    enum Path : uint8_t {
+        FLASH,          // Memory-mapped flash partition, played in place
+        CLIP_CACHE,     // Whole clip in RAM, played in place
+        ATTACK,         // Attack cache in RAM, the file is opened behind it
+        PREFETCH,       // Opened and buffered on finger-down
+        SD              // Opened now
+    };
+    Path path;
+    WavInfo info;
+    File file;                       // PREFETCH / SD
+    const uint8_t* mapped;           // FLASH / CLIP_CACHE data
+    const ClipCache::Clip* cached;
+    bool cachedTrim;                 // cached holds only the trimmed part
+    const AttackSlot* hit;
+    uint32_t regionStart;            // File frames played, end exclusive
+    uint32_t regionEnd;
+    uint32_t playFrom;               // Trim start, or frame 0 for a loop
+    uint32_t ramFirst;               // RAM data starts at this file frame...
+    uint32_t ramBytes;               // ...and holds this many bytes
+    bool inRam;                      // Region ends in RAM: no stream at all
+    uint32_t firstFrame;             // Stream: first frame the decoder yields
+    uint32_t streamStart;            // Stream: data bytes read, from / to
+    uint32_t streamEnd;
+};
+
+int AudioPlayer::startVoice(const AudioSource& src, int buttonId, TriggerPolicy policy,
+                            int chokeGroup, int32_t gainQ15, uint32_t triggerUs, int after,
+                            bool fadeOut, bool loop, uint32_t loopStart, uint32_t loopEnd,
+                            uint32_t startMs, uint32_t endMs) {
+    if (triggerUs) latencyRecord(LATENCY_PLAY_ENTRY, (uint32_t)esp_timer_get_time() - triggerUs);
+
+    // Trigger path: logging only through the deferred ring, no UART waits
+    ALOG_DEBUG(LOG_PLAY_REQUEST, src.uri.c_str(), buttonId);
 
     // CRITICAL: Don't play if Bluetooth is not connected
     if (!a2dp_source.is_connected()) {
-        Serial.println("ERROR: Cannot play - Bluetooth not connected!");
-        return false;
+        ALOG_WARN(LOG_PLAY_NOT_CONNECTED, nullptr);
+        return -1;
     }
 
-    if (playing) {
-        Serial.println("Stopping current playback...");
-        stop();
+    // Streams that ended without filling their clip can't finish it any more
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        if (voiceFree(i) && !voiceInSequence(i)) abortClipFill(voices[i]);
+    }
+    xSemaphoreGive(streamMutex);
+
+    // Loops play the file as it is, a trim is for one-shots only
+    if (loop) startMs = endMs = 0;
+    StartPlan plan;
+    if (!findSource(src, startMs, endMs, after >= 0, plan)) return -1;
+    if (!planRegion(plan, loop, loopStart, loopEnd, startMs, endMs)) {
+        ALOG_ERROR(LOG_PLAY_INVALID, src.uri.c_str());
+        plan.file.close();
+        return -1;
     }
+    const WavInfo& info = plan.info;
 
-    // Reset audio buffers to ensure clean start
-    resetAudioBuffers();
+    if (triggerUs) latencyRecord(LATENCY_SOURCE_READY, (uint32_t)esp_timer_get_time() - triggerUs);
 
-    // WiFi modem sleep is enabled permanently at startup for BT coexistence
+    // Apply the trigger policy and grab a free voice. A sequence item takes
+    // a free one as it is: it replaces nothing, it only follows.
+    bool replaced = false;
+    bool retriggered = false;
+    Voice* slot = nullptr;
+    if (after < 0) {
+        slot = allocateVoice(buttonId, policy, chokeGroup, replaced, retriggered);
+    } else {
+        for (int i = 0; i < AUDIO_VOICE_SLOTS && !slot; i++) {
+            if (!voiceClaimed[i] && voiceFree(i)) slot = &voices[i];
+        }
+    }
+    if (!slot) {
+        ALOG_ERROR(LOG_PLAY_NO_VOICE, nullptr);
+        if (plan.file) plan.file.close();
+        return -1;
+    }
+    Voice& v = *slot;
+
+    v.looping = loop;
+    v.releasing = false;
+    v.next = -1;
+    v.buttonId = buttonId;
+    v.chokeGroup = (policy == TRIGGER_CHOKE) ? chokeGroup : -1;
+    v.startSeq = ++voiceSeq;
+    v.triggerUs = triggerUs;
+    v.firstFrameOut = false;
+    v.gain = gainQ15;
+    v.info = info;
+    v.convert = plan.cached ? plan.cached->convert : plan.hit ? plan.hit->convert : pcmConverterFor(info);
+    v.frameBytes = pcmFrameBytes(info);
+    v.dither = 0x9E3779B9u ^ v.startSeq;
+    v.bytesRead = 0;
+    v.regionStart = plan.regionStart;
+    v.regionEnd = plan.regionEnd;
+    v.attackData = plan.mapped ? plan.mapped : (plan.hit ? plan.hit->pcm : nullptr);
+    v.attackLen = plan.inRam ? (plan.regionEnd - plan.ramFirst) * v.frameBytes : plan.ramBytes;
+    v.attackPos = (plan.playFrom - plan.ramFirst) * v.frameBytes;
+    // Fade-in ramp now; fade-out starts a fixed number of frames before the
+    // end of the region
+    v.rs.configure(info.sampleRate, 44100, resampleQuality);
+    v.totalFrames = (uint64_t)(plan.regionEnd - plan.playFrom) * 44100 / info.sampleRate;
+    // A clip replacing one that is being faded out comes in over the same
+    // time. A retrigger of the same button is a crossfade of one sound into
+    // itself, so both sides are equal-power: no dip and no hard cut. Every
+    // other fade is linear. Sequence joins get no fades at all: the files
+    // are meant to butt up.
+    v.fadeInFrames = (after >= 0) ? 0 : (replaced && crossfadeFrames) ? crossfadeFrames : FADEIN_FRAMES;
+    v.env.setShape((retriggered && crossfadeFrames) ? AudioEnvelope::SHAPE_EQUAL_POWER
+                                                    : AudioEnvelope::SHAPE_LINEAR);
+    v.env.start(after >= 0 ? AudioEnvelope::UNITY : 0, AudioEnvelope::UNITY, v.fadeInFrames);
+    v.framesPlayed = 0;
+    if (loop) {
+        v.totalFrames = UINT32_MAX;   // No end: stopButton() sets the fade-out
+        v.fadeOutFrame = UINT32_MAX;
+    } else if (!fadeOut) {
+        v.fadeOutFrame = UINT32_MAX;
+    } else {
+        v.fadeOutFrame = v.totalFrames > FADEOUT_FRAMES ? v.totalFrames - FADEOUT_FRAMES : 0;
+    }
+    v.inFadeOut = false;
+    v.tailFramesLeft = SILENCE_PADDING_FRAMES;
+
+    // First play from SD: copy the stream into a clip cache entry on the way
+    // (not from a loop, whose stream goes back to the loop start). A trimmed
+    // one-shot gets its own entry, holding only the trimmed part.
+    ClipCache::Clip* fill = nullptr;
+    if (!plan.mapped && !loop && !plan.inRam) {
+        fill = clipCache.reserve(src.uri, startMs, endMs, ringBytes(info, plan.regionStart, plan.regionEnd),
+                                 info, v.convert, v.frameBytes);
+    }
 
-    // WAV file handling
-    Serial.println("Opening SD file...");
-    currentFile = SD.open(filepath);
-    if (!currentFile) {
-        Serial.println("Failed to open file: " + filepath);
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+    releaseVoiceStream(v);  // Whatever the last jingle on this voice left open
+    abortClipFill(v);
+
+    // Drop whatever an earlier jingle left in this voice's ring. The callback
+    // applies the flush so only the BT task ever moves the read index.
+    v.flushIndex = v.ring.writeIndex();
+    v.flushPending = true;
+
+    v.fillClip = fill;
+    v.fillPos = 0;
+    v.streamFrame = plan.firstFrame;
+    v.skipFrames = plan.playFrom - plan.firstFrame;
+    switch (plan.path) {
+        case StartPlan::FLASH:
+        case StartPlan::CLIP_CACHE: primeMapped(v); break;
+        case StartPlan::ATTACK:     primeFromAttack(v, plan); break;
+        case StartPlan::PREFETCH:   primeFromPrefetch(v, plan); break;
+        case StartPlan::SD:         primeFromSd(v, plan, after >= 0); break;
+    }
+    xSemaphoreGive(streamMutex);
+
+    // Hand the voice to the callback, or have it follow the voice before
+    int index = &v - voices;
+    uint8_t type = (after < 0) ? AUDIO_CMD_START : AUDIO_CMD_CHAIN;
+    if (!sendCommand(type, after < 0 ? index : after, index)) {
+        ALOG_ERROR(LOG_PLAY_QUEUE_FULL, nullptr, type, index);
+        return -1;
+    }
+    voiceClaimed[index] = true;
+    if (after >= 0) {
+        ALOG_INFO(LOG_SEQ_CHAINED, src.uri.c_str(), index, after);
+        return index;
+    }
+    xTaskNotifyGive(streamTaskHandle);
+
+    static const AudioLogId pathLog[] = {LOG_PLAY_FLASH, LOG_PLAY_CLIP_CACHE, LOG_PLAY_ATTACK,
+                                         LOG_PLAY_PREFETCHED, LOG_PLAY_SD};  // By StartPlan::Path
+    ALOG_INFO(pathLog[plan.path], src.uri.c_str(), index);
+    return index;
+}
+
+// Pick the source path: whatever is already in RAM or flash first, then
+// the finger-down prefetch, then the SD card. A sequence item has the
+// whole previous item to open its file, so it skips the attack cache and
+// the prefetch: it is primed from SD instead of opening only once it starts.
+bool AudioPlayer::findSource(const AudioSource& src, uint32_t startMs, uint32_t endMs, bool sequenceItem,
+                             StartPlan& plan) {
+    plan.mapped = nullptr;
+    plan.cached = nullptr;
+    plan.cachedTrim = false;
+    plan.hit = nullptr;
+    if (src.type == SOURCE_FLASH) return findFlashClip(src, plan);
+    if (findCachedClip(src, startMs, endMs, plan)) return true;
+    if (!sequenceItem && findAttack(src, startMs, plan)) return true;
+    if (!sequenceItem && takePrefetch(src.uri, startMs, plan.file, plan.info)) {
+        plan.path = StartPlan::PREFETCH;
+        return true;
+    }
+    return openSdClip(src, plan);
+}
+
+bool AudioPlayer::findFlashClip(const AudioSource& src, StartPlan& plan) {
+    if (!flash || !flash->find(src.path, plan.mapped, plan.info)) {
+        ALOG_ERROR(LOG_PLAY_NOT_FOUND, src.uri.c_str());
         return false;
     }
+    plan.path = StartPlan::FLASH;
+    return true;
+}
+
+// Whole clip in RAM: play it like a mapped flash clip. A trimmed play
+// takes its own clip, else cuts its part out of the whole one.
+bool AudioPlayer::findCachedClip(const AudioSource& src, uint32_t startMs, uint32_t endMs, StartPlan& plan) {
+    plan.cachedTrim = (startMs || endMs) && clipCache.contains(src.uri, startMs, endMs);
+    plan.cached = plan.cachedTrim ? clipCache.lookup(src.uri, startMs, endMs) : clipCache.lookup(src.uri);
+    if (!plan.cached) return false;
+    plan.path = StartPlan::CLIP_CACHE;
+    plan.mapped = plan.cached->data;
+    plan.info = plan.cached->info;
+    return true;
+}
 
-    Serial.println("Validating WAV header...");
-    if (!validateWAVHeader(currentFile)) {
-        Serial.println("Invalid WAV file format");
-        currentFile.close();
+// Cached attack, found before touching the SD card. It has to start where
+// this play does.
+bool AudioPlayer::findAttack(const AudioSource& src, uint32_t startMs, StartPlan& plan) {
+    for (int slot = 0; slot < AUDIO_ATTACK_SLOTS; slot++) {
+        const AttackSlot& a = attackSlots[slot];
+        if (a.pcm && a.startMs == startMs && a.path == src.uri) {
+            plan.path = StartPlan::ATTACK;
+            plan.hit = &a;
+            plan.info = a.info;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Cold path: open and parse the file now
+bool AudioPlayer::openSdClip(const AudioSource& src, StartPlan& plan) {
+    plan.file = SD.open(src.file);
+    if (!plan.file) {
+        ALOG_ERROR(LOG_PLAY_OPEN_FAILED, src.uri.c_str());
+        return false;
+    }
+    if (!validateWAVHeader(plan.file, src.path, plan.info)) {
+        ALOG_ERROR(LOG_PLAY_INVALID, src.uri.c_str());
+        plan.file.close();
         return false;
     }
+    plan.path = StartPlan::SD;
+    return true;
+}
 
-    fileSize = currentFile.size();
-    bytesRead = 44; // Skip WAV header (already read by validation)
-    silencePaddingStart = 0;  // Reset silence padding timer
-    inSilencePadding = false;  // Reset silence padding flag
-    inFadeIn = true;  // Enable fade-in at start
-    fadeInStart = millis();
-    inFadeOut = false;  // Reset fade-out flag
-    fadeOutStart = 0;
+// Region played: the trim of a one-shot (the whole file untrimmed), or
+// for a loop the given points, else the file's smpl loop, else the
+// whole file. Playback starts at playFrom: the trim start, or frame 0
+// for a loop, which plays into its loop. False if the file can't be
+// seeked to where the stream starts.
+bool AudioPlayer::planRegion(StartPlan& plan, bool loop, uint32_t loopStart, uint32_t loopEnd,
+                             uint32_t startMs, uint32_t endMs) {
+    const WavInfo& info = plan.info;
+    trimFrames(info, startMs, endMs, plan.regionStart, plan.regionEnd);
+    if (loop) {
+        plan.regionStart = loopEnd ? loopStart : info.loopStart;
+        plan.regionEnd = loopEnd ? loopEnd : info.loopEnd;
+        if (plan.regionEnd == 0 || plan.regionEnd > info.frames || plan.regionStart >= plan.regionEnd) {
+            plan.regionStart = 0;
+            plan.regionEnd = info.frames;
+        }
+    }
+    plan.playFrom = loop ? 0 : plan.regionStart;
+
+    // What is already in RAM: a whole clip (mapped, from frame 0), or an
+    // attack / trimmed clip starting at playFrom. A region that ends in
+    // there needs no stream at all, and a loop in there repeats right
+    // there. One streamed from SD restarts with a seek on the stream
+    // task, so it has to be long enough for that to be rare.
+    uint16_t frameBytes = pcmFrameBytes(info);
+    plan.ramFirst = (plan.mapped && !plan.cachedTrim) ? 0 : plan.playFrom;
+    plan.ramBytes = plan.cached ? plan.cached->len : plan.mapped ? info.dataSize : plan.hit ? plan.hit->len : 0;
+    plan.inRam = plan.regionEnd <= plan.ramFirst + plan.ramBytes / frameBytes;
+    if (loop && !plan.inRam && plan.regionEnd - plan.regionStart < info.sampleRate / 10) {
+        plan.regionStart = 0;
+        plan.regionEnd = info.frames;
+        plan.inRam = plan.regionEnd <= plan.ramFirst + plan.ramBytes / frameBytes;
+    }
+    bool reseek = false;
+    if (plan.path == StartPlan::PREFETCH && plan.regionEnd < plan.playFrom + prefetchJob.len / frameBytes) {
+        // Region ends inside what the prefetch buffered: start from the file
+        plan.path = StartPlan::SD;
+        reseek = true;
+    }
+
+    // Where the stream starts reading, and the data bytes it reads before
+    // a PCM clip ends or loops back (ADPCM is cut to the frame when decoding)
+    bool adpcm = (info.format == WAV_FORMAT_IMA_ADPCM);
+    plan.streamStart = streamOffsetFor(info, plan.playFrom, plan.firstFrame);
+    plan.streamEnd = adpcm ? info.dataSize : plan.regionEnd * info.blockAlign;
+    return plan.path != StartPlan::SD || !(plan.streamStart || reseek) ||
+           plan.file.seek(info.dataOffset + plan.streamStart);
+}
 
-    // Reset audio callback static buffers (declared in audioCallback)
-    // We need to use a global or add a reset function
+// Stream set-up per source path, caller holds streamMutex
 
-    playing = true;
+// Whole clip is memory mapped / cached - nothing for the stream task to do
+void AudioPlayer::primeMapped(Voice& v) {
+    v.streamBytesLeft = 0;
+    v.streamEof = true;
+    v.openPending = false;
+}
 
-    Serial.println("Playing: " + filepath);
-    Serial.print("File size: ");
-    Serial.println(fileSize);
+// Attack cache hit: the callback starts from RAM right away and the
+// stream task opens/seeks the file behind it
+void AudioPlayer::primeFromAttack(Voice& v, const StartPlan& plan) {
+    const AttackSlot& hit = *plan.hit;
+    if (v.fillClip) {
+        v.fillPos = min(hit.len, v.fillClip->len);
+        memcpy(v.fillClip->data, hit.pcm, v.fillPos);
+    }
+    v.streamBytesLeft = plan.inRam ? 0 : plan.streamEnd - hit.fileBytes;
+    v.streamEof = (v.streamBytesLeft == 0);
+    v.adpcm = hit.adpcm;
+    v.skipFrames = hit.skipFrames;
+    v.streamFrame = plan.playFrom - hit.skipFrames + hit.len / v.frameBytes;
+    v.openPath = &hit.file;
+    v.openOffset = plan.info.dataOffset + hit.fileBytes;
+    v.openPending = !v.streamEof;
+}
+
+// Finger-down prefetch: the ring is primed from RAM, the stream task
+// carries on from where the prefetch stopped reading
+void AudioPlayer::primeFromPrefetch(Voice& v, const StartPlan& plan) {
+    v.file = plan.file;
+    v.adpcm = prefetchJob.adpcm;
+    v.streamBytesLeft = plan.streamEnd - prefetchJob.fileBytes;
+    v.skipFrames = prefetchJob.skipFrames;
+    v.streamFrame = plan.playFrom - prefetchJob.skipFrames + prefetchJob.len / v.frameBytes;
+    v.streamEof = false;
+    v.openPending = false;
+    v.ring.write(prefetchBuf, prefetchJob.len);
+    teeClip(v, prefetchBuf, prefetchJob.len);
+}
+
+// Hand the open file to the stream task and prime the ring so the
+// first callback already has data to play. A sequence item is not
+// refilled until it starts, so it gets the whole ring.
+void AudioPlayer::primeFromSd(Voice& v, const StartPlan& plan, bool sequenceItem) {
+    v.file = plan.file;
+    v.adpcm.begin(plan.info.channels, plan.info.blockAlign);
+    v.streamBytesLeft = plan.streamEnd - plan.streamStart;
+    v.streamEof = false;
+    v.openPending = false;
+    while (fillRing(v)) {
+        if (!sequenceItem && v.ring.writeIndex() - v.flushIndex >= AUDIO_STREAM_CHUNK_BYTES * 2) break;
+    }
+}
+
+bool AudioPlayer::playSequence(const AudioSource* files, int count, const int32_t* gainsQ15, int buttonId,
+                               TriggerPolicy policy, int chokeGroup, uint32_t triggerUs,
+                               uint32_t startMs, uint32_t endMs) {
+    count = min(count, AUDIO_SEQUENCE_MAX);
+    if (count <= 0) return false;
+
+    int voice = startVoice(files[0], buttonId, policy, chokeGroup, gainsQ15[0], triggerUs, -1,
+                           count == 1, false, 0, 0, startMs, endMs);
+    if (voice < 0 || count == 1) return voice >= 0;
+
+    // Every slot taken (four sequences sounding): only the first file plays
+    for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+        Sequence& s = sequences[i];
+        if (s.count) continue;
+        s.files = files;
+        for (int k = 0; k < count; k++) s.gains[k] = gainsQ15[k];
+        s.count = count;
+        s.nextItem = 1;
+        s.voice = voice;
+        s.next = -1;
+        s.buttonId = buttonId;
+        s.policy = policy;
+        s.chokeGroup = chokeGroup;
+        break;
+    }
     return true;
 }
 
-void AudioPlayer::stop() {
-    playing = false;
-    inSilencePadding = false;
-    silencePaddingStart = 0;
-    inFadeIn = false;
-    fadeInStart = 0;
-    inFadeOut = false;
-    fadeOutStart = 0;
+bool AudioPlayer::playLoop(const AudioSource& src, int buttonId, TriggerPolicy policy, int chokeGroup,
+                           int32_t gainQ15, uint32_t triggerUs, uint32_t loopStart, uint32_t loopEnd) {
+    return startVoice(src, buttonId, policy, chokeGroup, gainQ15, triggerUs, -1, false,
+                      true, loopStart, loopEnd) >= 0;
+}
+
+void AudioPlayer::stopButton(int buttonId) {
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        if (!voiceClaimed[i] || voiceFree(i) || voices[i].buttonId != buttonId) continue;
+        voiceClaimed[i] = false;
+        if (!sendCommand(AUDIO_CMD_RELEASE, i)) {
+            ALOG_ERROR(LOG_PLAY_QUEUE_FULL, nullptr, AUDIO_CMD_RELEASE, i);
+        }
+        cancelSequence(i, AUDIO_CMD_RELEASE);
+    }
+}
 
-    // Clean up WAV file if active
-    if (currentFile) {
-        currentFile.close();
+bool AudioPlayer::isButtonPlaying(int buttonId) {
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        if (voiceClaimed[i] && !voiceFree(i) && voices[i].buttonId == buttonId) return true;
     }
+    return false;
+}
 
-    bytesRead = 0;
+// Loop side, every pass: follow the switch-overs the callback has made and
+// prime the next item of every sequence while the current one plays. An
+// item that can't be opened is skipped; with no free voice right now, the
+// next pass tries again.
+void AudioPlayer::updateSequences() {
+    for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+        Sequence& s = sequences[i];
+        if (!s.count) continue;
+
+        // Switched over: the callback has seen the chain and the voice it
+        // was sent to went idle, so the primed voice is the current one now
+        // (cuts cancel the sequence, they never get here)
+        if (s.next >= 0 && voiceFree(s.voice)) {
+            voiceClaimed[s.voice] = false;
+            s.voice = s.next;
+            s.next = -1;
+        }
+
+        if (s.next < 0 && s.nextItem < s.count) {
+            bool freeVoice = false;
+            for (int k = 0; k < AUDIO_VOICE_SLOTS && !freeVoice; k++) {
+                freeVoice = !voiceClaimed[k] && voiceFree(k);
+            }
+            if (!freeVoice) continue;
+
+            int item = s.nextItem++;
+            s.next = startVoice(s.files[item], s.buttonId, s.policy, s.chokeGroup,
+                                s.gains[item], 0, s.voice, s.nextItem == s.count);
+            if (s.next < 0) ALOG_WARN(LOG_SEQ_SKIPPED, s.files[item].uri.c_str());
+            continue;
+        }
+
+        // Last item playing (or nothing left that could be opened) and done
+        if (s.next < 0 && voiceFree(s.voice)) {
+            voiceClaimed[s.voice] = false;
+            s.count = 0;
+        }
+    }
+}
+
+// Apply the trigger policy, then return a free voice. Cuts go through the
+// command queue and fade out over the crossfade time; the spare slot means
+// a free voice is normally there right away. Otherwise voices still fading
+// are cut short and we wait (bounded) for the callback to release one.
+// replaced = something was cut for this voice, so it should crossfade in;
+// retriggered = that was the same button's own clip.
+AudioPlayer::Voice* AudioPlayer::allocateVoice(int buttonId, TriggerPolicy policy, int chokeGroup,
+                                               bool& replaced, bool& retriggered) {
+    int live = 0;
+    int oldest = -1;
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        Voice& v = voices[i];
+        // Ended on its own: nothing to cut, the slot can be set up again
+        if (voiceClaimed[i] && voiceFree(i) && !voiceInSequence(i)) voiceClaimed[i] = false;
+        if (!voiceClaimed[i] || voiceFree(i)) continue;
+        bool cut = (policy == TRIGGER_RESTART && buttonId >= 0 && v.buttonId == buttonId) ||
+                   (policy == TRIGGER_CHOKE && v.chokeGroup == chokeGroup);
+        if (cut) {
+            bool own = buttonId >= 0 && v.buttonId == buttonId;
+            stopVoice(v, own);
+            replaced = true;
+            retriggered |= own;
+            continue;
+        }
+        live++;
+        if (oldest < 0 || v.startSeq < voices[oldest].startSeq) oldest = i;
+    }
+
+    // Keep at most AUDIO_MAX_VOICES sounding: steal the oldest
+    if (live >= AUDIO_MAX_VOICES) {
+        stopVoice(voices[oldest], false);
+        replaced = true;
+    }
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+            if (!voiceClaimed[i] && voiceFree(i)) return &voices[i];
+        }
+        for (int i = 0; i < AUDIO_VOICE_SLOTS && attempt == 0; i++) {
+            if (!voiceClaimed[i] && !voiceFree(i)) sendCommand(AUDIO_CMD_STOP, i);
+        }
+        if (!waitForCallback(50)) break;
+    }
+    return nullptr;
+}
+
+// Loop side: ask the callback to cut a voice (with the crossfade, if set;
+// equal-power when the clip replacing it is its own retrigger). The stream
+// task closes its file once the callback has let go of it.
+void AudioPlayer::stopVoice(Voice& v, bool crossfade) {
+    int index = &v - voices;
+    if (!voiceClaimed[index]) return;
+    voiceClaimed[index] = false;
+    uint8_t type = !crossfadeFrames ? AUDIO_CMD_STOP : crossfade ? AUDIO_CMD_CROSSFADE : AUDIO_CMD_FADE_OUT;
+    if (!sendCommand(type, index)) {
+        ALOG_ERROR(LOG_PLAY_QUEUE_FULL, nullptr, type, index);
+    }
+    cancelSequence(index, type);
+}
+
+// A voice a running sequence is playing or has primed
+bool AudioPlayer::voiceInSequence(int index) {
+    for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+        const Sequence& s = sequences[i];
+        if (s.count && (s.voice == index || s.next == index)) return true;
+    }
+    return false;
+}
+
+// Loop side: the sequence on this voice was cut. The cut command already
+// unchained the voice in the callback; the other voice of the pair (primed,
+// or already switched to) gets the same cut.
+void AudioPlayer::cancelSequence(int index, uint8_t type) {
+    for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+        Sequence& s = sequences[i];
+        if (!s.count || (s.voice != index && s.next != index)) continue;
+        s.count = 0;
+        int other = (s.voice == index) ? s.next : s.voice;
+        if (other < 0 || !voiceClaimed[other]) continue;
+        voiceClaimed[other] = false;
+        if (!sendCommand(type, other)) {
+            ALOG_ERROR(LOG_PLAY_QUEUE_FULL, nullptr, type, other);
+        }
+    }
+}
+
+void AudioPlayer::stop() {
+    sendCommand(AUDIO_CMD_STOP_ALL, -1);
+    for (int i = 0; i < AUDIO_MAX_VOICES; i++) sequences[i].count = 0;
 
     // WiFi stays in modem sleep mode permanently (required for BT)
 }
 
 bool AudioPlayer::isPlaying() {
-    return playing;
+    uint32_t snap = audioSnapshot.load(std::memory_order_acquire);
+    return (snap & 0xFF) != 0 || !seqReached(snap, commandSeq);
+}
+
+// A voice the loop may set up: the callback is not mixing it and has seen
+// every command sent for it
+bool AudioPlayer::voiceFree(int index) {
+    uint32_t snap = audioSnapshot.load(std::memory_order_acquire);
+    return !(snap & (1u << index)) && seqReached(snap, voiceCommandSeq[index]);
+}
+
+bool AudioPlayer::bedFree() {
+    uint32_t snap = audioSnapshot.load(std::memory_order_acquire);
+    return bed.state == VOICE_IDLE && seqReached(snap, bedCommandSeq);
+}
+
+bool AudioPlayer::sendCommand(uint8_t type, int voice, int next) {
+    AudioCommand cmd;
+    cmd.type = type;
+    cmd.voice = voice < 0 ? 0xFF : voice;
+    cmd.next = next < 0 ? 0xFF : next;
+    cmd.seq = (commandSeq + 1) & SNAPSHOT_SEQ_MASK;
+    if (!commandQueue.push(cmd)) return false;
+
+    commandSeq = cmd.seq;
+    if (type == AUDIO_CMD_BED_START || type == AUDIO_CMD_BED_STOP) {
+        bedCommandSeq = cmd.seq;
+        return true;
+    }
+    if (type == AUDIO_CMD_TEST_TONE) return true;
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        if (voice < 0 || voice == i || (type == AUDIO_CMD_CHAIN && next == i)) {
+            voiceCommandSeq[i] = cmd.seq;
+        }
+        if (voice < 0) voiceClaimed[i] = false;
+    }
+    return true;
+}
+
+// Block until the callback has applied everything queued so far. Used
+// before freeing memory a voice might read. Gives up after timeoutMs (the
+// callback only runs while a speaker is streaming).
+bool AudioPlayer::waitForCallback(uint32_t timeoutMs) {
+    uint32_t start = millis();
+    while (!seqReached(audioSnapshot.load(std::memory_order_acquire), commandSeq)) {
+        if (millis() - start >= timeoutMs) return false;
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+// Callback side: apply one loop command
+void AudioPlayer::applyCommand(const AudioCommand& cmd) {
+    appliedSeq = cmd.seq;
+    if (cmd.type == AUDIO_CMD_BED_START) {
+        bed.state = VOICE_PLAYING;
+        return;
+    }
+    if (cmd.type == AUDIO_CMD_BED_STOP) {
+        startRelease(bed, BED_FADE_FRAMES);
+        return;
+    }
+    if (cmd.type == AUDIO_CMD_CHAIN) {
+        // Normally the voice is still playing and hands over at its end.
+        // One that already ran out (item shorter than the priming took)
+        // hands over now, one being cut never does.
+        Voice& v = voices[cmd.voice];
+        if (v.state == VOICE_PLAYING && !v.releasing) {
+            v.next = cmd.next;
+        } else if (!v.releasing) {
+            v.state = VOICE_IDLE;
+            voices[cmd.next].state = VOICE_PLAYING;
+        }
+        return;
+    }
+    if (cmd.type == AUDIO_CMD_TEST_TONE) {
+        testTonePhase = 0.0;
+        testToneRemaining = 44100;
+        playingTestTone = true;
+        return;
+    }
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        if (cmd.voice != 0xFF && cmd.voice != i) continue;
+        Voice& v = voices[i];
+        if (cmd.type != AUDIO_CMD_START) v.next = -1;  // A cut voice hands over to nothing
+        if (cmd.type == AUDIO_CMD_START) {
+            v.state = VOICE_PLAYING;
+        } else if (cmd.type == AUDIO_CMD_FADE_OUT) {
+            startRelease(v, crossfadeFrames);
+        } else if (cmd.type == AUDIO_CMD_CROSSFADE) {
+            startRelease(v, crossfadeFrames, AudioEnvelope::SHAPE_EQUAL_POWER);
+        } else if (cmd.type == AUDIO_CMD_RELEASE) {
+            startRelease(v, FADEOUT_FRAMES);
+        } else if (v.state != VOICE_IDLE) {
+            v.state = VOICE_IDLE;
+            v.releaseStream = true;
+        }
+    }
+}
+
+// Callback side: ramp a voice down from wherever it is now and let
+// renderVoice() release it at the end. The stream keeps draining its ring
+// meanwhile. A voice already in its silence tail just goes idle.
+void AudioPlayer::startRelease(Voice& v, uint32_t frames, AudioEnvelope::Shape shape) {
+    if (v.state == VOICE_TAIL || (v.state == VOICE_PLAYING && frames == 0)) {
+        v.state = VOICE_IDLE;
+        v.releaseStream = true;
+        return;
+    }
+    if (v.state != VOICE_PLAYING || v.releasing) return;
+    v.releasing = true;
+    v.inFadeOut = true;
+    v.fadeOutFrame = v.framesPlayed;
+    v.totalFrames = v.framesPlayed + frames;
+    v.env.setShape(shape);
+    v.env.rampTo(0, frames);
+}
+
+// Callback side: report voices still sounding + last command applied
+void AudioPlayer::publishSnapshot() {
+    uint32_t mask = 0;
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        if (voices[i].state != VOICE_IDLE) mask |= 1u << i;
+    }
+    audioSnapshot.store((appliedSeq << 8) | mask, std::memory_order_release);
+}
+
+// Close whatever file a cut voice still holds. Caller holds streamMutex.
+void AudioPlayer::releaseVoiceStream(Voice& v) {
+    if (v.file) v.file.close();
+    v.streamEof = true;
+    v.streamBytesLeft = 0;
+    v.openPending = false;
+    v.releaseStream = false;
 }
 
 bool AudioPlayer::isConnected() {
@@ -212,19 +964,621 @@ void AudioPlayer::setVolume(uint8_t volume) {
     a2dp_source.set_volume(volume);
 }
 
-// Static buffers used in audioCallback - need to be accessible from here
-static uint8_t audioBuf[2048];
-static int audioBufPos = 0;
-static int audioBufLen = 0;
+AudioPlayer::StreamStats AudioPlayer::getStreamStats() {
+    StreamStats stats;
+    stats.capacity = voices[0].ring.capacity();
+    stats.fill = stats.capacity;
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        if (voices[i].state == VOICE_PLAYING) {
+            stats.fill = min(stats.fill, (uint32_t)voices[i].ring.available());
+        }
+    }
+    stats.minFill = streamMinFill;
+    stats.underruns = streamUnderruns;
+    stats.underrunFrames = streamUnderrunFrames;
+    return stats;
+}
+
+void AudioPlayer::resetStreamStats() {
+    streamMinFill = voices[0].ring.capacity();
+    streamUnderruns = 0;
+    streamUnderrunFrames = 0;
+}
+
+void AudioPlayer::setCrossfade(uint32_t ms) {
+    crossfadeFrames = ms * 44100 / 1000;
+}
+
+void AudioPlayer::setResampleQuality(Resampler::Quality quality) {
+    resampleQuality = quality;
+}
+
+void AudioPlayer::setClipCacheBudget(size_t bytes) {
+    clipCacheBudget = bytes;
+}
+
+ClipCache::Stats AudioPlayer::getClipCacheStats() {
+    return clipCache.getStats();
+}
+
+void AudioPlayer::setCatalog(JingleCatalog* cat) {
+    catalog = cat;
+}
+
+void AudioPlayer::setFlashJingles(FlashJingles* store) {
+    flash = store;
+}
+
+AudioPlayer::MixerStats AudioPlayer::getMixerStats() {
+    MixerStats stats;
+    stats.voices = mixActiveVoices;
+    memcpy(stats.cyclesPerFrame, mixCyclesPerFrame, sizeof(mixCyclesPerFrame));
+    return stats;
+}
+
+// Callback scratch: raw file bytes, one voice rendered to stereo, and the
+// int32 mix bus
+#define MIX_BLOCK_FRAMES 256
+static uint8_t audioBuf[MIX_BLOCK_FRAMES * 8];  // Up to 32-bit stereo
+static int16_t voiceBuf[MIX_BLOCK_FRAMES * 2];
+static int16_t convBuf[MIX_BLOCK_FRAMES * 2];  // File-rate frames ahead of the resampler
+static int32_t mixBus[MIX_BLOCK_FRAMES * 2];
+static int32_t bedBus[MIX_BLOCK_FRAMES * 2];   // Bed at its level, before ducking
+
+// Stream task staging buffer (SD reads land here, then go into the ring)
+static uint8_t streamBuf[AUDIO_STREAM_CHUNK_BYTES];
+static int16_t adpcmBuf[AUDIO_STREAM_CHUNK_BYTES / 2];  // Decoded ADPCM, before the ring
 
 void AudioPlayer::resetAudioBuffers() {
-    // Reset all static buffers used in audioCallback
-    memset(audioBuf, 0, sizeof(audioBuf));
-    audioBufPos = 0;
-    audioBufLen = 0;
+    // Drop whatever is still queued for the callback on every voice
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        voices[i].flushIndex = voices[i].ring.writeIndex();
+        voices[i].flushPending = true;
+    }
+    bed.flushIndex = bed.ring.writeIndex();
+    bed.flushPending = true;
     Serial.println("[AUDIO] Buffers reset");
 }
 
+// ── SD prefetch task ──────────────────────────────────────────────────────────
+
+bool AudioPlayer::startStreamTask(AudioPlayer* owner) {
+    if (streamTaskHandle) return true;
+
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        voices[i].state = VOICE_IDLE;
+        voices[i].next = -1;
+        voices[i].streamEof = true;
+        voices[i].releaseStream = false;
+        voices[i].flushPending = false;
+        voices[i].fillClip = nullptr;
+        if (!voices[i].ring.allocate(AUDIO_STREAM_BUFFER_BYTES)) return false;
+    }
+    // The bed's ring is only allocated once a bed is played
+    bed.state = VOICE_IDLE;
+    bed.next = -1;
+    bed.looping = true;
+    bed.streamEof = true;
+    bed.releaseStream = false;
+    bed.flushPending = false;
+    bed.fillClip = nullptr;
+    streamMutex = xSemaphoreCreateMutex();
+    if (!streamMutex) return false;
+    clipCache.begin(clipCacheBudget, clipInUse);
+
+    BaseType_t ok = xTaskCreatePinnedToCore(streamTask, "sd_stream", AUDIO_STREAM_TASK_STACK,
+                                            owner, AUDIO_STREAM_TASK_PRIORITY,
+                                            &streamTaskHandle, AUDIO_STREAM_TASK_CORE);
+    if (ok != pdPASS) {
+        streamTaskHandle = nullptr;
+        return false;
+    }
+
+    Serial.printf("[AUDIO] Stream task started, %d voices x %u byte ring on core %d\n",
+                  AUDIO_VOICE_SLOTS, (unsigned)voices[0].ring.capacity(), AUDIO_STREAM_TASK_CORE);
+    return true;
+}
+
+void AudioPlayer::streamTask(void* param) {
+    AudioPlayer* owner = (AudioPlayer*)param;
+
+    for (;;) {
+        // Voices the callback has cut don't need their files any more
+        for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+            if (!voices[i].releaseStream) continue;
+            xSemaphoreTake(streamMutex, portMAX_DELAY);
+            if (voices[i].releaseStream) releaseVoiceStream(voices[i]);
+            xSemaphoreGive(streamMutex);
+        }
+        if (bed.releaseStream) {
+            xSemaphoreTake(streamMutex, portMAX_DELAY);
+            if (bed.releaseStream) releaseVoiceStream(bed);
+            xSemaphoreGive(streamMutex);
+        }
+
+        // Refill the emptiest voice first so one long jingle can't starve
+        // a freshly triggered one
+        Voice* target = nullptr;
+        size_t lowest = SIZE_MAX;
+        for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+            Voice& v = voices[i];
+            if (v.state != VOICE_PLAYING || v.streamEof) continue;
+            size_t fill = v.ring.available();
+            if (fill < lowest) {
+                lowest = fill;
+                target = &v;
+            }
+        }
+
+        bool more = false;
+        if (target) {
+            xSemaphoreTake(streamMutex, portMAX_DELAY);
+            more = fillRing(*target);
+            xSemaphoreGive(streamMutex);
+        }
+
+        // Finger-down prefetch once the playing voices have been topped up
+        if (!more && prefetchJob.state == PREFETCH_REQUESTED) {
+            xSemaphoreTake(streamMutex, portMAX_DELAY);
+            more = owner->runPrefetch();
+            xSemaphoreGive(streamMutex);
+        }
+
+        // Bed last: its deeper ring rides out the time jingles come first
+        if (!more && bed.state == VOICE_PLAYING && !bed.streamEof) {
+            xSemaphoreTake(streamMutex, portMAX_DELAY);
+            more = fillRing(bed);
+            xSemaphoreGive(streamMutex);
+        }
+
+        // All rings full or nothing to stream: sleep until playFile() kicks
+        // us or the callback has drained a chunk (~11ms of stereo at 44.1kHz)
+        if (!more) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(5));
+    }
+}
+
+// Read one chunk from SD into the voice's ring. Caller holds streamMutex.
+// Returns true if another chunk could be read right away.
+bool AudioPlayer::fillRing(Voice& v) {
+    if (v.openPending && !openPendingStream(v)) return false;
+    if (!v.file || v.streamEof) return false;
+
+    if (v.info.format == WAV_FORMAT_IMA_ADPCM) return fillRingAdpcm(v);
+
+    int bytesPerFrame = v.info.blockAlign;
+    size_t want = min((size_t)AUDIO_STREAM_CHUNK_BYTES, v.ring.freeSpace());
+    want = min(want, (size_t)v.streamBytesLeft);
+    want -= want % bytesPerFrame;  // Only whole frames go into the ring
+    if (want == 0) {
+        if (v.streamBytesLeft < (uint32_t)bytesPerFrame) {
+            if (v.looping) return rewindStream(v);
+            v.streamEof = true;
+            v.file.close();
+        }
+        return false;
+    }
+
+    int n = v.file.read(streamBuf, want);
+    if (n <= 0) {
+        v.streamEof = true;
+        v.file.close();
+        return false;
+    }
+    n -= n % bytesPerFrame;
+    v.ring.write(streamBuf, n);
+    teeClip(v, streamBuf, n);
+    v.streamBytesLeft -= n;
+
+    return v.ring.freeSpace() >= AUDIO_STREAM_CHUNK_BYTES;
+}
+
+// ADPCM variant: read only the compressed bytes that decode to what fits
+// in the ring, and store 16-bit PCM. Caller holds streamMutex.
+bool AudioPlayer::fillRingAdpcm(Voice& v) {
+    int maxFrames = min((size_t)AUDIO_STREAM_CHUNK_BYTES, v.ring.freeSpace()) / v.frameBytes;
+    size_t want = min(v.adpcm.nextReadSize(maxFrames, sizeof(streamBuf)), (size_t)v.streamBytesLeft);
+    if (v.streamBytesLeft == 0 || v.streamFrame >= v.regionEnd) {
+        if (v.looping) return rewindStream(v);
+        v.streamEof = true;
+        v.file.close();
+        return false;
+    }
+    if (want == 0) return false;
+
+    int n = v.file.read(streamBuf, want);
+    if (n <= 0) {
+        v.streamEof = true;
+        v.file.close();
+        return false;
+    }
+    v.streamBytesLeft -= n;
+
+    // Decoding goes by whole bytes / blocks; the region (loop or trim) is
+    // cut to the frame here, dropping what precedes its start and what runs
+    // past its end
+    uint32_t frames = v.adpcm.decode(streamBuf, n, adpcmBuf);
+    uint32_t first = min(frames, v.skipFrames);
+    uint32_t last = min(frames, v.regionEnd - v.streamFrame);
+    if (last < first) last = first;
+    v.skipFrames -= first;
+    v.streamFrame += frames;
+    const uint8_t* pcm = (const uint8_t*)adpcmBuf + first * v.frameBytes;
+    v.ring.write(pcm, (last - first) * v.frameBytes);
+    teeClip(v, pcm, (last - first) * v.frameBytes);
+
+    return v.ring.freeSpace() >= AUDIO_STREAM_CHUNK_BYTES;
+}
+
+// Looping voice reached its loop end: seek the open file back to the loop
+// start. The ring still holds what the callback plays meanwhile, so the
+// seek never shows up as a gap. Caller holds streamMutex.
+bool AudioPlayer::rewindStream(Voice& v) {
+    const WavInfo& info = v.info;
+    uint32_t offset = streamOffsetFor(info, v.regionStart, v.streamFrame);
+    v.skipFrames = v.regionStart - v.streamFrame;
+    if (info.format == WAV_FORMAT_IMA_ADPCM) {
+        // Decoding restarts at a block header
+        v.streamBytesLeft = info.dataSize - offset;
+        v.adpcm.begin(info.channels, info.blockAlign);
+    } else {
+        v.streamBytesLeft = (v.regionEnd - v.regionStart) * info.blockAlign;
+    }
+    if (!v.file.seek(info.dataOffset + offset)) {
+        v.streamEof = true;
+        v.file.close();
+        return false;
+    }
+    return true;
+}
+
+// Open + seek for an attack-cache hit. Caller holds streamMutex.
+bool AudioPlayer::openPendingStream(Voice& v) {
+    v.openPending = false;
+    v.file = SD.open(*v.openPath);
+    if (!v.file || !v.file.seek(v.openOffset)) {
+        ALOG_ERROR(LOG_STREAM_OPEN_FAILED, v.openPath->c_str());
+        if (v.file) v.file.close();
+        v.streamEof = true;  // Voice ends after the cached attack
+        return false;
+    }
+    return true;
+}
+
+// ── Finger-down prefetch ──────────────────────────────────────────────────────
+
+void AudioPlayer::prefetch(const AudioSource& src, uint32_t startMs) {
+    cancelPrefetch();
+    if (src.uri.length() == 0 || !streamMutex) return;
+
+    // Sources that already start from RAM or flash gain nothing
+    if (src.type != SOURCE_SD || clipCache.contains(src.uri)) return;
+    for (int slot = 0; slot < AUDIO_ATTACK_SLOTS; slot++) {
+        if (attackSlots[slot].pcm && attackSlots[slot].path == src.uri && attackSlots[slot].startMs == startMs) {
+            return;
+        }
+    }
+
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+    prefetchJob.source = &src;
+    prefetchJob.startMs = startMs;
+    prefetchJob.state = PREFETCH_REQUESTED;
+    xSemaphoreGive(streamMutex);
+    xTaskNotifyGive(streamTaskHandle);
+}
+
+void AudioPlayer::cancelPrefetch() {
+    if (!streamMutex) return;
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+    if (prefetchJob.file) prefetchJob.file.close();
+    prefetchJob.state = PREFETCH_IDLE;
+    prefetchJob.source = nullptr;
+    xSemaphoreGive(streamMutex);
+}
+
+// Open, validate and buffer the requested file. Runs on the stream task,
+// caller holds streamMutex. Returns true if there may be more work.
+bool AudioPlayer::runPrefetch() {
+    Prefetch& p = prefetchJob;
+    if (p.state != PREFETCH_REQUESTED) return false;  // Taken or cancelled meanwhile
+    const AudioSource& src = *p.source;
+    p.state = PREFETCH_IDLE;
+    p.len = 0;
+
+    p.file = SD.open(src.file);
+    if (!p.file) return false;
+    if (!validateWAVHeader(p.file, src.path, p.info)) {
+        p.file.close();
+        return false;
+    }
+
+    // Start where the trimmed clip does
+    const WavInfo& info = p.info;
+    uint32_t start, end, firstFrame;
+    trimFrames(info, p.startMs, 0, start, end);
+    p.fileBytes = streamOffsetFor(info, start, firstFrame);
+    p.skipFrames = start - firstFrame;
+    if (!p.file.seek(info.dataOffset + p.fileBytes)) {
+        p.file.close();
+        return false;
+    }
+
+    int bytesPerFrame = pcmFrameBytes(info);
+    if (info.format == WAV_FORMAT_IMA_ADPCM) {
+        p.adpcm.begin(info.channels, info.blockAlign);
+        while (true) {
+            int maxFrames = (sizeof(prefetchBuf) - p.len) / bytesPerFrame;
+            size_t want = min(p.adpcm.nextReadSize(maxFrames, sizeof(streamBuf)), (size_t)(info.dataSize - p.fileBytes));
+            if (want == 0 || p.file.read(streamBuf, want) != want) break;
+            p.fileBytes += want;
+            p.len += decodeSkipping(p.adpcm, streamBuf, want, prefetchBuf + p.len, bytesPerFrame,
+                                    p.skipFrames) * bytesPerFrame;
+        }
+    } else {
+        size_t want = min(sizeof(prefetchBuf), (size_t)(info.dataSize - p.fileBytes));
+        int n = p.file.read(prefetchBuf, want - want % bytesPerFrame);
+        p.len = n > 0 ? n - n % bytesPerFrame : 0;
+        p.fileBytes += p.len;
+        if (!p.file.seek(info.dataOffset + p.fileBytes)) {
+            p.file.close();
+            return false;
+        }
+    }
+
+    p.state = PREFETCH_READY;
+    return true;
+}
+
+// Hand a finished prefetch for this path and trim start to playFile(). A
+// prefetch for anything else is dropped; one still running is waited for
+// via the mutex.
+bool AudioPlayer::takePrefetch(const String& uri, uint32_t startMs, File& file, WavInfo& info) {
+    bool ok = false;
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+    if (prefetchJob.state == PREFETCH_READY && prefetchJob.source->uri == uri &&
+        prefetchJob.startMs == startMs) {
+        file = prefetchJob.file;
+        info = prefetchJob.info;
+        prefetchJob.file = File();
+        ok = true;
+    } else if (prefetchJob.file) {
+        prefetchJob.file.close();
+    }
+    prefetchJob.state = PREFETCH_IDLE;  // prefetchBuf stays valid until the next request
+    xSemaphoreGive(streamMutex);
+    return ok;
+}
+
+// ── Background bed ────────────────────────────────────────────────────────────
+
+// Set up the idle bed voice and hand it to the callback. A bed that is
+// still sounding (or fading out) has to finish first.
+bool AudioPlayer::playBed(const String& filepath) {
+    if (!streamMutex || !bedFree()) return false;
+
+    AudioSource src = parseAudioSource(filepath);
+    File file = (src.type == SOURCE_SD) ? SD.open(src.file) : File();
+    WavInfo info;
+    if (!file || !validateWAVHeader(file, src.path, info) ||
+        info.dataSize < AUDIO_STREAM_CHUNK_BYTES ||
+        (!bed.ring.capacity() && !bed.ring.allocate(AUDIO_BED_BUFFER_BYTES))) {
+        ALOG_ERROR(LOG_BED_FAILED, filepath.c_str());
+        if (file) file.close();
+        return false;
+    }
+
+    bed.looping = true;
+    bed.releasing = false;
+    bed.buttonId = -1;
+    bed.chokeGroup = -1;
+    bed.triggerUs = 0;
+    bed.firstFrameOut = true;
+    bed.gain = bedLevel;
+    bed.info = info;
+    bed.convert = pcmConverterFor(info);
+    bed.frameBytes = pcmFrameBytes(info);
+    bed.dither = 0x9E3779B9u;
+    bed.bytesRead = 0;
+    bed.regionStart = 0;
+    bed.regionEnd = info.frames;
+    bed.attackData = nullptr;
+    bed.attackLen = 0;
+    bed.attackPos = 0;
+    bed.rs.configure(info.sampleRate, 44100, resampleQuality);
+    bed.fadeInFrames = BED_FADE_FRAMES;
+    bed.env.setShape(AudioEnvelope::SHAPE_LINEAR);
+    bed.env.start(0, AudioEnvelope::UNITY, BED_FADE_FRAMES);
+    bed.framesPlayed = 0;
+    bed.totalFrames = UINT32_MAX;   // No end: stopBed() sets the fade-out
+    bed.fadeOutFrame = UINT32_MAX;
+    bed.inFadeOut = false;
+    bed.tailFramesLeft = SILENCE_PADDING_FRAMES;
+
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+    releaseVoiceStream(bed);
+    bed.flushIndex = bed.ring.writeIndex();
+    bed.flushPending = true;
+    bed.fillClip = nullptr;
+    bed.file = file;
+    bed.adpcm.begin(info.channels, info.blockAlign);
+    bed.streamFrame = 0;
+    bed.skipFrames = 0;
+    bed.streamBytesLeft = info.dataSize;
+    bed.streamEof = false;
+    bed.openPending = false;
+    while (fillRing(bed)) {
+        if (bed.ring.writeIndex() - bed.flushIndex >= AUDIO_STREAM_CHUNK_BYTES * 4) break;
+    }
+    xSemaphoreGive(streamMutex);
+
+    if (!sendCommand(AUDIO_CMD_BED_START, -1)) {
+        ALOG_ERROR(LOG_PLAY_QUEUE_FULL, nullptr, AUDIO_CMD_BED_START, PROFILER_VOICE_BED);
+        xSemaphoreTake(streamMutex, portMAX_DELAY);
+        releaseVoiceStream(bed);
+        xSemaphoreGive(streamMutex);
+        return false;
+    }
+    xTaskNotifyGive(streamTaskHandle);
+
+    ALOG_INFO(LOG_BED_START, filepath.c_str());
+    return true;
+}
+
+void AudioPlayer::stopBed() {
+    if (bedFree()) return;
+    if (!sendCommand(AUDIO_CMD_BED_STOP, -1)) {
+        ALOG_ERROR(LOG_PLAY_QUEUE_FULL, nullptr, AUDIO_CMD_BED_STOP, PROFILER_VOICE_BED);
+    }
+}
+
+bool AudioPlayer::isBedPlaying() {
+    return !bedFree();
+}
+
+void AudioPlayer::setBedLevel(int32_t gainQ15) {
+    bedLevel = constrain(gainQ15, 0, MIX_UNITY_GAIN);
+    bed.gain = bedLevel;
+}
+
+// One-pole coefficient (Q16) for a time constant, per follower step
+static int32_t duckCoef(uint32_t ms) {
+    if (ms == 0) return 65536;
+    float c = 1.0f - expf(-(float)DUCK_BLOCK_FRAMES / (ms * 44.1f));
+    return max((int32_t)1, (int32_t)lroundf(c * 65536.0f));
+}
+
+void AudioPlayer::setDucking(int32_t duckGainQ15, uint32_t attackMs, uint32_t releaseMs) {
+    duckDepth = MIX_UNITY_GAIN - constrain(duckGainQ15, 0, MIX_UNITY_GAIN);
+    duckAttackCoef = duckCoef(attackMs);
+    duckReleaseCoef = duckCoef(releaseMs);
+}
+
+// ── Clip cache ────────────────────────────────────────────────────────────────
+
+// Copy what just went into the ring into the voice's clip cache entry.
+// Caller holds streamMutex.
+void AudioPlayer::teeClip(Voice& v, const uint8_t* data, size_t len) {
+    ClipCache::Clip* clip = v.fillClip;
+    if (!clip) return;
+
+    len = min(len, (size_t)(clip->len - v.fillPos));  // ADPCM pads the last block
+    memcpy(clip->data + v.fillPos, data, len);
+    v.fillPos += len;
+    if (v.fillPos == clip->len) {
+        clip->complete = true;
+        v.fillClip = nullptr;
+    }
+}
+
+// Give back a clip the voice stopped filling. Caller holds streamMutex
+// (or the stream task can't be touching the voice).
+void AudioPlayer::abortClipFill(Voice& v) {
+    if (!v.fillClip) return;
+    clipCache.abort(v.fillClip);
+    v.fillClip = nullptr;
+}
+
+// Eviction guard: a voice may still be playing from this clip
+bool AudioPlayer::clipInUse(const uint8_t* data) {
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        bool live = voices[i].state != VOICE_IDLE || voiceInSequence(i);
+        if (live && voices[i].attackData == data) return true;
+    }
+    return false;
+}
+
+// ── Attack cache ──────────────────────────────────────────────────────────────
+
+bool AudioPlayer::cacheAttack(int slot, const AudioSource& src, uint32_t startMs) {
+    if (slot < 0 || slot >= AUDIO_ATTACK_SLOTS) return false;
+
+    AttackSlot& a = attackSlots[slot];
+    if (a.pcm) free(a.pcm);
+    a.pcm = nullptr;
+    a.len = 0;
+    a.path = "";
+
+    // Flash clips are memory mapped already
+    if (src.uri.length() == 0 || src.type != SOURCE_SD) return false;
+
+    File file = SD.open(src.file);
+    if (!file) return false;
+
+    WavInfo info;
+    if (!validateWAVHeader(file, src.path, info)) {
+        file.close();
+        return false;
+    }
+
+    // Cached from the trim start, like a prefetch
+    uint32_t start, end, firstFrame;
+    trimFrames(info, startMs, 0, start, end);
+    uint32_t offset = streamOffsetFor(info, start, firstFrame);
+
+    int bytesPerFrame = pcmFrameBytes(info);
+    uint32_t frames = min((uint32_t)(AUDIO_ATTACK_CACHE_MS * info.sampleRate / 1000), end - start);
+    uint32_t len = frames * bytesPerFrame;
+    if (len == 0) {  // Trimmed to nothing: no attack to cache
+        file.close();
+        return false;
+    }
+
+    a.pcm = (uint8_t*)malloc(len);
+    if (!a.pcm) {
+        Serial.printf("[AUDIO] Attack cache: no RAM for slot %d\n", slot);
+        file.close();
+        return false;
+    }
+
+    if (!file.seek(info.dataOffset + offset)) {
+        free(a.pcm);
+        a.pcm = nullptr;
+        file.close();
+        return false;
+    }
+    a.fileBytes = offset;
+    a.skipFrames = start - firstFrame;
+    if (info.format == WAV_FORMAT_IMA_ADPCM) {
+        // Decode the attack now; the decoder state is kept so the stream
+        // task can pick up mid-block right after it
+        uint8_t packed[512];
+        a.adpcm.begin(info.channels, info.blockAlign);
+        a.len = 0;
+        while (a.len < len) {
+            int maxFrames = min((len - a.len) / bytesPerFrame, (uint32_t)256);
+            size_t want = min(a.adpcm.nextReadSize(maxFrames, sizeof(packed)), (size_t)(info.dataSize - a.fileBytes));
+            if (want == 0 || file.read(packed, want) != want) break;
+            a.fileBytes += want;
+            a.len += decodeSkipping(a.adpcm, packed, want, a.pcm + a.len, bytesPerFrame, a.skipFrames) *
+                     bytesPerFrame;
+        }
+    } else {
+        a.len = file.read(a.pcm, len);
+        a.len -= a.len % bytesPerFrame;
+        a.fileBytes += a.len;
+    }
+    a.info = info;
+    a.convert = pcmConverterFor(info);
+    a.path = src.uri;
+    a.file = src.file;
+    a.startMs = startMs;
+    file.close();
+
+    Serial.printf("[AUDIO] Attack cache slot %d: %s from %ums (%u bytes)\n", slot, src.uri.c_str(),
+                  (unsigned)startMs, (unsigned)a.len);
+    return true;
+}
+
+void AudioPlayer::clearAttackCache() {
+    stop();  // Callback may be reading a slot
+    waitForCallback(100);
+    for (int slot = 0; slot < AUDIO_ATTACK_SLOTS; slot++) {
+        if (attackSlots[slot].pcm) free(attackSlots[slot].pcm);
+        attackSlots[slot].pcm = nullptr;
+        attackSlots[slot].len = 0;
+        attackSlots[slot].path = "";
+    }
+}
+
 void AudioPlayer::checkAndReconnectWiFi() {
     // WiFi modem sleep stays enabled permanently for BT coexistence
     // No action needed - just clear the flag
@@ -233,231 +1587,326 @@ void AudioPlayer::checkAndReconnectWiFi() {
     }
 }
 
-int32_t AudioPlayer::audioCallback(Frame *data, int32_t frameCount) {
-    // Minimal debug output to save memory
-    static bool firstCall = true;
-    if (firstCall) {
-        Serial.println("[AUDIO] Callback started");
-        firstCall = false;
+// Pull up to maxFrames file-rate frames from the attack cache or the ring
+// and unpack them to interleaved stereo int16
+int AudioPlayer::readVoiceFrames(Voice& v, int16_t* out, int maxFrames) {
+    int bytesPerFrame = v.frameBytes;
+    int framesGot;
+    const uint8_t* src;
+
+    uint32_t readStart = PROFILER_CYCLES();
+    if (v.attackPos < v.attackLen) {
+        // Cached attack / mapped clip: read straight from RAM. A loop that
+        // ends in there goes round in RAM, sample exact and with no I/O.
+        uint32_t end = v.attackLen;
+        uint32_t loopEnd = v.regionEnd * bytesPerFrame;
+        bool ramLoop = v.looping && loopEnd <= end;
+        if (ramLoop) end = loopEnd;
+        framesGot = min(maxFrames, (int)((end - v.attackPos) / bytesPerFrame));
+        src = v.attackData + v.attackPos;
+        v.attackPos += framesGot * bytesPerFrame;
+        if (ramLoop && v.attackPos == loopEnd) v.attackPos = v.regionStart * bytesPerFrame;
+    } else {
+        framesGot = v.ring.read(audioBuf, maxFrames * bytesPerFrame) / bytesPerFrame;
+        src = audioBuf;
     }
+    cbReadCycles += PROFILER_CYCLES() - readStart;
+    v.bytesRead += framesGot * bytesPerFrame;
 
-    // Check if we're playing test tone
-    if (playingTestTone && testToneRemaining > 0) {
-        for (int i = 0; i < frameCount; i++) {
-            if (testToneRemaining <= 0) {
-                data[i].channel1 = 0;
-                data[i].channel2 = 0;
-                continue;
-            }
+    // Converter was picked at playFile time - no per-frame format branches
+    v.convert(src, out, framesGot, v.dither);
 
-            // Generate sine wave
-            float sample = sin(testTonePhase) * 16000.0;  // Amplitude
-            testTonePhase += 2.0 * M_PI * testToneFreq / 44100.0;
+    return framesGot;
+}
 
-            int16_t sampleValue = (int16_t)sample;
-            data[i].channel1 = sampleValue;
-            data[i].channel2 = sampleValue;
+// Render up to frameCount frames of one voice into the mix bus.
+// Returns the number of frames that carried audio.
+int AudioPlayer::renderVoice(Voice& v, int32_t* acc, int frameCount) {
+    // Drop data left over from a previous file
+    if (v.flushPending) {
+        v.ring.discardUntil(v.flushIndex);
+        v.flushPending = false;
+    }
 
-            testToneRemaining--;
+    // Silence padding after the file to prevent a click, then go idle
+    if (v.state == VOICE_TAIL) {
+        cbPaddingFrames += min(v.tailFramesLeft, (uint32_t)frameCount);
+        if (v.tailFramesLeft <= (uint32_t)frameCount) {
+            v.state = VOICE_IDLE;
+            needsWiFiReconnect = true;
+        } else {
+            v.tailFramesLeft -= frameCount;
         }
-        return frameCount;
+        return 0;
     }
 
-    // Check if we have a file to play
-    if (!playing) {
-        // Not playing - return silence
-        for (int i = 0; i < frameCount; i++) {
-            data[i].channel1 = 0;
-            data[i].channel2 = 0;
+    // Audio comes from the prefetch ring - no SD access in this callback
+    int framesGot;
+    if (v.rs.isBypass()) {
+        // Reads stop short where the attack hands over to the ring and at
+        // a loop end in RAM, so keep going until the block is full
+        framesGot = 0;
+        while (framesGot < frameCount) {
+            int n = readVoiceFrames(v, voiceBuf + framesGot * 2, frameCount - framesGot);
+            if (n == 0) break;
+            framesGot += n;
+        }
+    } else {
+        // Feed the resampler file-rate frames until it has produced a block
+        framesGot = 0;
+        while (true) {
+            framesGot += v.rs.pull(voiceBuf + framesGot * 2, frameCount - framesGot);
+            if (framesGot == frameCount) break;
+            int n = readVoiceFrames(v, convBuf, min(v.rs.space(), MIX_BLOCK_FRAMES));
+            if (n == 0) break;
+            v.rs.push(convBuf, n);
         }
-        return frameCount;
     }
 
-    // Handle WAV playback
-    if (!currentFile && !inSilencePadding) {
-        // No file and not padding - return silence
-        for (int i = 0; i < frameCount; i++) {
-            data[i].channel1 = 0;
-            data[i].channel2 = 0;
+    // Fades: split the block where the fade-out begins, so it starts on
+    // exactly the same frame no matter how the callback chunks the stream
+    int head = framesGot;
+    if (!v.inFadeOut && v.framesPlayed + framesGot > v.fadeOutFrame) {
+        head = v.fadeOutFrame > v.framesPlayed ? v.fadeOutFrame - v.framesPlayed : 0;
+    }
+    v.env.apply(voiceBuf, head);
+    if (head < framesGot) {
+        v.inFadeOut = true;
+        v.env.setShape(AudioEnvelope::SHAPE_LINEAR);  // End of the clip, nothing fades in
+        v.env.rampTo(0, v.totalFrames - v.fadeOutFrame);
+        v.env.apply(voiceBuf + head * 2, framesGot - head);
+    }
+    if (v.triggerUs && framesGot > 0) {
+        // Latency stages seen from the callback: first clip data out, then
+        // the end of the fade-in ramp
+        uint32_t us = (uint32_t)esp_timer_get_time() - v.triggerUs;
+        if (!v.firstFrameOut) {
+            latencyRecord(LATENCY_FIRST_FRAME, us);
+            v.firstFrameOut = true;
+        }
+        if (v.framesPlayed + framesGot >= v.fadeInFrames) {
+            latencyRecord(LATENCY_FADE_IN_DONE, us);
+            v.triggerUs = 0;
         }
-        return frameCount;
     }
+    v.framesPlayed += framesGot;
 
-    // If in silence padding mode, play silence to prevent click
-    if (inSilencePadding) {
-        // Check if padding is complete
-        if ((millis() - silencePaddingStart) >= SILENCE_PADDING_MS) {
-            Serial.println("[AUDIO CB] Silence padding complete - stopping");
-            playing = false;
-            inSilencePadding = false;
-            silencePaddingStart = 0;
-            needsWiFiReconnect = true;
-        }
+    mixAccumulate(acc, voiceBuf, v.gain, framesGot * 2);
 
-        // Send silence
-        for (int i = 0; i < frameCount; i++) {
-            data[i].channel1 = 0;
-            data[i].channel2 = 0;
-        }
-        return frameCount;
+    // Cut with a fade (retrigger crossfade, bed stop): done once it has run
+    if (v.releasing && v.framesPlayed - v.fadeOutFrame >= v.totalFrames - v.fadeOutFrame) {
+        v.releaseStream = true;  // Before the state: the loop may set the voice up again once idle
+        v.state = VOICE_IDLE;
+        return framesGot;
     }
 
-    // Read audio data from file (optimized: 2KB buffer for smooth playback)
-    // Using extern static buffers defined at file scope
-    int bytesPerFrame = isMono ? 2 : 4;  // Mono=2 bytes, Stereo=4 bytes
+    if (framesGot < frameCount) {
+        bool attackDone = v.attackPos >= v.attackLen;
+        if (attackDone && v.streamEof && v.ring.available() < v.frameBytes && v.next >= 0) {
+            // Sequence: the next item was primed while this one played and
+            // carries on from this very frame, no padding and no fades
+            Voice& n = voices[v.next];
+            v.next = -1;
+            v.state = VOICE_IDLE;
+            n.state = VOICE_PLAYING;
+            framesGot += renderVoice(n, acc + framesGot * 2, frameCount - framesGot);
+        } else if (attackDone && v.streamEof && v.ring.available() < v.frameBytes) {
+            // End of file - start silence padding
+            v.state = VOICE_TAIL;
+        } else if (attackDone) {
+            // Ring ran dry before the stream task could catch up
+            streamUnderruns++;
+            streamUnderrunFrames += frameCount - framesGot;
+            profilerUnderrun(&v == &bed ? PROFILER_VOICE_BED : &v - voices, v.buttonId,
+                             frameCount - framesGot, v.ring.available());
+        }
+    }
 
-    // Check if we should start fade-out (near end of file)
-    if (!inFadeOut && currentFile.available() > 0) {
-        int bytesLeft = currentFile.available();
-        int bytesForFadeOut = (FADEOUT_MS * 44100 * bytesPerFrame) / 1000;  // Bytes needed for 50ms
+    return framesGot;
+}
 
-        if (bytesLeft <= bytesForFadeOut && bytesLeft > 0) {
-            inFadeOut = true;
-            fadeOutStart = millis();
-            Serial.printf("[AUDIO CB] Starting fade-out, %d bytes left\n", bytesLeft);
+// Bed under the jingles. The jingle mix already in acc is the sidechain:
+// each DUCK_BLOCK_FRAMES its peak sets a target gain (full duck from
+// DUCK_THRESHOLD up), the gain follows that target with the attack or
+// release coefficient and is ramped linearly across the step.
+void AudioPlayer::mixBed(int32_t* acc, int frameCount) {
+    mixClear(bedBus, frameCount * 2);
+    renderVoice(bed, bedBus, frameCount);
+
+    int32_t depth = duckDepth;
+    for (int i = 0; i < frameCount; i += DUCK_BLOCK_FRAMES) {
+        int n = min(DUCK_BLOCK_FRAMES, frameCount - i);
+        int32_t* a = acc + i * 2;
+        const int32_t* b = bedBus + i * 2;
+
+        int32_t peak = 0;
+        for (int k = 0; k < n * 2; k++) {
+            int32_t s = a[k] < 0 ? -a[k] : a[k];
+            if (s > peak) peak = s;
+        }
+        if (peak > DUCK_THRESHOLD) peak = DUCK_THRESHOLD;
+
+        int32_t target = (MIX_UNITY_GAIN - depth * peak / DUCK_THRESHOLD) << 8;
+        int32_t coef = target < duckGain ? duckAttackCoef : duckReleaseCoef;
+        int32_t g = duckGain >> 8;
+        duckGain += (int32_t)(((int64_t)(target - duckGain) * coef) >> 16);
+        int32_t step = ((duckGain >> 8) - g) / n;
+
+        for (int k = 0; k < n; k++) {
+            g += step;
+            a[k * 2] += (b[k * 2] * g) >> 15;
+            a[k * 2 + 1] += (b[k * 2 + 1] * g) >> 15;
         }
     }
+}
 
-    for (int i = 0; i < frameCount; i++) {
-        // Refill buffer if needed
-        if (audioBufPos + bytesPerFrame > audioBufLen) {
-            // Save remaining bytes at the end of buffer
-            int remaining = audioBufLen - audioBufPos;
-            if (remaining > 0) {
-                // Move remaining bytes to beginning of buffer
-                for (int j = 0; j < remaining; j++) {
-                    audioBuf[j] = audioBuf[audioBufPos + j];
-                }
-            }
+// A2DP data callback. The stack's Frame is {int16 ch1, int16 ch2}, which
+// is exactly interleaved stereo, so it goes straight to the engine.
+int32_t AudioPlayer::audioCallback(Frame *data, int32_t frameCount) {
+    return render((int16_t*)data, frameCount);
+}
 
-            // Check if file has data available before reading
-            int available = currentFile.available();
+int32_t AudioPlayer::render(int16_t* out, int32_t frameCount) {
+    // Minimal debug output to save memory
+    static bool firstCall = true;
+    if (firstCall) {
+        ALOG_INFO(LOG_CALLBACK_STARTED, nullptr);
+        firstCall = false;
+    }
 
-            // Read next block from SD to fill the rest of the buffer
-            int newBytes = 0;
-            if (available > 0) {
-                newBytes = currentFile.read(audioBuf + remaining, 2048 - remaining);
-            }
-            audioBufLen = remaining + newBytes;
-            audioBufPos = 0;
-
-            if (audioBufLen == 0 || newBytes == 0) {
-                // End of file - start silence padding
-                if (playing && !inSilencePadding) {
-                    Serial.println("[AUDIO CB] End of file reached - starting silence padding");
-                    silencePaddingStart = millis();
-                    inSilencePadding = true;
-                    currentFile.close();
-                }
+    // Apply queued loop commands before touching any voice
+    AudioCommand cmd;
+    while (commandQueue.pop(cmd)) applyCommand(cmd);
+    publishSnapshot();
 
-                // Silence during this frame (sine wave starts next callback)
-                data[i].channel1 = 0;
-                data[i].channel2 = 0;
+    // Check if we're playing test tone
+    if (playingTestTone && testToneRemaining > 0) {
+        for (int i = 0; i < frameCount; i++) {
+            if (testToneRemaining <= 0) {
+                out[i * 2] = 0;
+                out[i * 2 + 1] = 0;
                 continue;
             }
-        }
 
-        // Read from buffer (handle both mono and stereo)
-        if (audioBufPos + bytesPerFrame <= audioBufLen) {
-            int16_t left, right;
+            // Generate sine wave
+            float sample = sin(testTonePhase) * 16000.0;  // Amplitude
+            testTonePhase += 2.0 * M_PI * testToneFreq / 44100.0;
 
-            if (isMono) {
-                // Mono: read 2 bytes and duplicate to both channels
-                int16_t sample = audioBuf[audioBufPos] | (audioBuf[audioBufPos + 1] << 8);
-                left = right = sample;
-                audioBufPos += 2;
-                bytesRead += 2;
-            } else {
-                // Stereo: read 4 bytes (left and right)
-                left = audioBuf[audioBufPos] | (audioBuf[audioBufPos + 1] << 8);
-                right = audioBuf[audioBufPos + 2] | (audioBuf[audioBufPos + 3] << 8);
-                audioBufPos += 4;
-                bytesRead += 4;
-            }
+            int16_t sampleValue = (int16_t)sample;
+            out[i * 2] = sampleValue;
+            out[i * 2 + 1] = sampleValue;
 
-            // Apply fade-in at start of file to prevent click
-            if (inFadeIn) {
-                unsigned long fadeElapsed = millis() - fadeInStart;
-                if (fadeElapsed >= FADEIN_MS) {
-                    inFadeIn = false;  // Fade-in complete
-                } else {
-                    float fadeFactor = (float)fadeElapsed / (float)FADEIN_MS;
-                    fadeFactor = max(0.0f, min(1.0f, fadeFactor));  // Clamp 0-1
-
-                    left = (int16_t)((float)left * fadeFactor);
-                    right = (int16_t)((float)right * fadeFactor);
-                }
-            }
+            testToneRemaining--;
+        }
+        return frameCount;
+    }
 
-            // Apply fade-out if we're near end of file
-            if (inFadeOut) {
-                unsigned long fadeElapsed = millis() - fadeOutStart;
-                float fadeFactor = 1.0f - ((float)fadeElapsed / (float)FADEOUT_MS);
-                fadeFactor = max(0.0f, min(1.0f, fadeFactor));  // Clamp 0-1
+    uint32_t startCycles = PROFILER_CYCLES();
+    int mixed = 0;
 
-                left = (int16_t)((float)left * fadeFactor);
-                right = (int16_t)((float)right * fadeFactor);
-            }
+    for (int done = 0; done < frameCount; ) {
+        int block = min((int)(frameCount - done), MIX_BLOCK_FRAMES);
 
-            data[i].channel1 = left;
-            data[i].channel2 = right;
-        } else {
-            data[i].channel1 = 0;
-            data[i].channel2 = 0;
+        // Voices sounding at the start of the block: a sequence item started
+        // part-way through it has been rendered by the voice before
+        uint32_t active = 0;
+        for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+            if (voices[i].state != VOICE_IDLE) active |= 1u << i;
         }
-    }
 
-    return frameCount;
-}
+        mixClear(mixBus, block * 2);
+        mixed = 0;
+        for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+            if (!(active & (1u << i))) continue;
+            renderVoice(voices[i], mixBus, block);
+            mixed++;
+        }
+        if (bed.state != VOICE_IDLE) {
+            uint32_t bedStart = PROFILER_CYCLES();
+            mixBed(mixBus, block);
+            cbBedCycles += PROFILER_CYCLES() - bedStart;
+            cbBedFrames += block;
+        }
+        mixToInt16(mixBus, out + done * 2, block * 2);
 
-bool AudioPlayer::validateWAVHeader(File& file) {
-    if (file.size() < 44) {
-        return false;
+        done += block;
     }
 
-    char header[44];
-    file.read((uint8_t*)header, 44);
-
-    // Check RIFF header
-    if (header[0] != 'R' || header[1] != 'I' || header[2] != 'F' || header[3] != 'F') {
-        return false;
+    // Headroom + cost bookkeeping
+    for (int i = 0; i < AUDIO_VOICE_SLOTS; i++) {
+        Voice& v = voices[i];
+        if (v.state != VOICE_PLAYING || v.streamEof) continue;
+        uint32_t fill = v.ring.available();
+        if (fill < streamMinFill) streamMinFill = fill;
     }
 
-    // Check WAVE format
-    if (header[8] != 'W' || header[9] != 'A' || header[10] != 'V' || header[11] != 'E') {
-        return false;
-    }
+    publishSnapshot();
+
+    mixActiveVoices = mixed;
+    uint32_t cycles = PROFILER_CYCLES() - startCycles;
+    uint32_t perFrame = cycles / frameCount;
+    uint32_t& avg = mixCyclesPerFrame[min(mixed, AUDIO_MAX_VOICES)];
+    avg = avg ? avg - (avg >> 4) + (perFrame >> 4) : perFrame;
 
-    // Check audio format (PCM = 1)
-    uint16_t audioFormat = header[20] | (header[21] << 8);
-    if (audioFormat != 1) {
-        Serial.println("Non-PCM format not supported");
+    profilerCallback(frameCount, cycles, cbReadCycles, cbPaddingFrames, cbBedCycles, cbBedFrames);
+    cbReadCycles = 0;
+    cbPaddingFrames = 0;
+    cbBedCycles = 0;
+    cbBedFrames = 0;
+
+    // Wake the stream task as soon as any voice has a chunk's worth of space
+    if (mixed > 0 || bed.state != VOICE_IDLE) xTaskNotifyGive(streamTaskHandle);
+
+    return frameCount;
+}
+
+bool AudioPlayer::validateWAVHeader(File& file, const String& filepath, WavInfo& info) {
+    // Catalog hit: header was parsed at upload/verify time, trusted as long
+    // as the file was not replaced behind our back
+    JingleCatalog::Entry entry;
+    if (catalog && catalog->lookup(filepath, entry) && entry.fileSize == file.size() &&
+        entry.info.format != 0) {
+        info = entry.info;
+        file.seek(info.dataOffset);
+    } else if (filepath.indexOf(JPACK_SEPARATOR) >= 0) {
+        // Pack entry not (yet) in the catalog - read the table of contents
+        String name = filepath.substring(filepath.indexOf(JPACK_SEPARATOR) + 1);
+        if (!packFindEntry(file, name, info)) {
+            ALOG_ERROR(LOG_WAV_PACK_ENTRY, filepath.c_str());
+            return false;
+        }
+    } else if (!wavReadInfo(file, info)) {
+        ALOG_ERROR(LOG_WAV_NOT_RIFF, nullptr);
         return false;
     }
 
     // Check number of channels (1=mono, 2=stereo)
-    uint16_t numChannels = header[22] | (header[23] << 8);
-    if (numChannels != 1 && numChannels != 2) {
-        Serial.printf("Channel count %d not supported (need 1 or 2)\n", numChannels);
+    if (info.channels != 1 && info.channels != 2) {
+        ALOG_ERROR(LOG_WAV_CHANNELS, nullptr, info.channels);
         return false;
     }
-    isMono = (numChannels == 1);
 
-    // Check sample rate (44.1kHz)
-    uint32_t sampleRate = header[24] | (header[25] << 8) | (header[26] << 16) | (header[27] << 24);
-    if (sampleRate != 44100) {
-        Serial.printf("Sample rate %d not supported (need 44100)\n", sampleRate);
+    // Check sample format (8/16/24/32-bit PCM, 32-bit float or IMA-ADPCM)
+    if (info.format == WAV_FORMAT_IMA_ADPCM) {
+        if (info.bitsPerSample != 4 || info.frames == 0) {
+            ALOG_ERROR(LOG_WAV_ADPCM_HEADER, nullptr);
+            return false;
+        }
+    } else if (!pcmSelectConverter(info.format, info.bitsPerSample, info.channels)) {
+        ALOG_ERROR(LOG_WAV_FORMAT, nullptr, info.format, info.bitsPerSample);
+        return false;
+    } else if (info.blockAlign != info.channels * info.bitsPerSample / 8) {
+        ALOG_ERROR(LOG_WAV_BLOCK_ALIGN, nullptr, info.blockAlign);
         return false;
     }
 
-    // Check bits per sample (16-bit)
-    uint16_t bitsPerSample = header[34] | (header[35] << 8);
-    if (bitsPerSample != 16) {
-        Serial.printf("Bit depth %d not supported (need 16)\n", bitsPerSample);
+    // Check sample rate (anything the resampler can bring to 44.1kHz)
+    if (!Resampler::supports(info.sampleRate)) {
+        ALOG_ERROR(LOG_WAV_RATE, nullptr, (int32_t)info.sampleRate);
         return false;
     }
 
-    Serial.printf("WAV header validated: %s, 44.1kHz, 16-bit\n", isMono ? "Mono" : "Stereo");
+    ALOG_DEBUG(LOG_WAV_VALID, nullptr, info.channels, (int32_t)info.sampleRate, info.bitsPerSample, info.format);
     return true;
 }
 
@@ -713,8 +2162,17 @@ bool AudioPlayer::pairDevice(const String& deviceName, int timeoutSeconds) {
     return true;
 }
 
-// Test sound - not available in Settings Mode (no A2DP initialized)
+// Test sound: one second of 1kHz from the callback, in place of the mix.
+// The callback owns the tone state, so it is started through the command
+// queue. Not available in Settings Mode (no A2DP initialized)
 bool AudioPlayer::playTestSound() {
-    Serial.println("[TEST SOUND] Not available in Settings Mode");
-    return false;
+    if (!a2dp_source.is_connected()) {
+        Serial.println("[TEST SOUND] Not available in Settings Mode");
+        return false;
+    }
+    if (!sendCommand(AUDIO_CMD_TEST_TONE, -1)) {
+        ALOG_ERROR(LOG_PLAY_QUEUE_FULL, nullptr, AUDIO_CMD_TEST_TONE, -1);
+        return false;
+    }
+    return true;
 }
@@ -0,0 +1,102 @@
+#include "audio_profiler.h"
+#include <esp_attr.h>
+#include <algorithm>
+
+#define PROFILER_MAGIC 0x50524F32  // "PRO2"
+
+struct ProfilerStore {
+    uint32_t magic;
+    uint32_t calls;
+    uint64_t framesRequested;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+    uint64_t readCycles;
+    uint32_t underruns;
+    uint64_t underrunFrames;
+    uint64_t paddingFrames;
+    uint64_t bedCycles;
+    uint64_t bedFrames;
+    ProfilerEvent events[PROFILER_EVENTS];  // Worst underruns so far, unordered
+    uint32_t eventCount;
+};
+
+// Not cleared by a software reset (cleared on power-up via the magic)
+static RTC_NOINIT_ATTR ProfilerStore prof;
+
+void profilerBegin() {
+    if (prof.magic != PROFILER_MAGIC) profilerReset();
+}
+
+void profilerReset() {
+    memset(&prof, 0, sizeof(prof));
+    prof.minCycles = UINT32_MAX;
+    prof.magic = PROFILER_MAGIC;
+}
+
+#if AUDIO_PROFILER
+void profilerCallback(uint32_t frames, uint32_t cycles, uint32_t readCycles, uint32_t paddingFrames,
+                      uint32_t bedCycles, uint32_t bedFrames) {
+    prof.calls++;
+    prof.framesRequested += frames;
+    prof.totalCycles += cycles;
+    prof.readCycles += readCycles;
+    prof.paddingFrames += paddingFrames;
+    prof.bedCycles += bedCycles;
+    prof.bedFrames += bedFrames;
+    if (cycles < prof.minCycles) prof.minCycles = cycles;
+    if (cycles > prof.maxCycles) prof.maxCycles = cycles;
+}
+
+void profilerUnderrun(uint8_t voice, int buttonId, uint32_t frames, uint32_t ringFill) {
+    prof.underruns++;
+    prof.underrunFrames += frames;
+
+    // Keep the worst ones: append while there is room, then replace the
+    // mildest entry if this one zero-filled more
+    uint16_t clipped = frames > 0xFFFF ? 0xFFFF : frames;
+    uint32_t slot = prof.eventCount;
+    if (slot >= PROFILER_EVENTS) {
+        slot = 0;
+        for (uint32_t i = 1; i < PROFILER_EVENTS; i++) {
+            if (prof.events[i].frames < prof.events[slot].frames) slot = i;
+        }
+        if (prof.events[slot].frames >= clipped) return;
+    } else {
+        prof.eventCount++;
+    }
+
+    ProfilerEvent& e = prof.events[slot];
+    e.timeMs = millis();
+    e.voice = voice;
+    e.buttonId = buttonId;
+    e.frames = clipped;
+    e.ringFill = ringFill;
+}
+#endif
+
+void profilerSnapshot(ProfilerStats& out) {
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    memset(&out, 0, sizeof(out));
+
+    out.calls = prof.calls;
+    out.framesRequested = prof.framesRequested;
+    if (prof.calls) {
+        out.minUs = prof.minCycles / mhz;
+        out.maxUs = prof.maxCycles / mhz;
+        out.avgUs = prof.totalCycles / prof.calls / mhz;
+    }
+    out.readUs = prof.readCycles / mhz;
+    out.processUs = (prof.totalCycles - prof.readCycles) / mhz;
+    out.underruns = prof.underruns;
+    out.underrunFrames = prof.underrunFrames;
+    out.paddingFrames = prof.paddingFrames;
+    out.bedUs = prof.bedCycles / mhz;
+    if (prof.bedFrames) out.bedCyclesPerFrame = prof.bedCycles / prof.bedFrames;
+
+    // Worst first
+    out.eventCount = min(prof.eventCount, (uint32_t)PROFILER_EVENTS);
+    memcpy(out.events, prof.events, out.eventCount * sizeof(ProfilerEvent));
+    std::sort(out.events, out.events + out.eventCount,
+              [](const ProfilerEvent& a, const ProfilerEvent& b) { return a.frames > b.frames; });
+}
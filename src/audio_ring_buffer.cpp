@@ -0,0 +1,87 @@
+#include "audio_ring_buffer.h"
+
+AudioRingBuffer::AudioRingBuffer() : buf(nullptr), size(0), mask(0), head(0), tail(0) {
+}
+
+AudioRingBuffer::~AudioRingBuffer() {
+    release();
+}
+
+bool AudioRingBuffer::allocate(size_t bytes) {
+    release();
+
+    // Power-of-two size so wrap-around is a mask instead of a modulo
+    size_t rounded = 1024;
+    while (rounded < bytes) rounded <<= 1;
+
+    buf = (uint8_t*)malloc(rounded);
+    if (!buf) {
+        Serial.printf("[RING] Failed to allocate %u bytes\n", (unsigned)rounded);
+        return false;
+    }
+
+    size = rounded;
+    mask = rounded - 1;
+    head.store(0);
+    tail.store(0);
+    return true;
+}
+
+void AudioRingBuffer::release() {
+    if (buf) free(buf);
+    buf = nullptr;
+    size = 0;
+    mask = 0;
+    head.store(0);
+    tail.store(0);
+}
+
+size_t AudioRingBuffer::available() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+}
+
+size_t AudioRingBuffer::freeSpace() const {
+    return size - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire));
+}
+
+size_t AudioRingBuffer::write(const uint8_t* src, size_t len) {
+    len = min(len, freeSpace());
+    uint32_t h = head.load(std::memory_order_relaxed);
+    size_t offset = h & mask;
+    size_t first = min(len, size - offset);
+    memcpy(buf + offset, src, first);
+    memcpy(buf, src + first, len - first);
+    head.store(h + len, std::memory_order_release);
+    return len;
+}
+
+size_t AudioRingBuffer::writeRegion(uint8_t** ptr) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    size_t offset = h & mask;
+    *ptr = buf + offset;
+    return min(freeSpace(), size - offset);
+}
+
+void AudioRingBuffer::commitWrite(size_t len) {
+    head.store(head.load(std::memory_order_relaxed) + len, std::memory_order_release);
+}
+
+size_t AudioRingBuffer::read(uint8_t* dst, size_t len) {
+    len = min(len, available());
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    size_t offset = t & mask;
+    size_t first = min(len, size - offset);
+    memcpy(dst, buf + offset, first);
+    memcpy(dst + first, buf, len - first);
+    tail.store(t + len, std::memory_order_release);
+    return len;
+}
+
+void AudioRingBuffer::skip(size_t len) {
+    len = min(len, available());
+    tail.store(tail.load(std::memory_order_relaxed) + len, std::memory_order_release);
+}
+
+void AudioRingBuffer::discardUntil(uint32_t index) {
+    tail.store(index, std::memory_order_release);
+}
@@ -0,0 +1,20 @@
+#include "audio_source.h"
+#include "jingle_pack.h"
+
+AudioSource parseAudioSource(const String& uri) {
+    AudioSource src;
+    src.uri = uri;
+    if (uri.startsWith("flash:")) {
+        src.type = SOURCE_FLASH;
+        src.path = uri.substring(6);
+    } else if (uri.startsWith("sd:")) {
+        src.type = SOURCE_SD;
+        src.path = uri.substring(3);
+    } else {
+        src.type = SOURCE_SD;
+        src.path = uri;
+    }
+    int sep = src.path.indexOf(JPACK_SEPARATOR);
+    src.file = (src.type == SOURCE_SD && sep >= 0) ? src.path.substring(0, sep) : src.path;
+    return src;
+}
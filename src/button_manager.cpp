@@ -62,6 +62,7 @@ void ButtonManager::loadConfig(const JsonDocument& config) {
         buttons[idx].filepath = btn["file"].as<const char*>();
         buttons[idx].color = colorStringToRGB565(String(btn["color"].as<const char*>()));
         buttons[idx].textColor = colorStringToRGB565(String(btn["textColor"].as<const char*>()));
+        buttons[idx].latched = false;
         idx++;
     }
 
@@ -131,7 +132,7 @@ void ButtonManager::drawButtonBorder(const Point& topLeft, int width, int height
 
 void ButtonManager::drawButton(int id, bool highlighted) {
     Button& btn = buttons[id];
-    DrawColors colors = getDrawColors(btn, highlighted);
+    DrawColors colors = getDrawColors(btn, highlighted || btn.latched);
     Point topLeft = centerToTopLeft(btn);
 
     // Draw button background
@@ -198,7 +199,10 @@ int ButtonManager::checkTouch() {
     int x = map(p.x, TOUCH_X_MIN, TOUCH_X_MAX, 0, SCREEN_WIDTH);
     int y = map(p.y, TOUCH_Y_MIN, TOUCH_Y_MAX, 0, SCREEN_HEIGHT);
 
-    // Check which button was pressed
+    return buttonAt(x, y);
+}
+
+int ButtonManager::buttonAt(int x, int y) const {
     for (int i = 0; i < MAX_BUTTONS; i++) {
         ButtonBounds bounds = getButtonBounds(buttons[i]);
         if (isPointInBounds(x, y, bounds)) {
@@ -249,6 +253,21 @@ void ButtonManager::highlightButton(int id) {
     drawButton(id, false);
 }
 
+void ButtonManager::setHighlight(int id, bool on) {
+    if (!isValidButtonId(id)) return;
+    drawButton(id, on);
+}
+
+void ButtonManager::setLatched(int id, bool on) {
+    if (!isValidButtonId(id) || buttons[id].latched == on) return;
+    buttons[id].latched = on;
+    drawButton(id, false);
+}
+
+bool ButtonManager::isLatched(int id) const {
+    return isValidButtonId(id) && buttons[id].latched;
+}
+
 String ButtonManager::getButtonFile(int id) {
     if (!isValidButtonId(id)) return "";
     return buttons[id].filepath;
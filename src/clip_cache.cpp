@@ -0,0 +1,140 @@
+#include "clip_cache.h"
+#include <esp_heap_caps.h>
+
+ClipCache::ClipCache()
+    : budget(0), used(0), usePsram(false), useCounter(0), hits(0), misses(0), evictions(0), inUse(nullptr) {
+    for (int i = 0; i < AUDIO_CLIP_CACHE_SLOTS; i++) {
+        clips[i].data = nullptr;
+        clips[i].len = 0;
+        clips[i].startMs = clips[i].endMs = 0;
+        clips[i].complete = false;
+    }
+}
+
+void ClipCache::begin(size_t budgetBytes, InUseFn inUseFn) {
+    clear();
+    inUse = inUseFn;
+    usePsram = psramFound();
+    if (budgetBytes == 0) {
+        budgetBytes = usePsram ? AUDIO_CLIP_CACHE_PSRAM_BYTES : AUDIO_CLIP_CACHE_INTERNAL_BYTES;
+    }
+    budget = budgetBytes;
+    Serial.printf("[CACHE] Clip cache: %u KB in %s\n", (unsigned)(budget / 1024),
+                  usePsram ? "PSRAM" : "internal RAM");
+}
+
+bool ClipCache::matches(const Clip& clip, const String& path, uint32_t startMs, uint32_t endMs) {
+    return clip.data && clip.startMs == startMs && clip.endMs == endMs && clip.path == path;
+}
+
+const ClipCache::Clip* ClipCache::lookup(const String& path, uint32_t startMs, uint32_t endMs) {
+    for (int i = 0; i < AUDIO_CLIP_CACHE_SLOTS; i++) {
+        Clip& c = clips[i];
+        if (c.complete && matches(c, path, startMs, endMs)) {
+            c.lastUse = ++useCounter;
+            hits++;
+            return &c;
+        }
+    }
+    misses++;
+    return nullptr;
+}
+
+bool ClipCache::contains(const String& path, uint32_t startMs, uint32_t endMs) const {
+    for (int i = 0; i < AUDIO_CLIP_CACHE_SLOTS; i++) {
+        if (clips[i].complete && matches(clips[i], path, startMs, endMs)) return true;
+    }
+    return false;
+}
+
+ClipCache::Clip* ClipCache::reserve(const String& path, uint32_t startMs, uint32_t endMs, uint32_t len,
+                                    const WavInfo& info, PcmConvertFn convert, uint16_t frameBytes) {
+    if (len == 0 || len > budget) return nullptr;
+
+    // Another voice may already be filling this clip
+    for (int i = 0; i < AUDIO_CLIP_CACHE_SLOTS; i++) {
+        if (matches(clips[i], path, startMs, endMs)) return nullptr;
+    }
+
+    while (used + len > budget) {
+        if (!evictOne()) return nullptr;
+    }
+
+    Clip* slot = nullptr;
+    for (int i = 0; i < AUDIO_CLIP_CACHE_SLOTS && !slot; i++) {
+        if (!clips[i].data) slot = &clips[i];
+    }
+    if (!slot && evictOne()) {
+        for (int i = 0; i < AUDIO_CLIP_CACHE_SLOTS && !slot; i++) {
+            if (!clips[i].data) slot = &clips[i];
+        }
+    }
+    if (!slot) return nullptr;
+
+    uint32_t caps = usePsram ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    slot->data = (uint8_t*)heap_caps_malloc(len, caps);
+    if (!slot->data) return nullptr;
+
+    slot->path = path;
+    slot->startMs = startMs;
+    slot->endMs = endMs;
+    slot->len = len;
+    slot->info = info;
+    slot->convert = convert;
+    slot->frameBytes = frameBytes;
+    slot->lastUse = ++useCounter;
+    slot->complete = false;
+    used += len;
+    return slot;
+}
+
+void ClipCache::abort(Clip* clip) {
+    if (clip && !clip->complete) release(*clip);
+}
+
+void ClipCache::release(Clip& clip) {
+    if (!clip.data) return;
+    heap_caps_free(clip.data);
+    used -= clip.len;
+    clip.data = nullptr;
+    clip.len = 0;
+    clip.path = "";
+    clip.complete = false;
+}
+
+// Drop the least recently used complete clip nobody is playing
+bool ClipCache::evictOne() {
+    Clip* victim = nullptr;
+    for (int i = 0; i < AUDIO_CLIP_CACHE_SLOTS; i++) {
+        Clip& c = clips[i];
+        if (!c.data || !c.complete) continue;
+        if (inUse && inUse(c.data)) continue;
+        if (!victim || c.lastUse < victim->lastUse) victim = &c;
+    }
+    if (!victim) return false;
+
+    release(*victim);
+    evictions++;
+    return true;
+}
+
+void ClipCache::clear() {
+    for (int i = 0; i < AUDIO_CLIP_CACHE_SLOTS; i++) {
+        release(clips[i]);
+    }
+}
+
+ClipCache::Stats ClipCache::getStats() {
+    Stats stats;
+    stats.budget = budget;
+    stats.used = used;
+    stats.clips = 0;
+    for (int i = 0; i < AUDIO_CLIP_CACHE_SLOTS; i++) {
+        if (clips[i].data && clips[i].complete) stats.clips++;
+    }
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.psram = usePsram;
+    return stats;
+}
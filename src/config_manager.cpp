@@ -1,4 +1,5 @@
 #include "config_manager.h"
+#include "pin_config.h"
 
 ConfigManager::ConfigManager() {
 }
@@ -15,15 +16,24 @@ bool ConfigManager::begin() {
 }
 
 bool ConfigManager::loadConfig() {
-    if (!loadFromNVS()) {
+    if (loadFromNVS()) return true;
+    createDefaultConfig();
+    // Only a first boot stores the defaults. A stored config that can't be
+    // used stays in NVS as it is until the user saves a new one
+    if (!prefs.isKey("config")) {
         Serial.println("Creating default config");
-        createDefaultConfig();
         saveToNVS();
+    } else {
+        Serial.println("Running on default config, stored config kept");
     }
     return true;
 }
 
 bool ConfigManager::saveConfig(const JsonDocument& newConfig) {
+    if (!isValidConfig(newConfig)) {
+        Serial.println("Rejected config: bad structure");
+        return false;
+    }
     config.clear();
     config.set(newConfig);
     return saveToNVS();
@@ -33,6 +43,75 @@ const JsonDocument& ConfigManager::getConfig() {
     return config;
 }
 
+bool ConfigManager::isValidConfig(const JsonDocument& doc) {
+    if (!doc.is<JsonObjectConst>()) return false;
+
+    JsonVariantConst buttons = doc["buttons"];
+    if (buttons.isNull()) return true;
+    if (!buttons.is<JsonArrayConst>() || buttons.size() > 8) return false;
+    for (JsonVariantConst btn : buttons.as<JsonArrayConst>()) {
+        if (!btn.is<JsonObjectConst>()) return false;
+        JsonVariantConst loop = btn["loop"];
+        if (!loop.isNull() && !loop.is<bool>()) {
+            if (!loop.is<JsonArrayConst>() || loop.size() != 2) return false;
+            if (!loop[0].is<uint32_t>() || !loop[1].is<uint32_t>()) return false;
+        }
+        for (const char* key : {"startMs", "endMs"}) {
+            if (!btn[key].isNull() && !btn[key].is<uint32_t>()) return false;
+        }
+        JsonVariantConst gain = btn["gainDb"];
+        if (!gain.isNull() && !(gain.is<float>() && gain.as<float>() >= -24 && gain.as<float>() <= 12)) {
+            return false;
+        }
+        JsonVariantConst then = btn["then"];
+        if (then.isNull()) continue;
+        if (!then.is<JsonArrayConst>() || then.size() >= AUDIO_SEQUENCE_MAX) return false;
+        for (JsonVariantConst file : then.as<JsonArrayConst>()) {
+            if (!file.is<const char*>()) return false;
+        }
+    }
+    return true;
+}
+
+void ConfigManager::repairConfig(JsonDocument& doc) {
+    JsonVariant buttons = doc["buttons"];
+    if (buttons.isNull()) return;
+    if (!buttons.is<JsonArray>()) {
+        doc.remove("buttons");
+        return;
+    }
+    JsonArray list = buttons.as<JsonArray>();
+    for (size_t i = list.size(); i-- > 0;) {
+        if (i >= 8 || !list[i].is<JsonObject>()) list.remove(i);
+    }
+    for (JsonObject btn : list) {
+        JsonVariant loop = btn["loop"];
+        if (!loop.isNull() && !loop.is<bool>() &&
+            !(loop.is<JsonArray>() && loop.size() == 2 && loop[0].is<uint32_t>() && loop[1].is<uint32_t>())) {
+            btn.remove("loop");
+        }
+        for (const char* key : {"startMs", "endMs"}) {
+            if (!btn[key].isNull() && !btn[key].is<uint32_t>()) btn.remove(key);
+        }
+        JsonVariant gain = btn["gainDb"];
+        if (!gain.isNull() && !gain.is<float>()) {
+            btn.remove("gainDb");
+        } else if (!gain.isNull() && !(gain.as<float>() >= -24 && gain.as<float>() <= 12)) {
+            btn["gainDb"] = gain.as<float>() < 0 ? -24 : 12;  // Nearest value in range
+        }
+        JsonVariant then = btn["then"];
+        if (then.isNull()) continue;
+        if (!then.is<JsonArray>()) {
+            btn.remove("then");
+            continue;
+        }
+        JsonArray files = then.as<JsonArray>();
+        for (size_t i = files.size(); i-- > 0;) {
+            if (i >= AUDIO_SEQUENCE_MAX - 1 || !files[i].is<const char*>()) files.remove(i);
+        }
+    }
+}
+
 bool ConfigManager::isSettingsMode() {
     return prefs.getBool("settings_mode", false);
 }
@@ -70,6 +149,69 @@ String ConfigManager::getButtonFile(int id) {
     return "";
 }
 
+int ConfigManager::getButtonSequence(int id, String* files, int maxFiles) {
+    if (id < 0 || id >= 8 || maxFiles <= 0) return 0;
+    JsonArray buttons = config["buttons"].as<JsonArray>();
+    for (JsonObject btn : buttons) {
+        if (btn["id"].as<int>() != id) continue;
+        int count = 0;
+        files[count] = btn["file"].as<String>();
+        if (files[count].length() == 0) return 0;
+        count++;
+        for (JsonVariant file : btn["then"].as<JsonArray>()) {
+            if (count == maxFiles) break;
+            files[count] = file.as<String>();
+            if (files[count].length()) count++;
+        }
+        return count;
+    }
+    return 0;
+}
+
+bool ConfigManager::getButtonLoop(int id, uint32_t& start, uint32_t& end) {
+    start = end = 0;
+    if (id < 0 || id >= 8) return false;
+    JsonArray buttons = config["buttons"].as<JsonArray>();
+    for (JsonObject btn : buttons) {
+        if (btn["id"].as<int>() != id) continue;
+        JsonVariant loop = btn["loop"];
+        if (loop.is<JsonArray>() && loop.size() == 2) {
+            start = loop[0].as<uint32_t>();
+            end = loop[1].as<uint32_t>();
+            if (start >= end) start = end = 0;
+            return true;
+        }
+        return loop.as<bool>();
+    }
+    return false;
+}
+
+bool ConfigManager::getButtonTrim(int id, uint32_t& startMs, uint32_t& endMs) {
+    startMs = endMs = 0;
+    if (id < 0 || id >= 8) return false;
+    JsonArray buttons = config["buttons"].as<JsonArray>();
+    for (JsonObject btn : buttons) {
+        if (btn["id"].as<int>() != id) continue;
+        startMs = btn["startMs"].as<uint32_t>();  // Missing → 0
+        endMs = btn["endMs"].as<uint32_t>();
+        if (endMs && endMs <= startMs) endMs = 0;
+        return startMs || endMs;
+    }
+    return false;
+}
+
+int ConfigManager::getButtonGainDb(int id) {
+    if (id < 0 || id >= 8) return 0;
+    JsonArray buttons = config["buttons"].as<JsonArray>();
+    for (JsonObject btn : buttons) {
+        if (btn["id"].as<int>() == id) {
+            float db = btn["gainDb"].as<float>();  // Missing → 0
+            return (int)lroundf(constrain(db, -24.0f, 12.0f) * 10);
+        }
+    }
+    return 0;
+}
+
 String ConfigManager::getButtonColor(int id) {
     if (id < 0 || id >= 8) return "#000000";
     JsonArray buttons = config["buttons"].as<JsonArray>();
@@ -81,6 +223,29 @@ String ConfigManager::getButtonColor(int id) {
     return "#000000";
 }
 
+String ConfigManager::getButtonMode(int id) {
+    if (id < 0 || id >= 8) return "choke";
+    JsonArray buttons = config["buttons"].as<JsonArray>();
+    for (JsonObject btn : buttons) {
+        if (btn["id"].as<int>() == id) {
+            String mode = btn["mode"].as<String>();
+            return (mode == "restart" || mode == "overlap") ? mode : "choke";
+        }
+    }
+    return "choke";
+}
+
+int ConfigManager::getButtonChokeGroup(int id) {
+    if (id < 0 || id >= 8) return 0;
+    JsonArray buttons = config["buttons"].as<JsonArray>();
+    for (JsonObject btn : buttons) {
+        if (btn["id"].as<int>() == id) {
+            return btn["chokeGroup"].as<int>();  // Missing → 0
+        }
+    }
+    return 0;
+}
+
 String ConfigManager::getBTDeviceName() {
     return config["btDevice"].as<String>();
 }
@@ -99,6 +264,67 @@ int ConfigManager::getTouchThreshold() {
     return (v < 50 || v > 500) ? 200 : v;
 }
 
+int ConfigManager::getResampleQuality() {
+    String q = config["resampleQuality"].as<String>();
+    if (q == "low") return 0;
+    if (q == "high") return 2;
+    return 1;
+}
+
+uint32_t ConfigManager::getClipCacheKB() {
+    return config["clipCacheKB"].as<uint32_t>();
+}
+
+bool ConfigManager::getTriggerOnPress() {
+    return config["triggerOn"].as<String>() == "press";
+}
+
+int ConfigManager::getRetriggerMs() {
+    int v = config["retriggerMs"].as<int>();
+    return (v < 5 || v > 500) ? 40 : v;
+}
+
+int ConfigManager::getCrossfadeMs() {
+    JsonVariantConst v = config["crossfadeMs"];
+    int ms = v.as<int>();
+    return (v.isNull() || ms < 0 || ms > 200) ? 30 : ms;
+}
+
+int ConfigManager::getLoudnessTarget() {
+    JsonVariantConst v = config["loudnessTarget"];
+    if (v.isNull()) return -160;
+    float lufs = v.as<float>();
+    if (lufs == 0) return 0;
+    return (lufs < -40 || lufs > -5) ? -160 : (int)lroundf(lufs * 10);
+}
+
+String ConfigManager::getBedFile() {
+    const char* file = config["bedFile"].as<const char*>();
+    return file ? file : "";
+}
+
+int ConfigManager::getBedLevel() {
+    JsonVariantConst v = config["bedLevel"];
+    int level = v.as<int>();
+    return (v.isNull() || level < 0 || level > 100) ? 40 : level;
+}
+
+int ConfigManager::getDuckDb() {
+    JsonVariantConst v = config["duckDb"];
+    int db = v.as<int>();
+    return (v.isNull() || db < -40 || db > 0) ? -12 : db;
+}
+
+int ConfigManager::getDuckAttackMs() {
+    int v = config["duckAttackMs"].as<int>();
+    return (v < 5 || v > 2000) ? 50 : v;
+}
+
+int ConfigManager::getDuckReleaseMs() {
+    int v = config["duckReleaseMs"].as<int>();
+    return (v < 20 || v > 5000) ? 800 : v;
+}
+
 uint8_t ConfigManager::getBTVolume() {
     return config["btVolume"].as<uint8_t>();
 }
@@ -138,6 +364,10 @@ bool ConfigManager::loadFromNVS() {
         Serial.println("No config in NVS");
         return false;
     }
+    if (jsonStr.length() > CONFIG_MAX_JSON_BYTES) {
+        Serial.println("Config in NVS too large");
+        return false;
+    }
 
     DeserializationError error = deserializeJson(config, jsonStr);
     if (error) {
@@ -145,6 +375,15 @@ bool ConfigManager::loadFromNVS() {
         Serial.println(error.c_str());
         return false;
     }
+    if (!config.is<JsonObject>()) {
+        Serial.println("Config in NVS is not an object");
+        return false;
+    }
+    if (!isValidConfig(config)) {
+        // Drop only the fields that are wrong; NVS keeps the original
+        Serial.println("Config in NVS has bad fields, ignoring them");
+        repairConfig(config);
+    }
 
     Serial.println("Config loaded from NVS");
     return true;
@@ -0,0 +1,107 @@
+#include "flash_jingles.h"
+#include "jingle_pack.h"
+
+#define FLASH_SECTOR_SIZE 4096
+
+FlashJingles::FlashJingles()
+    : part(nullptr), base(nullptr), mapHandle(0), writePos(0), erasedUpTo(0), writeOk(false) {
+}
+
+bool FlashJingles::begin() {
+    part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                    (esp_partition_subtype_t)FLASH_JINGLES_SUBTYPE, FLASH_JINGLES_LABEL);
+    if (!part) {
+        Serial.println("[FLASH] No " FLASH_JINGLES_LABEL " partition");
+        return false;
+    }
+    return map();
+}
+
+size_t FlashJingles::capacity() {
+    return part ? part->size : 0;
+}
+
+bool FlashJingles::map() {
+    const void* ptr = nullptr;
+    if (esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &ptr, &mapHandle) != ESP_OK) {
+        Serial.println("[FLASH] mmap failed");
+        return false;
+    }
+
+    if (!packParseToc((const uint8_t*)ptr, part->size, toc)) {
+        // Erased or foreign data - keep it unmapped so nothing plays from it
+        esp_partition_munmap(mapHandle);
+        toc.clear();
+        Serial.println("[FLASH] Partition holds no jingle pack");
+        return false;
+    }
+
+    base = (const uint8_t*)ptr;
+    Serial.printf("[FLASH] %u jingles mapped\n", (unsigned)toc.size());
+    return true;
+}
+
+void FlashJingles::unmap() {
+    if (base) esp_partition_munmap(mapHandle);
+    base = nullptr;
+    toc.clear();
+}
+
+bool FlashJingles::find(const String& slot, const uint8_t*& data, WavInfo& info) {
+    if (!base) return false;
+
+    // Numeric slot = index into the table of contents
+    bool numeric = slot.length() > 0;
+    for (size_t i = 0; i < slot.length(); i++) {
+        if (!isdigit(slot[i])) numeric = false;
+    }
+
+    for (size_t i = 0; i < toc.size(); i++) {
+        if (numeric ? (size_t)slot.toInt() == i : slot == toc[i].name) {
+            packEntryInfo(toc[i], info);
+            data = base + toc[i].offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FlashJingles::beginWrite() {
+    if (!part) return false;
+    unmap();
+    writePos = 0;
+    erasedUpTo = 0;
+    writeOk = true;
+    return true;
+}
+
+bool FlashJingles::write(const uint8_t* data, size_t len) {
+    if (!part || !writeOk) return false;
+    if (writePos + len > part->size) {
+        Serial.println("[FLASH] Pack larger than partition");
+        writeOk = false;
+        return false;
+    }
+
+    while (erasedUpTo < writePos + len) {
+        if (esp_partition_erase_range(part, erasedUpTo, FLASH_SECTOR_SIZE) != ESP_OK) {
+            writeOk = false;
+            return false;
+        }
+        erasedUpTo += FLASH_SECTOR_SIZE;
+    }
+
+    if (esp_partition_write(part, writePos, data, len) != ESP_OK) {
+        writeOk = false;
+        return false;
+    }
+    writePos += len;
+    return true;
+}
+
+bool FlashJingles::endWrite() {
+    if (!part) return false;
+    bool ok = writeOk && map();
+    Serial.printf("[FLASH] Write %s (%u bytes)\n", ok ? "complete" : "FAILED", (unsigned)writePos);
+    return ok;
+}
@@ -0,0 +1,299 @@
+#include "ima_adpcm.h"
+#include "wav_format.h"
+#include <SD.h>
+
+static const int16_t stepTable[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+
+static const int8_t indexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static inline int32_t clampIndex(int32_t index) {
+    return index < 0 ? 0 : (index > 88 ? 88 : index);
+}
+
+static inline int16_t decodeNibble(int32_t& predictor, int32_t& index, uint8_t nibble) {
+    int32_t step = stepTable[index];
+    int32_t diff = step >> 3;
+    if (nibble & 4) diff += step;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 1) diff += step >> 2;
+    predictor += (nibble & 8) ? -diff : diff;
+    if (predictor > 32767) predictor = 32767;
+    else if (predictor < -32768) predictor = -32768;
+    index = clampIndex(index + indexTable[nibble]);
+    return (int16_t)predictor;
+}
+
+// Exact mirror of decodeNibble so encoder and decoder never drift apart
+static inline uint8_t encodeNibble(int32_t& predictor, int32_t& index, int16_t sample) {
+    int32_t step = stepTable[index];
+    int32_t delta = sample - predictor;
+    uint8_t nibble = 0;
+    if (delta < 0) {
+        nibble = 8;
+        delta = -delta;
+    }
+    if (delta >= step) { nibble |= 4; delta -= step; }
+    if (delta >= (step >> 1)) { nibble |= 2; delta -= step >> 1; }
+    if (delta >= (step >> 2)) { nibble |= 1; }
+    decodeNibble(predictor, index, nibble);
+    return nibble;
+}
+
+// ── Decoder ───────────────────────────────────────────────────────────────────
+
+ImaAdpcmDecoder::ImaAdpcmDecoder() : channels(1), blockAlign(0), blockLeft(0) {
+    ch[0] = ch[1] = {0, 0};
+}
+
+uint32_t ImaAdpcmDecoder::samplesPerBlock(uint16_t channels, uint16_t blockAlign) {
+    if (channels == 0 || blockAlign <= 4 * channels) return 0;
+    // 4-byte header per channel holds the first sample, then 2 samples per byte
+    return (blockAlign - 4 * channels) * 2 / channels + 1;
+}
+
+bool ImaAdpcmDecoder::validBlockAlign(uint16_t channels, uint16_t blockAlign) {
+    if (channels != 1 && channels != 2) return false;
+    uint32_t headerBytes = 4 * channels;
+    return blockAlign >= headerBytes + 4 * channels && (blockAlign - headerBytes) % (4 * channels) == 0;
+}
+
+void ImaAdpcmDecoder::begin(uint16_t channels, uint16_t blockAlign) {
+    this->channels = channels;
+    this->blockAlign = blockAlign;
+    blockLeft = 0;
+    ch[0] = ch[1] = {0, 0};
+}
+
+// Mono data comes a byte (2 frames) at a time; stereo in 8-byte groups
+// (4 bytes = 8 samples of left, then 4 bytes of right)
+size_t ImaAdpcmDecoder::nextReadSize(int maxFrames, size_t maxBytes) const {
+    uint32_t headerBytes = 4 * channels;
+    uint32_t unitBytes = (channels == 1) ? 1 : 8;
+    uint32_t unitFrames = (channels == 1) ? 2 : 8;
+
+    size_t n = 0;
+    int frames = 0;
+    uint32_t left = blockLeft;
+
+    while (true) {
+        if (left == 0) {
+            if (frames + 1 > maxFrames || n + headerBytes > maxBytes) break;
+            n += headerBytes;
+            frames += 1;
+            left = blockAlign - headerBytes;
+            continue;
+        }
+        if (left < unitBytes) {
+            // Stray padding at the end of a block - read and drop it
+            if (n + left > maxBytes) break;
+            n += left;
+            left = 0;
+            continue;
+        }
+        uint32_t units = min(left / unitBytes, (uint32_t)(maxFrames - frames) / unitFrames);
+        units = min(units, (uint32_t)((maxBytes - n) / unitBytes));
+        if (units == 0) break;
+        n += units * unitBytes;
+        frames += units * unitFrames;
+        left -= units * unitBytes;
+    }
+    return n;
+}
+
+int ImaAdpcmDecoder::decode(const uint8_t* src, size_t len, int16_t* out) {
+    uint32_t headerBytes = 4 * channels;
+    uint32_t unitBytes = (channels == 1) ? 1 : 8;
+    int frames = 0;
+
+    while (len > 0) {
+        if (blockLeft == 0) {
+            if (len < headerBytes) break;
+            for (int c = 0; c < channels; c++) {
+                ch[c].predictor = (int16_t)(src[0] | (src[1] << 8));
+                ch[c].index = clampIndex(src[2]);
+                *out++ = (int16_t)ch[c].predictor;
+                src += 4;
+            }
+            len -= headerBytes;
+            blockLeft = blockAlign - headerBytes;
+            frames++;
+            continue;
+        }
+
+        if (blockLeft < unitBytes) {
+            size_t skip = min(len, (size_t)blockLeft);
+            src += skip;
+            len -= skip;
+            blockLeft -= skip;
+            continue;
+        }
+        if (len < unitBytes) break;
+
+        if (channels == 1) {
+            out[0] = decodeNibble(ch[0].predictor, ch[0].index, src[0] & 0x0F);
+            out[1] = decodeNibble(ch[0].predictor, ch[0].index, src[0] >> 4);
+            out += 2;
+            frames += 2;
+        } else {
+            for (int c = 0; c < 2; c++) {
+                for (int i = 0; i < 4; i++) {
+                    uint8_t b = src[c * 4 + i];
+                    out[(4 * i) + c] = decodeNibble(ch[c].predictor, ch[c].index, b & 0x0F);
+                    out[(4 * i) + 2 + c] = decodeNibble(ch[c].predictor, ch[c].index, b >> 4);
+                }
+            }
+            out += 16;
+            frames += 8;
+        }
+        src += unitBytes;
+        len -= unitBytes;
+        blockLeft -= unitBytes;
+    }
+    return frames;
+}
+
+// ── Encoder ───────────────────────────────────────────────────────────────────
+
+#define ADPCM_ENCODE_BLOCK_BYTES 512  // Per channel (1017 samples)
+
+static void putLE16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void putLE32(uint8_t* p, uint32_t v) {
+    putLE16(p, v & 0xFFFF);
+    putLE16(p + 2, v >> 16);
+}
+
+bool imaAdpcmEncodeFile(const String& srcPath, const String& dstPath) {
+    File src = SD.open(srcPath);
+    if (!src) return false;
+
+    WavInfo info;
+    if (!wavReadInfo(src, info) || info.format != WAV_FORMAT_PCM || info.bitsPerSample != 16 ||
+        (info.channels != 1 && info.channels != 2)) {
+        Serial.println("[ADPCM] Source must be 16-bit PCM mono/stereo: " + srcPath);
+        src.close();
+        return false;
+    }
+
+    uint16_t channels = info.channels;
+    uint16_t blockAlign = ADPCM_ENCODE_BLOCK_BYTES * channels;
+    uint32_t spb = ImaAdpcmDecoder::samplesPerBlock(channels, blockAlign);
+    uint32_t blocks = (info.frames + spb - 1) / spb;
+
+    int16_t* pcm = (int16_t*)malloc(spb * channels * sizeof(int16_t));
+    uint8_t* block = (uint8_t*)malloc(blockAlign);
+    File dst = SD.open(dstPath, FILE_WRITE);
+    if (!pcm || !block || !dst) {
+        Serial.println("[ADPCM] Encode setup failed: " + dstPath);
+        if (pcm) free(pcm);
+        if (block) free(block);
+        if (dst) dst.close();
+        src.close();
+        return false;
+    }
+
+    // RIFF + fmt (20) + fact + data headers, with a smpl chunk between fact
+    // and data if the source has a loop (the frame numbers stay the same)
+    uint32_t dataSize = blocks * blockAlign;
+    uint8_t hdr[60];
+    uint8_t smpl[8 + 36 + 24];
+    uint32_t smplSize = info.loopEnd ? sizeof(smpl) : 0;
+    memset(smpl, 0, sizeof(smpl));
+    memcpy(smpl, "smpl", 4);
+    putLE32(smpl + 4, sizeof(smpl) - 8);
+    putLE32(smpl + 16, 1000000000UL / info.sampleRate);  // Sample period, ns
+    putLE32(smpl + 20, 60);                               // MIDI unity note
+    putLE32(smpl + 36, 1);                                // One loop
+    putLE32(smpl + 52, info.loopStart);
+    putLE32(smpl + 56, info.loopEnd - 1);                 // Inclusive
+    memcpy(hdr, "RIFF", 4);
+    putLE32(hdr + 4, sizeof(hdr) - 8 + smplSize + dataSize);
+    memcpy(hdr + 8, "WAVEfmt ", 8);
+    putLE32(hdr + 16, 20);
+    putLE16(hdr + 20, WAV_FORMAT_IMA_ADPCM);
+    putLE16(hdr + 22, channels);
+    putLE32(hdr + 24, info.sampleRate);
+    putLE32(hdr + 28, (uint64_t)info.sampleRate * blockAlign / spb);
+    putLE16(hdr + 32, blockAlign);
+    putLE16(hdr + 34, 4);
+    putLE16(hdr + 36, 2);
+    putLE16(hdr + 38, spb);
+    memcpy(hdr + 40, "fact", 4);
+    putLE32(hdr + 44, 4);
+    putLE32(hdr + 48, info.frames);
+    dst.write(hdr, 52);
+    dst.write(smpl, smplSize);
+    memcpy(hdr + 52, "data", 4);
+    putLE32(hdr + 56, dataSize);
+    dst.write(hdr + 52, 8);
+
+    int32_t predictor[2] = {0, 0};
+    int32_t index[2] = {0, 0};
+    uint32_t framesLeft = info.frames;
+    bool ok = true;
+
+    for (uint32_t b = 0; b < blocks && ok; b++) {
+        // Last block is zero padded; the fact chunk holds the real length
+        uint32_t want = min(spb, framesLeft);
+        size_t got = src.read((uint8_t*)pcm, want * channels * sizeof(int16_t));
+        memset((uint8_t*)pcm + got, 0, (spb * channels * sizeof(int16_t)) - got);
+        framesLeft -= want;
+
+        uint8_t* p = block;
+        for (int c = 0; c < channels; c++) {
+            predictor[c] = pcm[c];
+            putLE16(p, (uint16_t)pcm[c]);
+            p[2] = index[c];
+            p[3] = 0;
+            p += 4;
+        }
+
+        if (channels == 1) {
+            for (uint32_t i = 1; i < spb; i += 2) {
+                uint8_t lo = encodeNibble(predictor[0], index[0], pcm[i]);
+                uint8_t hi = encodeNibble(predictor[0], index[0], pcm[i + 1]);
+                *p++ = lo | (hi << 4);
+            }
+        } else {
+            for (uint32_t i = 1; i < spb; i += 8) {
+                for (int c = 0; c < 2; c++) {
+                    for (int k = 0; k < 8; k += 2) {
+                        uint8_t lo = encodeNibble(predictor[c], index[c], pcm[(i + k) * 2 + c]);
+                        uint8_t hi = encodeNibble(predictor[c], index[c], pcm[(i + k + 1) * 2 + c]);
+                        *p++ = lo | (hi << 4);
+                    }
+                }
+            }
+        }
+
+        ok = dst.write(block, blockAlign) == blockAlign;
+        yield();
+    }
+
+    free(pcm);
+    free(block);
+    dst.close();
+    src.close();
+
+    if (!ok) {
+        Serial.println("[ADPCM] Write failed: " + dstPath);
+        return false;
+    }
+    Serial.printf("[ADPCM] Encoded %s (%u frames, %u bytes)\n", dstPath.c_str(),
+                  (unsigned)info.frames, (unsigned)(sizeof(hdr) + smplSize + dataSize));
+    return true;
+}
@@ -0,0 +1,471 @@
+#include "jingle_catalog.h"
+#include "pcm_convert.h"
+#include "ima_adpcm.h"
+#include "jingle_pack.h"
+#include <SD.h>
+
+#define CATALOG_MAGIC    0x5441434A  // "JCAT"
+#define CATALOG_VERSION  4
+#define CATALOG_MAX_ENTRIES 1024
+
+#define ANALYZE_FRAMES   1024        // Frames per read while measuring levels
+#define ANALYZE_RAW_BYTES (ANALYZE_FRAMES * 8)  // Read buffer: 1024 frames of 32-bit stereo
+#define VERIFY_TASK_STACK 6144
+#define VERIFY_TASK_PRIORITY 1       // Below the audio stream task
+#define VERIFY_TASK_CORE 0
+
+struct CatalogHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entrySize;   // Layout check - rebuilt if Entry changes
+    uint32_t count;
+};
+
+static String baseName(const String& path) {
+    int slash = path.lastIndexOf('/');
+    return slash >= 0 ? path.substring(slash + 1) : path;
+}
+
+static bool isJingleName(const String& name) {
+    if (name.length() == 0 || name[0] == '.') return false;
+    String lower = name;
+    lower.toLowerCase();
+    return lower.endsWith(".wav");
+}
+
+static bool isPackName(const String& name) {
+    if (name.length() == 0 || name[0] == '.') return false;
+    String lower = name;
+    lower.toLowerCase();
+    return lower.endsWith(".jpk");
+}
+
+// Records of a pack are named "<pack>#<entry>"
+static bool isPackRecord(const char* record, const String& pack) {
+    return strncmp(record, pack.c_str(), pack.length()) == 0 && record[pack.length()] == JPACK_SEPARATOR;
+}
+
+JingleCatalog::JingleCatalog() : mutex(nullptr), verifying(false), updateSeq(0) {
+}
+
+bool JingleCatalog::begin() {
+    if (!mutex) mutex = xSemaphoreCreateMutex();
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    list.clear();
+
+    File file = SD.open(CATALOG_PATH);
+    CatalogHeader hdr;
+    bool ok = file && file.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              hdr.magic == CATALOG_MAGIC && hdr.version == CATALOG_VERSION &&
+              hdr.entrySize == sizeof(Entry) && hdr.count <= CATALOG_MAX_ENTRIES &&
+              file.size() >= sizeof(hdr) + hdr.count * sizeof(Entry);
+
+    if (ok) {
+        list.resize(hdr.count);
+        if (hdr.count && file.read((uint8_t*)list.data(), hdr.count * sizeof(Entry)) != hdr.count * sizeof(Entry)) {
+            list.clear();
+            ok = false;
+        }
+    }
+    if (file) file.close();
+    xSemaphoreGive(mutex);
+
+    if (ok) {
+        Serial.printf("[CATALOG] Loaded %u entries\n", (unsigned)list.size());
+    } else {
+        Serial.println("[CATALOG] No valid index on card");
+    }
+    return ok;
+}
+
+int JingleCatalog::find(const String& filename) {
+    String name = baseName(filename);
+    for (size_t i = 0; i < list.size(); i++) {
+        if (name == list[i].name) return i;
+    }
+    return -1;
+}
+
+bool JingleCatalog::lookup(const String& path, Entry& out) {
+    if (!mutex) return false;
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    int i = find(path);
+    if (i >= 0) out = list[i];
+    xSemaphoreGive(mutex);
+    return i >= 0;
+}
+
+std::vector<JingleCatalog::Entry> JingleCatalog::entries() {
+    std::vector<Entry> copy;
+    if (!mutex) return copy;
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    copy = list;
+    xSemaphoreGive(mutex);
+    return copy;
+}
+
+bool JingleCatalog::update(const String& filename) {
+    if (!mutex) return false;
+    if (isPackName(baseName(filename))) return updatePack(baseName(filename));
+
+    Entry e;
+    if (!analyze(baseName(filename), e)) return false;
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    int i = find(e.name);
+    if (i < 0) {
+        if (list.size() >= CATALOG_MAX_ENTRIES) {
+            xSemaphoreGive(mutex);
+            return false;
+        }
+        list.push_back(e);
+        i = list.size() - 1;
+    } else {
+        list[i] = e;
+    }
+    bool ok = saveRecord(i);
+    updateSeq++;
+    xSemaphoreGive(mutex);
+
+    Serial.printf("[CATALOG] Updated %s (%ums, peak %u, rms %u, %.1f LUFS, %.1f dBTP)\n", e.name,
+                  (unsigned)e.durationMs, e.peak, e.rms, e.loudness / 10.0f, e.truePeak / 10.0f);
+    uint32_t startMs, endMs;
+    if (proposeTrim(e, startMs, endMs)) {
+        Serial.printf("[CATALOG] %s: %ums silence ahead, %ums after - proposed trim %u-%ums\n", e.name,
+                      e.leadMs, e.tailMs, (unsigned)startMs, (unsigned)endMs);
+    }
+    return ok;
+}
+
+bool JingleCatalog::proposeTrim(const Entry& e, uint32_t& startMs, uint32_t& endMs) {
+    startMs = (e.leadMs >= TRIM_MIN_MS) ? e.leadMs - TRIM_PREROLL_MS : 0;
+    endMs = (e.tailMs >= TRIM_TAIL_KEEP_MS + TRIM_MIN_MS) ? e.durationMs - e.tailMs + TRIM_TAIL_KEEP_MS : 0;
+    return startMs || endMs;
+}
+
+// A pack replaces all of its records at once
+bool JingleCatalog::updatePack(const String& pack) {
+    std::vector<Entry> entries;
+    if (!analyzePack(pack, entries)) return false;
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    dropPackRecords(pack);
+    for (const Entry& e : entries) {
+        if (list.size() >= CATALOG_MAX_ENTRIES) break;
+        list.push_back(e);
+    }
+    bool ok = saveAll();
+    updateSeq++;
+    xSemaphoreGive(mutex);
+
+    Serial.printf("[CATALOG] Updated pack %s (%u entries)\n", pack.c_str(), (unsigned)entries.size());
+    return ok;
+}
+
+bool JingleCatalog::remove(const String& filename) {
+    if (!mutex) return false;
+    String name = baseName(filename);
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    size_t before = list.size();
+    if (isPackName(name)) {
+        dropPackRecords(name);
+    } else {
+        int i = find(name);
+        if (i >= 0) list.erase(list.begin() + i);
+    }
+    bool ok = false;
+    if (list.size() != before) {
+        ok = saveAll();
+        updateSeq++;
+    }
+    xSemaphoreGive(mutex);
+    return ok;
+}
+
+void JingleCatalog::dropPackRecords(const String& pack) {
+    for (size_t i = 0; i < list.size();) {
+        if (isPackRecord(list[i].name, pack)) {
+            list.erase(list.begin() + i);
+        } else {
+            i++;
+        }
+    }
+}
+
+// ── Index file ────────────────────────────────────────────────────────────────
+
+bool JingleCatalog::saveAll() {
+    File file = SD.open(CATALOG_PATH, FILE_WRITE);
+    if (!file) {
+        Serial.println("[CATALOG] Failed to write index");
+        return false;
+    }
+    CatalogHeader hdr = {CATALOG_MAGIC, CATALOG_VERSION, sizeof(Entry), (uint32_t)list.size()};
+    bool ok = file.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+    if (ok && !list.empty()) {
+        ok = file.write((const uint8_t*)list.data(), list.size() * sizeof(Entry)) == list.size() * sizeof(Entry);
+    }
+    file.close();
+    return ok;
+}
+
+// Rewrite one record (and the count) in place instead of the whole index
+bool JingleCatalog::saveRecord(int index) {
+    File file = SD.open(CATALOG_PATH, "r+");
+    if (!file || file.size() < sizeof(CatalogHeader) + index * sizeof(Entry)) {
+        if (file) file.close();
+        return saveAll();
+    }
+    CatalogHeader hdr = {CATALOG_MAGIC, CATALOG_VERSION, sizeof(Entry), (uint32_t)list.size()};
+    bool ok = file.seek(sizeof(hdr) + index * sizeof(Entry)) &&
+              file.write((const uint8_t*)&list[index], sizeof(Entry)) == sizeof(Entry) &&
+              file.seek(0) &&
+              file.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+    file.close();
+    return ok;
+}
+
+// ── Analysis ──────────────────────────────────────────────────────────────────
+
+// Parse the header and measure peak/RMS, loudness and the silence at
+// either end over the whole data chunk - one sequential read, right after an upload (and its ADPCM
+// re-encode) or when the verify pass finds a new file. Files
+// that are not playable WAVs still get a record (format 0) so they show up
+// in the file list and can be deleted.
+bool JingleCatalog::analyze(const String& filename, Entry& e) {
+    if (filename.length() >= CATALOG_NAME_LEN) {
+        Serial.println("[CATALOG] Name too long: " + filename);
+        return false;
+    }
+
+    File file = SD.open(String(CATALOG_DIR) + "/" + filename);
+    if (!file) return false;
+
+    memset(&e, 0, sizeof(e));
+    strncpy(e.name, filename.c_str(), CATALOG_NAME_LEN - 1);
+    e.loudness = e.truePeak = LOUDNESS_UNMEASURED;
+    e.fileSize = file.size();
+    e.mtime = file.getLastWrite();
+
+    if (!wavReadInfo(file, e.info) || e.info.sampleRate == 0) {
+        memset(&e.info, 0, sizeof(e.info));
+        file.close();
+        return true;
+    }
+    e.durationMs = (uint64_t)e.info.frames * 1000 / e.info.sampleRate;
+
+    bool adpcm = (e.info.format == WAV_FORMAT_IMA_ADPCM);
+    PcmConvertFn convert = adpcm ? pcmSelectConverter(WAV_FORMAT_PCM, 16, e.info.channels)
+                                 : pcmSelectConverter(e.info.format, e.info.bitsPerSample, e.info.channels);
+    uint8_t* raw = (uint8_t*)malloc(ANALYZE_RAW_BYTES);
+    int16_t* decoded = (int16_t*)malloc(ANALYZE_FRAMES * 4);
+    int16_t* stereo = (int16_t*)malloc(ANALYZE_FRAMES * 4);
+    if (!convert || !raw || !decoded || !stereo) {
+        free(raw);
+        free(decoded);
+        free(stereo);
+        file.close();
+        return true;
+    }
+
+    ImaAdpcmDecoder decoder;
+    decoder.begin(e.info.channels, e.info.blockAlign);
+    LoudnessMeter meter;
+    bool metering = meter.begin(e.info.sampleRate);
+    uint32_t dither = 1;
+    uint32_t left = e.info.dataSize;
+    uint32_t peak = 0;
+    uint64_t sumSquares = 0;
+    uint32_t samples = 0;
+    uint32_t firstSound = UINT32_MAX;  // Frames above SILENCE_THRESHOLD
+    uint32_t lastSound = 0;
+
+    while (left > 0) {
+        int frames;
+        if (adpcm) {
+            size_t want = min(decoder.nextReadSize(ANALYZE_FRAMES, ANALYZE_RAW_BYTES), (size_t)left);
+            size_t n = file.read(raw, want);
+            if (n == 0) break;
+            left -= n;
+            frames = decoder.decode(raw, n, decoded);
+            convert((const uint8_t*)decoded, stereo, frames, dither);
+        } else {
+            size_t want = min((uint32_t)(ANALYZE_RAW_BYTES / e.info.blockAlign) * e.info.blockAlign, left);
+            size_t n = file.read(raw, want);
+            if (n == 0) break;
+            left -= n;
+            frames = n / e.info.blockAlign;
+            convert(raw, stereo, frames, dither);
+        }
+
+        for (int i = 0; i < frames * 2; i++) {
+            int32_t s = stereo[i];
+            uint32_t mag = s < 0 ? -s : s;
+            if (mag > peak) peak = mag;
+            sumSquares += (uint32_t)(s * s);
+            if (mag > SILENCE_THRESHOLD) {
+                uint32_t frame = samples / 2 + i / 2;
+                if (firstSound == UINT32_MAX) firstSound = frame;
+                lastSound = frame;
+            }
+        }
+        samples += frames * 2;
+        if (metering) meter.push(stereo, frames);
+        yield();
+    }
+
+    e.peak = min(peak, (uint32_t)32767);
+    e.rms = samples ? (uint16_t)sqrt((double)sumSquares / samples) : 0;
+    // Against the header's frame count: decoded ADPCM runs on into the
+    // padding of the last block, which is not part of the clip
+    if (firstSound < e.info.frames) {
+        lastSound = min(lastSound, e.info.frames - 1);
+        uint32_t sr = e.info.sampleRate;
+        e.leadMs = min((uint64_t)firstSound * 1000 / sr, (uint64_t)UINT16_MAX);
+        e.tailMs = min((uint64_t)(e.info.frames - 1 - lastSound) * 1000 / sr, (uint64_t)UINT16_MAX);
+    }
+    if (metering) meter.end(e.loudness, e.truePeak);
+
+    free(raw);
+    free(decoded);
+    free(stereo);
+    file.close();
+    return true;
+}
+
+// One record per pack entry. Levels were measured by the pack builder.
+bool JingleCatalog::analyzePack(const String& pack, std::vector<Entry>& out) {
+    File file = SD.open(String(CATALOG_DIR) + "/" + pack);
+    if (!file) return false;
+
+    std::vector<JPackEntry> toc;
+    bool ok = packReadToc(file, toc);
+    uint32_t fileSize = file.size();
+    uint32_t mtime = file.getLastWrite();
+    file.close();
+    if (!ok) return false;
+
+    for (const JPackEntry& p : toc) {
+        String name = pack + JPACK_SEPARATOR + p.name;
+        if (name.length() >= CATALOG_NAME_LEN) {
+            Serial.println("[CATALOG] Name too long: " + name);
+            continue;
+        }
+        Entry e;
+        memset(&e, 0, sizeof(e));
+        strncpy(e.name, name.c_str(), CATALOG_NAME_LEN - 1);
+        e.fileSize = fileSize;
+        e.mtime = mtime;
+        packEntryInfo(p, e.info);
+        e.durationMs = (uint64_t)p.frames * 1000 / JPACK_SAMPLE_RATE;
+        e.peak = p.peak;
+        e.rms = p.rms;
+        e.loudness = e.truePeak = LOUDNESS_UNMEASURED;  // Not in the pack format
+        out.push_back(e);
+    }
+    return true;
+}
+
+// ── Background verify ─────────────────────────────────────────────────────────
+
+void JingleCatalog::startVerify() {
+    if (!mutex || verifying) return;
+    verifying = true;
+    if (xTaskCreatePinnedToCore(verifyTask, "catalog", VERIFY_TASK_STACK, this,
+                                VERIFY_TASK_PRIORITY, nullptr, VERIFY_TASK_CORE) != pdPASS) {
+        Serial.println("[CATALOG] Failed to start verify task");
+        verifying = false;
+    }
+}
+
+void JingleCatalog::verifyTask(void* param) {
+    JingleCatalog* self = (JingleCatalog*)param;
+    self->verify();
+    self->verifying = false;
+    vTaskDelete(nullptr);
+}
+
+// Walk /jingles/, keep records whose size + mtime still match, re-analyze
+// the rest and drop files that are gone
+void JingleCatalog::verify() {
+    unsigned long start = millis();
+    int analyzed = 0;
+    size_t total = 0;
+
+    while (true) {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        uint32_t seq = updateSeq;
+        xSemaphoreGive(mutex);
+
+        std::vector<Entry> fresh;
+        File root = SD.open(CATALOG_DIR);
+        if (!root || !root.isDirectory()) {
+            Serial.println("[CATALOG] " CATALOG_DIR " not found");
+            return;
+        }
+
+        File file = root.openNextFile();
+        while (file) {
+            bool isDir = file.isDirectory();
+            String name = baseName(file.name());
+            uint32_t size = file.size();
+            uint32_t mtime = file.getLastWrite();
+            file.close();
+
+            if (!isDir && isPackName(name)) {
+                std::vector<Entry> records;
+                xSemaphoreTake(mutex, portMAX_DELAY);
+                for (const Entry& e : list) {
+                    if (isPackRecord(e.name, name) && e.fileSize == size && e.mtime == mtime) {
+                        records.push_back(e);
+                    }
+                }
+                xSemaphoreGive(mutex);
+
+                if (records.empty()) {
+                    analyzePack(name, records);
+                    analyzed++;
+                }
+                for (const Entry& e : records) {
+                    if (fresh.size() < CATALOG_MAX_ENTRIES) fresh.push_back(e);
+                }
+            } else if (!isDir && isJingleName(name) && fresh.size() < CATALOG_MAX_ENTRIES) {
+                Entry e;
+                bool have = false;
+                xSemaphoreTake(mutex, portMAX_DELAY);
+                int i = find(name);
+                if (i >= 0 && list[i].fileSize == size && list[i].mtime == mtime) {
+                    e = list[i];
+                    have = true;
+                }
+                xSemaphoreGive(mutex);
+
+                if (!have) {
+                    have = analyze(name, e);
+                    analyzed++;
+                }
+                if (have) fresh.push_back(e);
+            }
+            file = root.openNextFile();
+        }
+        root.close();
+
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        bool raced = (seq != updateSeq);  // Upload/delete while we walked - go again
+        if (!raced) {
+            bool changed = fresh.size() != list.size() ||
+                           (!fresh.empty() && memcmp(fresh.data(), list.data(), fresh.size() * sizeof(Entry)) != 0);
+            if (changed) {
+                list = fresh;
+                saveAll();
+            }
+            total = fresh.size();
+        }
+        xSemaphoreGive(mutex);
+        if (!raced) break;
+    }
+
+    Serial.printf("[CATALOG] Verified %u entries (%d analyzed) in %lums\n",
+                  (unsigned)total, analyzed, millis() - start);
+}
@@ -0,0 +1,87 @@
+#include "jingle_pack.h"
+
+static bool checkHeader(const JPackHeader& hdr, uint32_t imageSize) {
+    if (hdr.magic != JPACK_MAGIC || hdr.version != JPACK_VERSION ||
+        hdr.sampleRate != JPACK_SAMPLE_RATE || hdr.channels != JPACK_CHANNELS ||
+        hdr.bitsPerSample != 16 || hdr.entryCount > JPACK_MAX_ENTRIES) {
+        Serial.println("[PACK] Bad header");
+        return false;
+    }
+    if (hdr.totalSize > imageSize ||
+        (uint64_t)hdr.tocOffset + hdr.entryCount * sizeof(JPackEntry) > imageSize) {
+        Serial.println("[PACK] Truncated pack");
+        return false;
+    }
+    return true;
+}
+
+// Drop anything pointing outside the image
+static void checkEntries(std::vector<JPackEntry>& toc, uint32_t imageSize) {
+    for (size_t i = 0; i < toc.size();) {
+        JPackEntry& e = toc[i];
+        e.name[JPACK_NAME_LEN - 1] = '\0';
+        if ((uint64_t)e.offset + e.size > imageSize || e.size < e.frames * 4ull) {
+            Serial.printf("[PACK] Skipping bad entry %s\n", e.name);
+            toc.erase(toc.begin() + i);
+        } else {
+            i++;
+        }
+    }
+}
+
+bool packReadToc(File& file, std::vector<JPackEntry>& toc) {
+    JPackHeader hdr;
+    uint32_t fileSize = file.size();
+
+    file.seek(0);
+    if (file.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr)) return false;
+    if (!checkHeader(hdr, fileSize)) return false;
+
+    toc.resize(hdr.entryCount);
+    size_t tocBytes = hdr.entryCount * sizeof(JPackEntry);
+    if (!file.seek(hdr.tocOffset) || file.read((uint8_t*)toc.data(), tocBytes) != tocBytes) {
+        toc.clear();
+        return false;
+    }
+    checkEntries(toc, fileSize);
+    return true;
+}
+
+bool packParseToc(const uint8_t* image, size_t imageSize, std::vector<JPackEntry>& toc) {
+    JPackHeader hdr;
+    if (imageSize < sizeof(hdr)) return false;
+    memcpy(&hdr, image, sizeof(hdr));
+    if (!checkHeader(hdr, imageSize)) return false;
+
+    toc.resize(hdr.entryCount);
+    if (toc.empty()) return true;
+    memcpy(toc.data(), image + hdr.tocOffset, hdr.entryCount * sizeof(JPackEntry));
+    checkEntries(toc, imageSize);
+    return true;
+}
+
+bool packFindEntry(File& file, const String& name, WavInfo& info) {
+    std::vector<JPackEntry> toc;
+    if (!packReadToc(file, toc)) return false;
+
+    for (const JPackEntry& e : toc) {
+        if (name == e.name) {
+            packEntryInfo(e, info);
+            return file.seek(info.dataOffset);
+        }
+    }
+    return false;
+}
+
+void packEntryInfo(const JPackEntry& entry, WavInfo& info) {
+    info.format = WAV_FORMAT_PCM;
+    info.channels = JPACK_CHANNELS;
+    info.bitsPerSample = 16;
+    info.blockAlign = JPACK_CHANNELS * 2;
+    info.sampleRate = JPACK_SAMPLE_RATE;
+    info.dataOffset = entry.offset;
+    info.dataSize = entry.frames * info.blockAlign;
+    info.frames = entry.frames;
+    info.loopStart = 0;
+    info.loopEnd = 0;
+}
@@ -0,0 +1,91 @@
+#include "latency_histogram.h"
+#include <esp_attr.h>
+#include <math.h>
+
+#define LATENCY_MAGIC 0x4C415431  // "LAT1"
+
+struct LatencyStore {
+    uint32_t magic;
+    uint32_t counts[LATENCY_STAGE_COUNT][LATENCY_BUCKETS];
+    uint32_t total[LATENCY_STAGE_COUNT];
+    uint32_t minUs[LATENCY_STAGE_COUNT];
+    uint32_t maxUs[LATENCY_STAGE_COUNT];
+};
+
+// Not cleared by a software reset (cleared on power-up via the magic)
+static RTC_NOINIT_ATTR LatencyStore store;
+
+static uint32_t bucketUpper[LATENCY_BUCKETS];
+
+static const char* const stageNames[LATENCY_STAGE_COUNT] = {
+    "playEntry", "sourceReady", "firstFrame", "fadeInDone"
+};
+
+void latencyBegin() {
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        bucketUpper[b] = (uint32_t)lroundf(100.0f * powf(2.0f, b / 4.0f));
+    }
+    if (store.magic != LATENCY_MAGIC) latencyReset();
+}
+
+void latencyReset() {
+    memset(&store, 0, sizeof(store));
+    for (int s = 0; s < LATENCY_STAGE_COUNT; s++) store.minUs[s] = UINT32_MAX;
+    store.magic = LATENCY_MAGIC;
+}
+
+void latencyRecord(uint8_t stage, uint32_t us) {
+    if (stage >= LATENCY_STAGE_COUNT) return;
+
+    // First bucket whose upper bound holds the sample (binary search);
+    // anything longer lands in the last one
+    int lo = 0, hi = LATENCY_BUCKETS - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (us <= bucketUpper[mid]) hi = mid;
+        else lo = mid + 1;
+    }
+
+    store.counts[stage][lo]++;
+    store.total[stage]++;
+    if (us < store.minUs[stage]) store.minUs[stage] = us;
+    if (us > store.maxUs[stage]) store.maxUs[stage] = us;
+}
+
+static uint32_t percentile(uint8_t stage, uint32_t permille) {
+    uint32_t n = store.total[stage];
+    uint32_t rank = (n * permille + 999) / 1000;  // Nearest-rank
+    uint32_t seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += store.counts[stage][b];
+        if (seen >= rank) return min(bucketUpper[b], store.maxUs[stage]);
+    }
+    return store.maxUs[stage];
+}
+
+LatencySummary latencySummary(uint8_t stage) {
+    LatencySummary s = {};
+    if (stage >= LATENCY_STAGE_COUNT || store.total[stage] == 0) return s;
+
+    s.count = store.total[stage];
+    s.minUs = store.minUs[stage];
+    s.maxUs = store.maxUs[stage];
+    s.p50Us = percentile(stage, 500);
+    s.p95Us = percentile(stage, 950);
+    s.p99Us = percentile(stage, 990);
+    return s;
+}
+
+uint32_t latencyBucketCount(uint8_t stage, int bucket) {
+    if (stage >= LATENCY_STAGE_COUNT || bucket < 0 || bucket >= LATENCY_BUCKETS) return 0;
+    return store.counts[stage][bucket];
+}
+
+uint32_t latencyBucketUpperUs(int bucket) {
+    if (bucket < 0 || bucket >= LATENCY_BUCKETS) return 0;
+    return bucketUpper[bucket];
+}
+
+const char* latencyStageName(uint8_t stage) {
+    return stage < LATENCY_STAGE_COUNT ? stageNames[stage] : "?";
+}
@@ -0,0 +1,188 @@
+#include "loudness_meter.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIST_FLOOR  -70.0f   // Absolute gate, LUFS
+#define HIST_STEP   0.25f    // LU per histogram bin
+
+// 4x true-peak interpolator: phase p evaluates the signal p/4 of a sample
+// after the window centre (Hann-windowed sinc, each phase normalised to
+// unity DC gain). Phase 0 is the sample itself and is not filtered.
+static float tpCoeffs[4][12];
+static bool tpReady = false;
+
+static void buildTruePeakCoeffs() {
+    const int taps = 12;
+    const int delay = taps / 2 - 1;
+    for (int p = 1; p < 4; p++) {
+        float sum = 0;
+        for (int k = 0; k < taps; k++) {
+            float t = (float)(k - delay) - p / 4.0f;
+            float sinc = (t == 0) ? 1.0f : sinf(M_PI * t) / (M_PI * t);
+            float window = 0.5f * (1.0f + cosf(M_PI * t / (taps / 2)));
+            tpCoeffs[p][k] = sinc * window;
+            sum += tpCoeffs[p][k];
+        }
+        for (int k = 0; k < taps; k++) tpCoeffs[p][k] /= sum;
+    }
+    tpReady = true;
+}
+
+static float loudnessOf(float meanSquare) {
+    return -0.691f + 10.0f * log10f(meanSquare);
+}
+
+float LoudnessMeter::Biquad::run(float x, int ch) {
+    float y = b0 * x + z1[ch];
+    z1[ch] = b1 * x - a1 * y + z2[ch];
+    z2[ch] = b2 * x - a2 * y;
+    return y;
+}
+
+LoudnessMeter::LoudnessMeter() : histCount(nullptr), histEnergy(nullptr) {
+}
+
+LoudnessMeter::~LoudnessMeter() {
+    free(histCount);
+    free(histEnergy);
+}
+
+// K-weighting for any sample rate: the BS.1770 filters re-derived from
+// their analog prototypes (shelf at 1682Hz/+4dB, high-pass at 38Hz)
+bool LoudnessMeter::begin(uint32_t sampleRate) {
+    // Below 8 kHz the shelf is too close to Nyquist and the filter blows up
+    if (sampleRate < 8000) return false;
+    if (!tpReady) buildTruePeakCoeffs();
+
+    free(histCount);
+    free(histEnergy);
+    histCount = (uint32_t*)calloc(HIST_BINS, sizeof(uint32_t));
+    histEnergy = (float*)calloc(HIST_BINS, sizeof(float));
+    if (!histCount || !histEnergy) return false;
+
+    double fs = sampleRate;
+    double k = tan(M_PI * 1681.974450955533 / fs);
+    double q = 0.7071752369554196;
+    double vh = pow(10.0, 3.999843853973347 / 20.0);
+    double vb = pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / q + k * k;
+    shelf = {(float)((vh + vb * k / q + k * k) / a0), (float)(2.0 * (k * k - vh) / a0),
+             (float)((vh - vb * k / q + k * k) / a0), (float)(2.0 * (k * k - 1.0) / a0),
+             (float)((1.0 - k / q + k * k) / a0), {0, 0}, {0, 0}};
+
+    k = tan(M_PI * 38.13547087602444 / fs);
+    q = 0.5003270373238773;
+    a0 = 1.0 + k / q + k * k;
+    highpass = {1.0f, -2.0f, 1.0f, (float)(2.0 * (k * k - 1.0) / a0),
+                (float)((1.0 - k / q + k * k) / a0), {0, 0}, {0, 0}};
+
+    stepFrames = sampleRate / 10;
+    stepLeft = stepFrames;
+    stepEnergy = 0;
+    hopCount = 0;
+    clipEnergy = 0;
+    clipFrames = 0;
+    memset(tpHist, 0, sizeof(tpHist));
+    tpPos = 0;
+    truePeak = 0;
+    return true;
+}
+
+void LoudnessMeter::push(const int16_t* stereo, int frames) {
+    if (!histCount) return;
+
+    for (int i = 0; i < frames; i++) {
+        for (int ch = 0; ch < 2; ch++) {
+            float x = stereo[i * 2 + ch] * (1.0f / 32768.0f);
+
+            float y = highpass.run(shelf.run(x, ch), ch);
+            stepEnergy += y * y;
+
+            // Newest sample at tpPos + TP_TAPS, window = the TP_TAPS before it
+            float* h = tpHist[ch];
+            h[tpPos] = h[tpPos + TP_TAPS] = x;
+            float peak = fabsf(x);
+            for (int p = 1; p < 4; p++) {
+                float acc = 0;
+                for (int k = 0; k < TP_TAPS; k++) acc += h[tpPos + TP_TAPS - k] * tpCoeffs[p][k];
+                peak = fmaxf(peak, fabsf(acc));
+            }
+            if (peak > truePeak) truePeak = peak;
+        }
+        tpPos = (tpPos + 1) % TP_TAPS;
+
+        if (--stepLeft == 0) {
+            clipEnergy += stepEnergy;
+            clipFrames += stepFrames;
+            hops[hopCount % 4] = stepEnergy;
+            hopCount++;
+            if (hopCount >= 4) {
+                addBlock((hops[0] + hops[1] + hops[2] + hops[3]) / (4.0f * stepFrames));
+            }
+            stepEnergy = 0;
+            stepLeft = stepFrames;
+        }
+    }
+}
+
+void LoudnessMeter::addBlock(float meanSquare) {
+    if (meanSquare <= 0) return;
+    float l = loudnessOf(meanSquare);
+    if (l < HIST_FLOOR) return;
+    int bin = (int)((l - HIST_FLOOR) / HIST_STEP);
+    if (bin >= HIST_BINS) bin = HIST_BINS - 1;
+    histCount[bin]++;
+    histEnergy[bin] += meanSquare;
+}
+
+void LoudnessMeter::end(int16_t& lufsX10, int16_t& truePeakX10) {
+    lufsX10 = truePeakX10 = LOUDNESS_UNMEASURED;
+    if (!histCount) return;
+
+    // Stingers shorter than one gating block count as a single block
+    if (hopCount < 4) {
+        clipEnergy += stepEnergy;
+        clipFrames += stepFrames - stepLeft;
+        if (clipFrames) addBlock(clipEnergy / clipFrames);
+    }
+
+    // Relative gate: 10 LU below the loudness of everything above -70 LUFS
+    double energy = 0;
+    uint32_t blocks = 0;
+    for (int b = 0; b < HIST_BINS; b++) {
+        energy += histEnergy[b];
+        blocks += histCount[b];
+    }
+    if (blocks > 0) {
+        float gate = loudnessOf(energy / blocks) - 10.0f;
+        energy = 0;
+        blocks = 0;
+        for (int b = 0; b < HIST_BINS; b++) {
+            if (histCount[b] && loudnessOf(histEnergy[b] / histCount[b]) >= gate) {
+                energy += histEnergy[b];
+                blocks += histCount[b];
+            }
+        }
+        lufsX10 = (int16_t)lroundf(loudnessOf(energy / blocks) * 10.0f);
+        truePeakX10 = (int16_t)lroundf(20.0f * log10f(fmaxf(truePeak, 1e-5f)) * 10.0f);
+    }
+
+    free(histCount);
+    free(histEnergy);
+    histCount = nullptr;
+    histEnergy = nullptr;
+}
+
+int32_t loudnessGainQ15(int16_t lufsX10, int16_t truePeakX10, int targetX10) {
+    if (lufsX10 == LOUDNESS_UNMEASURED || targetX10 == 0) return 32768;
+
+    int gain = targetX10 - lufsX10;
+    if (gain > 0) {
+        int headroom = LOUDNESS_PEAK_CEILING - truePeakX10;
+        if (gain > headroom) gain = headroom > 0 ? headroom : 0;
+    }
+    if (gain > LOUDNESS_MAX_BOOST) gain = LOUDNESS_MAX_BOOST;
+    if (gain < LOUDNESS_MAX_CUT) gain = LOUDNESS_MAX_CUT;
+    return (int32_t)lroundf(32768.0f * powf(10.0f, gain / 200.0f));
+}
@@ -7,9 +7,16 @@
 
 #include "pin_config.h"
 #include "audio_player.h"
+#include "audio_mixer.h"
+#include "audio_log.h"
+#include "latency_histogram.h"
+#include "audio_profiler.h"
+#include <esp_timer.h>
 #include "button_manager.h"
 #include "config_manager.h"
 #include "web_server.h"
+#include "jingle_catalog.h"
+#include "flash_jingles.h"
 
 // Hardware objects
 TFT_eSPI tft = TFT_eSPI();
@@ -20,6 +27,8 @@ XPT2046_Touchscreen touch(TOUCH_CS, TOUCH_IRQ);
 AudioPlayer audioPlayer;
 ConfigManager configMgr;
 ButtonManager btnMgr(&tft, &touch);
+JingleCatalog jingleCatalog;
+FlashJingles flashJingles;  // extern used by web_server.cpp
 
 // Settings server (only allocated in settings mode)
 SettingsServer* settingsServer = nullptr;
@@ -46,7 +55,27 @@ const unsigned long TOUCH_DEBOUNCE = 300;
 
 // Configurable at runtime (loaded from config)
 int touchPressureThreshold = 200;
+bool triggerOnPress = false;          // Fire on finger-down instead of lift
+unsigned long retriggerMs = 40;       // Press mode: ignore new contacts this soon after a fire
 uint8_t displayBrightness = 200;
+int loudnessTarget = -160;            // LUFS x10, 0 = play files at their own level
+
+// Everything a press needs, resolved from the config ahead of time so a
+// press only passes it on: no JSON lookups and no strings built. Files
+// (more than one = gapless sequence) come parsed, each with its loudness
+// gain (Q15). A looping button plays its first file until pressed again.
+struct ButtonSettings {
+    AudioSource files[AUDIO_SEQUENCE_MAX];
+    int32_t gains[AUDIO_SEQUENCE_MAX];
+    int count;
+    TriggerPolicy policy;          // "mode"
+    int chokeGroup;
+    bool loop;
+    uint32_t loopStart, loopEnd;   // File frames, 0/0 = the file's smpl loop
+    uint32_t startMs, endMs;       // Trim of the first file (not for loops)
+    uint8_t led[3];                // "color" as RGB
+};
+ButtonSettings buttonSettings[8];
 
 bool sdCardAvailable = false;
 
@@ -85,14 +114,12 @@ void setLED(uint8_t r, uint8_t g, uint8_t b) {
     digitalWrite(LED_B_PIN, b >= 128 ? LOW : HIGH);
 }
 
-// Parse "#RRGGBB" and set the LED
-void setLEDHex(const String& hex) {
+// Parse "#RRGGBB" (black if malformed)
+void parseHexColor(const String& hex, uint8_t rgb[3]) {
     String h = hex.startsWith("#") ? hex.substring(1) : hex;
-    if (h.length() < 6) { setLED(0, 0, 0); return; }
-    uint8_t r = (uint8_t)strtol(h.substring(0, 2).c_str(), nullptr, 16);
-    uint8_t g = (uint8_t)strtol(h.substring(2, 4).c_str(), nullptr, 16);
-    uint8_t b = (uint8_t)strtol(h.substring(4, 6).c_str(), nullptr, 16);
-    setLED(r, g, b);
+    for (int i = 0; i < 3; i++) {
+        rgb[i] = h.length() < 6 ? 0 : (uint8_t)strtol(h.substring(2 * i, 2 * i + 2).c_str(), nullptr, 16);
+    }
 }
 
 // ─────────────────────────────────────────────────────
@@ -178,6 +205,54 @@ void drawBTSelectScreen() {
 //  State transitions
 // ─────────────────────────────────────────────────────
 
+// Preload the start of every assigned jingle into RAM so a tap sounds
+// immediately (AudioPlayer streams the rest from SD behind it). A trimmed
+// jingle is preloaded from its trim start.
+void preloadJingleAttacks() {
+    if (!sdCardAvailable) return;
+    for (int i = 0; i < 8; i++) {
+        audioPlayer.cacheAttack(i, buttonSettings[i].files[0], buttonSettings[i].startMs);
+    }
+}
+
+// Per-button "mode" from config → mixer trigger policy
+TriggerPolicy buttonTriggerPolicy(int id) {
+    String mode = configMgr.getButtonMode(id);
+    if (mode == "overlap") return TRIGGER_OVERLAP;
+    if (mode == "restart") return TRIGGER_RESTART;
+    return TRIGGER_CHOKE;
+}
+
+// Resolve every button's settings from the config, with the loudness
+// normalisation gain of each file from the catalog times the button's own
+// gainDb. Run at boot and again when the verify pass may have measured new
+// files. Files without a measurement (flash, packs, no SD) are not
+// normalised. A running prefetch points into the table, so it is cancelled
+// first; a running sequence only reads it on this task.
+void resolveButtons() {
+    audioPlayer.cancelPrefetch();
+    for (int id = 0; id < 8; id++) {
+        ButtonSettings& b = buttonSettings[id];
+        String files[AUDIO_SEQUENCE_MAX];
+        b.count = configMgr.getButtonSequence(id, files, AUDIO_SEQUENCE_MAX);
+        for (int i = 0; i < AUDIO_SEQUENCE_MAX; i++) {
+            if (b.files[i].uri != files[i]) b.files[i] = parseAudioSource(files[i]);
+        }
+        b.policy = buttonTriggerPolicy(id);
+        b.chokeGroup = configMgr.getButtonChokeGroup(id);
+        b.loop = configMgr.getButtonLoop(id, b.loopStart, b.loopEnd);
+        if (b.loop || !configMgr.getButtonTrim(id, b.startMs, b.endMs)) b.startMs = b.endMs = 0;
+        parseHexColor(configMgr.getButtonColor(id), b.led);
+        int32_t buttonGain = lroundf(MIX_UNITY_GAIN * powf(10.0f, configMgr.getButtonGainDb(id) / 200.0f));
+        for (int i = 0; i < b.count; i++) {
+            JingleCatalog::Entry e;
+            bool known = sdCardAvailable && jingleCatalog.lookup(files[i], e);
+            int32_t gain = known ? loudnessGainQ15(e.loudness, e.truePeak, loudnessTarget) : MIX_UNITY_GAIN;
+            b.gains[i] = min(((int64_t)gain * buttonGain) >> 15, (int64_t)MIX_MAX_GAIN);
+        }
+    }
+}
+
 // Wait for BT connection – no timeout, waits forever.
 // Buttons "Scan BT" and "Open Settings" are always visible so the user
 // can choose at any time.
@@ -215,8 +290,16 @@ int tryBTConnect() {
     // ──────────────────────────────────────────────────────────────────
 
     btnMgr.loadConfig(configMgr.getConfig());
+    resolveButtons();
+    audioPlayer.setClipCacheBudget((size_t)configMgr.getClipCacheKB() * 1024);
     audioPlayer.begin(btName, btDeviceMac.length() > 0 ? btMac : nullptr, false);
     audioPlayer.setVolume(configMgr.getBTVolume());
+    audioPlayer.setCrossfade(configMgr.getCrossfadeMs());
+    audioPlayer.setBedLevel(configMgr.getBedLevel() * MIX_UNITY_GAIN / 100);
+    audioPlayer.setDucking(lroundf(MIX_UNITY_GAIN * powf(10.0f, configMgr.getDuckDb() / 20.0f)),
+                           configMgr.getDuckAttackMs(), configMgr.getDuckReleaseMs());
+    audioPlayer.setResampleQuality((Resampler::Quality)configMgr.getResampleQuality());
+    preloadJingleAttacks();
 
     static unsigned long lastDotUpdate = 0;
     static int dotCount = 0;
@@ -365,7 +448,7 @@ void bootSettingsMode() {
     tft.drawString("LEAVE", SCREEN_WIDTH / 2, 200, 4);
 
     settingsServer = new SettingsServer();
-    settingsServer->begin(&configMgr, &audioPlayer);
+    settingsServer->begin(&configMgr, &audioPlayer, &jingleCatalog);
 }
 
 // ─────────────────────────────────────────────────────
@@ -373,6 +456,9 @@ void bootSettingsMode() {
 // ─────────────────────────────────────────────────────
 void setupHardware() {
     Serial.begin(115200);
+    audioLogBegin();
+    latencyBegin();
+    profilerBegin();
     delay(500);
     Serial.println("\n\n=== Jingle Machine Starting ===");
 
@@ -418,9 +504,19 @@ void setupHardware() {
         tft.setTextColor(TFT_GREEN);
         tft.drawString("2. SD OK", 10, 30, 2);
         if (!SD.exists("/jingles")) SD.mkdir("/jingles");
+
+        // Index is used right away; the verify pass catches PC edits in
+        // the background
+        jingleCatalog.begin();
+        jingleCatalog.startVerify();
+        audioPlayer.setCatalog(&jingleCatalog);
     }
     delay(200);
 
+    // Stingers in the flash partition play even without an SD card
+    flashJingles.begin();
+    audioPlayer.setFlashJingles(&flashJingles);
+
     // Config
     tft.setTextColor(TFT_YELLOW);
     tft.drawString("3. Config...", 10, 50, 2);
@@ -450,6 +546,9 @@ void setup() {
     // Apply display + touch settings from config
     applyBrightness(configMgr.getBrightness());
     touchPressureThreshold = configMgr.getTouchThreshold();
+    triggerOnPress = configMgr.getTriggerOnPress();
+    retriggerMs = configMgr.getRetriggerMs();
+    loudnessTarget = configMgr.getLoudnessTarget();
 
     if (configMgr.isSettingsMode()) {
         configMgr.clearSettingsModeFlag();  // clear before booting (next boot = normal)
@@ -680,6 +779,8 @@ void handleBTSelect() {
 }
 
 void handleSettings() {
+    if (settingsServer) settingsServer->handle();
+
     // "LEAVE" button: x 110..210, y 178..223
     int x, y;
     if (!touchDebounced(x, y)) return;
@@ -694,21 +795,137 @@ void handleSettings() {
     }
 }
 
+// Start a button's jingle (or sequence). Audio first – playSequence() fails
+// on its own if the file is missing, and no display work may delay the sound.
+// A looping button toggles: the second press fades its loop out.
+bool fireButton(int id, uint32_t touchUs) {
+    if (id < 0 || id >= 8 || buttonSettings[id].count == 0) return false;
+    const ButtonSettings& b = buttonSettings[id];
+    if (b.loop) {
+        if (audioPlayer.isButtonPlaying(id)) {
+            audioPlayer.stopButton(id);
+            return true;
+        }
+        if (!audioPlayer.playLoop(b.files[0], id, b.policy, b.chokeGroup, b.gains[0], touchUs,
+                                  b.loopStart, b.loopEnd)) {
+            return false;
+        }
+    } else if (!audioPlayer.playSequence(b.files, b.count, b.gains, id, b.policy, b.chokeGroup, touchUs,
+                                         b.startMs, b.endMs)) {
+        return false;
+    }
+    setLED(b.led[0], b.led[1], b.led[2]);
+    return true;
+}
+
+void enterQuickSettings() {
+    lastTouchTime = millis();
+    currentState = STATE_QUICK_SETTINGS;
+    setLED(255, 180, 0);  // yellow = settings
+    drawQuickSettingsScreen();
+}
+
+// Press mode: fire on the first touch sample above the pressure threshold.
+// No release wait and no 300ms debounce, only a short retrigger window
+// against contact bounce. Quick Settings = hold the top-right corner zone.
+const int QS_CORNER_SIZE = 40;
+
+void handleTouchPress(bool btNow) {
+    static bool fingerDown = false;
+    static bool inCorner = false;
+    static unsigned long touchDownTime = 0;
+    static unsigned long lastFireTime = 0;
+    static int litButton = -1;
+
+    bool isTouching = touch.touched();
+    TS_Point p;
+    if (isTouching) {
+        p = touch.getPoint();
+        if (p.z < touchPressureThreshold) isTouching = false;
+    }
+
+    if (!isTouching) {
+        if (litButton >= 0) btnMgr.setHighlight(litButton, false);
+        litButton = -1;
+        fingerDown = false;
+        return;
+    }
+    uint32_t touchUs = (uint32_t)esp_timer_get_time();
+
+    if (fingerDown) {
+        if (inCorner && millis() - touchDownTime >= 2000) {
+            fingerDown = false;
+            enterQuickSettings();
+        }
+        return;
+    }
+
+    fingerDown = true;
+    touchDownTime = millis();
+    int x = constrain(map(p.x, 433, 3527, 0, SCREEN_WIDTH), 0, SCREEN_WIDTH - 1);
+    int y = constrain(map(p.y, 566, 3554, 0, SCREEN_HEIGHT), 0, SCREEN_HEIGHT - 1);
+    inCorner = (x >= SCREEN_WIDTH - QS_CORNER_SIZE && y < QS_CORNER_SIZE);
+    if (inCorner || !btNow || millis() - lastFireTime < retriggerMs) return;
+
+    int id = btnMgr.buttonAt(x, y);
+    if (id < 0) return;
+    lastFireTime = millis();
+    lastTouchTime = lastFireTime;
+    fireButton(id, touchUs);
+
+    // Highlight stays on while the finger is down (no blocking flash)
+    if (litButton >= 0 && litButton != id) btnMgr.setHighlight(litButton, false);
+    btnMgr.setHighlight(id, true);
+    litButton = id;
+}
+
 void handleNormal() {
     // Detect end of playback → restore idle LED
     static bool wasPlaying = false;
     bool nowPlaying = audioPlayer.isPlaying();
     if (wasPlaying && !nowPlaying) {
         setLED(0, 0, 0);  // playback ended → LED off
+
+        // Report SD stream headroom now that the callback is idle
+        // (deferred log - a UART write here would hold up the next tap)
+        for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+            LatencySummary ls = latencySummary(stage);
+            ALOG_INFO(LOG_STATS_LATENCY, latencyStageName(stage), ls.count, ls.p50Us, ls.p95Us,
+                      ls.p99Us, ls.maxUs);
+        }
+
+        ProfilerStats ps;
+        profilerSnapshot(ps);
+        uint64_t busyUs = ps.readUs + ps.processUs;
+        ALOG_INFO(LOG_STATS_CALLBACK, nullptr, ps.calls, ps.minUs, ps.avgUs, ps.maxUs,
+                  busyUs ? (int32_t)(ps.readUs * 100 / busyUs) : 0, ps.underruns);
+        if (ps.bedCyclesPerFrame) {
+            ALOG_INFO(LOG_STATS_BED, nullptr, ps.bedCyclesPerFrame, (int32_t)(ps.bedUs / 1000));
+        }
+
+        AudioPlayer::StreamStats st = audioPlayer.getStreamStats();
+        ALOG_INFO(LOG_STATS_STREAM, nullptr, st.minFill, st.capacity, st.underruns, st.underrunFrames);
+        audioPlayer.resetStreamStats();
+
+        ClipCache::Stats cs = audioPlayer.getClipCacheStats();
+        ALOG_INFO(LOG_STATS_CACHE, nullptr, cs.clips, cs.used / 1024, cs.budget / 1024,
+                  cs.hits, cs.misses, cs.evictions);
     }
     wasPlaying = nowPlaying;
 
-    if (nowPlaying) {
-        delay(10);
-        return;
-    }
+    // Open the next file of any button sequence while the current one plays
+    audioPlayer.updateSequences();
+
+    // Verify pass finished - it may have measured files copied on a PC
+    static bool wasVerifying = true;
+    bool verifyingNow = jingleCatalog.isVerifying();
+    if (wasVerifying && !verifyingNow) resolveButtons();
+    wasVerifying = verifyingNow;
 
-    audioPlayer.checkAndReconnectWiFi();
+    // Touch stays live during playback so jingles can overlap or retrigger
+    if (!nowPlaying) {
+        audioPlayer.checkAndReconnectWiFi();
+    }
 
     // React to BT connect/disconnect events
     static bool lastBTState = false;
@@ -718,6 +935,12 @@ void handleNormal() {
         if (btNow) {
             setLED(0, 0, 0);  // reconnected → LED off
             btnMgr.draw();
+
+            // Walk-in bed starts with the first connection and keeps looping
+            String bedFile = configMgr.getBedFile();
+            if (sdCardAvailable && bedFile.length() && !audioPlayer.isBedPlaying()) {
+                audioPlayer.playBed(bedFile);
+            }
         } else {
             setLED(255, 0, 0);  // disconnected → red
             tft.fillScreen(TFT_BLACK);
@@ -727,8 +950,23 @@ void handleNormal() {
         }
     }
 
+    // Looping buttons stay lit while their loop runs (also when a choke or
+    // a stop ended it rather than a second press). Not over the BT screen.
+    for (int id = 0; btNow && id < 8; id++) {
+        if (!buttonSettings[id].loop) continue;
+        bool on = audioPlayer.isButtonPlaying(id);
+        if (on != btnMgr.isLatched(id)) btnMgr.setLatched(id, on);
+    }
+
+    if (triggerOnPress) {
+        handleTouchPress(btNow);
+        return;
+    }
+
     // Touch state machine: short tap fires jingle, long press (2s) opens Quick Settings
-    // Key: record button on finger-DOWN, fire on finger-UP only if < 2s held
+    // Key: record button on finger-DOWN, fire on finger-UP only if < 2s held.
+    // The finger-down also starts prefetching the jingle, so the SD open and
+    // header parse are done by the time the finger lifts.
     static bool fingerDown = false;
     static unsigned long touchDownTime = 0;
     static int pendingButtonId = -1;
@@ -746,14 +984,17 @@ void handleNormal() {
             touchDownTime = millis();
             pendingButtonId = (btNow && millis() - lastTouchTime > TOUCH_DEBOUNCE)
                 ? btnMgr.checkTouch() : -1;
+            // No prefetch for a loop this tap will stop
+            if (pendingButtonId >= 0 && buttonSettings[pendingButtonId].count &&
+                !(buttonSettings[pendingButtonId].loop && audioPlayer.isButtonPlaying(pendingButtonId))) {
+                audioPlayer.prefetch(buttonSettings[pendingButtonId].files[0], buttonSettings[pendingButtonId].startMs);
+            }
         } else if (millis() - touchDownTime >= 2000) {
             // Long press threshold reached → Quick Settings
             fingerDown = false;
             pendingButtonId = -1;
-            lastTouchTime = millis();
-            currentState = STATE_QUICK_SETTINGS;
-            setLED(255, 180, 0);  // yellow = settings
-            drawQuickSettingsScreen();
+            audioPlayer.cancelPrefetch();
+            enterQuickSettings();
             return;
         }
         // still holding – wait
@@ -763,12 +1004,9 @@ void handleNormal() {
             fingerDown = false;
             if (pendingButtonId >= 0) {
                 lastTouchTime = millis();
+                // Latency is measured from the lift, which is what fires here
+                fireButton(pendingButtonId, (uint32_t)esp_timer_get_time());
                 btnMgr.highlightButton(pendingButtonId);
-                String filepath = btnMgr.getButtonFile(pendingButtonId);
-                if (filepath.length() > 0 && SD.exists(filepath)) {
-                    setLEDHex(configMgr.getButtonColor(pendingButtonId));
-                    audioPlayer.playFile(filepath);
-                }
             }
             pendingButtonId = -1;
         }
@@ -0,0 +1,130 @@
+#include "pcm_convert.h"
+#include "wav_format.h"
+
+// ── Sample decoders (little endian) ──────────────────────────────────────────
+
+static inline int16_t decodeU8(const uint8_t* p) {
+    return (int16_t)((p[0] ^ 0x80) << 8);
+}
+
+static inline int16_t decodeS16(const uint8_t* p) {
+    return (int16_t)(p[0] | (p[1] << 8));
+}
+
+// Wider formats decode to left-aligned int32 and go through dither16()
+static inline int32_t decodeS24(const uint8_t* p) {
+    return (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24));
+}
+
+static inline int32_t decodeS32(const uint8_t* p) {
+    return (int32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+static inline int32_t decodeF32(const uint8_t* p) {
+    uint32_t bits = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    if (f >= 1.0f) return INT32_MAX;
+    if (f <= -1.0f) return INT32_MIN;
+    if (f != f) return 0;  // NaN
+    return (int32_t)(f * 2147483648.0f);
+}
+
+// TPDF dither: difference of two uniform 16-bit values, +-1 LSB at 16 bits
+static inline int16_t dither16(int32_t v, uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    int32_t tpdf = (int32_t)(state & 0xFFFF) - (int32_t)(state >> 16);
+    int64_t s = ((int64_t)v + tpdf + 0x8000) >> 16;
+    return (int16_t)(s > 32767 ? 32767 : (s < -32768 ? -32768 : s));
+}
+
+// ── Block converters ──────────────────────────────────────────────────────────
+
+static void convU8Mono(const uint8_t* src, int16_t* dst, int frames, uint32_t&) {
+    for (int i = 0; i < frames; i++) {
+        int16_t s = decodeU8(src + i);
+        dst[2 * i] = s;
+        dst[2 * i + 1] = s;
+    }
+}
+
+static void convU8Stereo(const uint8_t* src, int16_t* dst, int frames, uint32_t&) {
+    for (int i = 0; i < frames * 2; i++) {
+        dst[i] = decodeU8(src + i);
+    }
+}
+
+static void convS16Mono(const uint8_t* src, int16_t* dst, int frames, uint32_t&) {
+    for (int i = 0; i < frames; i++) {
+        int16_t s = decodeS16(src + 2 * i);
+        dst[2 * i] = s;
+        dst[2 * i + 1] = s;
+    }
+}
+
+static void convS16Stereo(const uint8_t* src, int16_t* dst, int frames, uint32_t&) {
+    // Already the output layout (ESP32 is little endian)
+    memcpy(dst, src, frames * 4);
+}
+
+static void convS24Mono(const uint8_t* src, int16_t* dst, int frames, uint32_t& dither) {
+    for (int i = 0; i < frames; i++) {
+        int16_t s = dither16(decodeS24(src + 3 * i), dither);
+        dst[2 * i] = s;
+        dst[2 * i + 1] = s;
+    }
+}
+
+static void convS24Stereo(const uint8_t* src, int16_t* dst, int frames, uint32_t& dither) {
+    for (int i = 0; i < frames * 2; i++) {
+        dst[i] = dither16(decodeS24(src + 3 * i), dither);
+    }
+}
+
+static void convS32Mono(const uint8_t* src, int16_t* dst, int frames, uint32_t& dither) {
+    for (int i = 0; i < frames; i++) {
+        int16_t s = dither16(decodeS32(src + 4 * i), dither);
+        dst[2 * i] = s;
+        dst[2 * i + 1] = s;
+    }
+}
+
+static void convS32Stereo(const uint8_t* src, int16_t* dst, int frames, uint32_t& dither) {
+    for (int i = 0; i < frames * 2; i++) {
+        dst[i] = dither16(decodeS32(src + 4 * i), dither);
+    }
+}
+
+static void convF32Mono(const uint8_t* src, int16_t* dst, int frames, uint32_t& dither) {
+    for (int i = 0; i < frames; i++) {
+        int16_t s = dither16(decodeF32(src + 4 * i), dither);
+        dst[2 * i] = s;
+        dst[2 * i + 1] = s;
+    }
+}
+
+static void convF32Stereo(const uint8_t* src, int16_t* dst, int frames, uint32_t& dither) {
+    for (int i = 0; i < frames * 2; i++) {
+        dst[i] = dither16(decodeF32(src + 4 * i), dither);
+    }
+}
+
+PcmConvertFn pcmSelectConverter(uint16_t format, uint16_t bitsPerSample, uint16_t channels) {
+    if (channels != 1 && channels != 2) return nullptr;
+    bool mono = (channels == 1);
+
+    if (format == WAV_FORMAT_FLOAT) {
+        return bitsPerSample == 32 ? (mono ? convF32Mono : convF32Stereo) : nullptr;
+    }
+    if (format != WAV_FORMAT_PCM) return nullptr;
+
+    switch (bitsPerSample) {
+        case 8:  return mono ? convU8Mono  : convU8Stereo;
+        case 16: return mono ? convS16Mono : convS16Stereo;
+        case 24: return mono ? convS24Mono : convS24Stereo;
+        case 32: return mono ? convS32Mono : convS32Stereo;
+        default: return nullptr;
+    }
+}
@@ -0,0 +1,98 @@
+#include "resampler.h"
+#include "resampler_coeffs.h"
+#include <string.h>
+
+Resampler::Resampler()
+    : coeffs(nullptr), taps(0), phaseShift(0), stepInt(1), stepFrac(0), bypass(true),
+      histFrames(0), pos(0), frac(0) {
+}
+
+bool Resampler::supports(uint32_t inRate) {
+    return inRate >= 8000 && inRate <= 48000;
+}
+
+bool Resampler::configure(uint32_t inRate, uint32_t outRate, Quality quality) {
+    if (!supports(inRate) || outRate == 0) return false;
+
+    bypass = (inRate == outRate);
+    bool down = inRate > outRate;
+
+    switch (quality) {
+        case QUALITY_LOW:
+            coeffs = RS_LOW_UP;  // Linear interpolation has no cutoff to move
+            taps = RS_LOW_TAPS;
+            phaseShift = 32 - RS_LOW_PHASE_BITS;
+            break;
+        case QUALITY_HIGH:
+            coeffs = down ? RS_HIGH_DOWN : RS_HIGH_UP;
+            taps = RS_HIGH_TAPS;
+            phaseShift = 32 - RS_HIGH_PHASE_BITS;
+            break;
+        default:
+            coeffs = down ? RS_MEDIUM_DOWN : RS_MEDIUM_UP;
+            taps = RS_MEDIUM_TAPS;
+            phaseShift = 32 - RS_MEDIUM_PHASE_BITS;
+            break;
+    }
+
+    uint64_t step = ((uint64_t)inRate << 32) / outRate;
+    stepInt = (uint32_t)(step >> 32);
+    stepFrac = (uint32_t)step;
+
+    reset();
+    return true;
+}
+
+void Resampler::reset() {
+    // Pre-roll so the first output frame is centred on the first input frame
+    histFrames = taps / 2 - 1;
+    if (histFrames < 0) histFrames = 0;
+    memset(hist, 0, histFrames * 2 * sizeof(int16_t));
+    pos = 0;
+    frac = 0;
+}
+
+int Resampler::space() const {
+    return MAX_TAPS + BLOCK_FRAMES - histFrames;
+}
+
+void Resampler::push(const int16_t* in, int frames) {
+    if (frames > space()) frames = space();
+    memcpy(hist + histFrames * 2, in, frames * 2 * sizeof(int16_t));
+    histFrames += frames;
+}
+
+int Resampler::pull(int16_t* out, int maxFrames) {
+    int produced = 0;
+
+    while (produced < maxFrames && pos + taps <= histFrames) {
+        const int16_t* h = coeffs + (frac >> phaseShift) * taps;
+        const int16_t* x = hist + pos * 2;
+        int32_t accL = 0;
+        int32_t accR = 0;
+        for (int k = 0; k < taps; k++) {
+            accL += h[k] * x[2 * k];
+            accR += h[k] * x[2 * k + 1];
+        }
+        // Q14 coefficients, round and saturate back to int16
+        accL = (accL + (1 << 13)) >> 14;
+        accR = (accR + (1 << 13)) >> 14;
+        out[2 * produced]     = (int16_t)(accL > 32767 ? 32767 : (accL < -32768 ? -32768 : accL));
+        out[2 * produced + 1] = (int16_t)(accR > 32767 ? 32767 : (accR < -32768 ? -32768 : accR));
+        produced++;
+
+        uint32_t prev = frac;
+        frac += stepFrac;
+        pos += stepInt + (frac < prev ? 1 : 0);
+    }
+
+    // Drop consumed input, keep the filter history
+    int drop = pos < histFrames ? pos : histFrames;
+    if (drop > 0) {
+        memmove(hist, hist + drop * 2, (histFrames - drop) * 2 * sizeof(int16_t));
+        histFrames -= drop;
+        pos -= drop;
+    }
+
+    return produced;
+}
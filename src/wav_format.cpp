@@ -0,0 +1,108 @@
+#include "wav_format.h"
+#include "ima_adpcm.h"
+
+static uint16_t le16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t le32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool wavReadInfo(File& file, WavInfo& info) {
+    uint32_t fileSize = file.size();
+    uint8_t hdr[40];
+
+    file.seek(0);
+    if (fileSize < 12 || file.read(hdr, 12) != 12) return false;
+    if (memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0) return false;
+
+    bool haveFmt = false;
+    bool haveData = false;
+    uint32_t factFrames = 0;
+    info.loopStart = 0;
+    info.loopEnd = 0;
+    uint64_t offset = 12;
+    int chunks = 0;
+
+    // A file of empty chunks would otherwise cost one SD seek per 8 bytes
+    while (offset + 8 <= fileSize && chunks++ < WAV_MAX_CHUNKS) {
+        file.seek(offset);
+        if (file.read(hdr, 8) != 8) break;
+        uint32_t chunkSize = le32(hdr + 4);
+
+        if (memcmp(hdr, "fmt ", 4) == 0 && !haveFmt) {
+            // Only the first: a later one would change the format under
+            // frames and blockAlign already derived from this one
+            if (chunkSize < 16) return false;
+            size_t n = min(chunkSize, (uint32_t)sizeof(hdr));
+            if (file.read(hdr, n) != n) return false;
+
+            info.format = le16(hdr);
+            info.channels = le16(hdr + 2);
+            info.sampleRate = le32(hdr + 4);
+            info.blockAlign = le16(hdr + 12);
+            info.bitsPerSample = le16(hdr + 14);
+            if (info.channels == 0 || info.sampleRate == 0) return false;
+
+            // WAVE_FORMAT_EXTENSIBLE: real format is the first two bytes of
+            // the SubFormat GUID
+            if (info.format == WAV_FORMAT_EXTENSIBLE) {
+                if (n < 26) return false;
+                info.format = le16(hdr + 24);
+            }
+            haveFmt = true;
+        } else if (memcmp(hdr, "fact", 4) == 0 && chunkSize >= 4) {
+            // Sample count for compressed formats
+            if (file.read(hdr, 4) != 4) return false;
+            factFrames = le32(hdr);
+        } else if (memcmp(hdr, "smpl", 4) == 0 && chunkSize >= 36 + 24) {
+            // Sampler header, then the loop list: only the first loop is
+            // used. Its end is inclusive in the file, exclusive here.
+            if (file.read(hdr, 36) != 36) break;
+            if (le32(hdr + 28) > 0) {
+                if (file.read(hdr, 24) != 24) break;
+                if (le32(hdr + 4) == 0) {  // Forward loop
+                    info.loopStart = le32(hdr + 8);
+                    info.loopEnd = le32(hdr + 12) + 1;
+                }
+            }
+        } else if (memcmp(hdr, "data", 4) == 0 && !haveData) {
+            if (!haveFmt) return false;
+            info.dataOffset = offset + 8;
+            uint32_t actual = fileSize - info.dataOffset;
+            // Clamped - some encoders write 0 or 0xFFFFFFFF here
+            info.dataSize = (chunkSize == 0 || chunkSize > actual) ? actual : chunkSize;
+
+            if (info.blockAlign == 0) return false;
+            if (info.format == WAV_FORMAT_IMA_ADPCM) {
+                // Blocks of just a header would make every frame a header read
+                if (!ImaAdpcmDecoder::validBlockAlign(info.channels, info.blockAlign)) return false;
+                uint32_t spb = ImaAdpcmDecoder::samplesPerBlock(info.channels, info.blockAlign);
+                uint32_t blocks = (info.dataSize + info.blockAlign - 1) / info.blockAlign;
+                uint64_t frames = (uint64_t)blocks * spb;
+                info.frames = (frames > UINT32_MAX) ? UINT32_MAX : frames;
+                if (factFrames && factFrames < info.frames) info.frames = factFrames;
+            } else {
+                // The converters step by channels x sample size, not by
+                // blockAlign: a header that disagrees would have them read
+                // past each buffer
+                if (info.blockAlign != info.channels * (info.bitsPerSample / 8)) return false;
+                info.frames = info.dataSize / info.blockAlign;
+            }
+            haveData = true;
+            chunkSize = info.dataSize;
+        }
+
+        // Chunks are word aligned
+        offset += 8 + (uint64_t)chunkSize + (chunkSize & 1);
+    }
+
+    if (!haveData) return false;
+    if (info.loopEnd > info.frames || info.loopStart >= info.loopEnd) {
+        info.loopStart = 0;
+        info.loopEnd = 0;
+    }
+    file.seek(info.dataOffset);
+    return true;
+}
@@ -200,7 +200,16 @@ void SimpleServer::handle() {
 
 // ========== Settings Server (Settings Mode) ==========
 
-SettingsServer::SettingsServer() : server(80), lastActivityTime(0) {
+extern FlashJingles flashJingles;
+
+// Finished upload waiting for post-processing in loop()
+struct UploadJob {
+    char path[96];
+    bool adpcm;   // Re-encode as IMA-ADPCM first
+};
+
+SettingsServer::SettingsServer() : server(80), catalog(nullptr), lastActivityTime(0), flashUploadOk(false) {
+    uploadQueue = xQueueCreate(8, sizeof(UploadJob));
 }
 
 void SettingsServer::resetTimeout() {
@@ -211,9 +220,30 @@ unsigned long SettingsServer::getLastActivity() {
     return lastActivityTime;
 }
 
-void SettingsServer::begin(ConfigManager* mgr, AudioPlayer* player) {
+void SettingsServer::handle() {
+    UploadJob job;
+    if (!uploadQueue || xQueueReceive(uploadQueue, &job, 0) != pdTRUE) return;
+
+    // Runs in loop() rather than the async TCP task - encoding or analyzing
+    // a long file would trip that task's watchdog
+    String path = job.path;
+    if (job.adpcm) {
+        String tmpPath = path + ".tmp";
+        if (imaAdpcmEncodeFile(path, tmpPath)) {
+            SD.remove(path);
+            SD.rename(tmpPath, path);
+        } else {
+            SD.remove(tmpPath);  // Keep the original PCM file
+        }
+    }
+    if (catalog) catalog->update(path);
+    resetTimeout();
+}
+
+void SettingsServer::begin(ConfigManager* mgr, AudioPlayer* player, JingleCatalog* cat) {
     configMgr = mgr;
     audioPlayer = player;
+    catalog = cat;
 
     Serial.println("Initializing SPIFFS...");
     if (!SPIFFS.begin(false)) {
@@ -270,7 +300,7 @@ input[type="color"]{width:60px;height:40px;padding:2px;cursor:pointer}
 .btn-warning{background:#FF9800;color:#fff}
 .btn-small{padding:8px 16px;font-size:14px}
 .status{margin:20px 0;padding:10px;border-radius:4px;text-align:center}
-.button-config{display:grid;grid-template-columns:50px 1fr 1fr 80px 80px;gap:10px;align-items:center;margin:10px 0}
+.button-config{display:grid;grid-template-columns:50px 1fr 1fr 110px 75px 75px 60px 65px 80px 80px;gap:10px;align-items:center;margin:10px 0}
 .color-preview{width:40px;height:40px;border-radius:4px;border:2px solid #444}
 </style>
 </head><body>
@@ -309,9 +339,10 @@ input[type="color"]{width:60px;height:40px;padding:2px;cursor:pointer}
 <div class="card">
 <h2>File Upload</h2>
 <div class="form-group">
-<label>Upload Audio Files (WAV):</label>
-<input type="file" id="fileInput" multiple accept=".wav" onchange="keepalive()">
-<small style="color:#888">Only WAV files supported (44.1kHz, 16-bit, mono/stereo)</small>
+<label>Upload Audio Files (WAV or .jpk pack):</label>
+<input type="file" id="fileInput" multiple accept=".wav,.jpk" onchange="keepalive()">
+<small style="color:#888">Only WAV files supported (8-48kHz, 8/16/24/32-bit or float, mono/stereo)</small>
+<label style="margin-top:10px"><input type="checkbox" id="adpcmInput"> Compress to IMA-ADPCM (4x smaller, 16-bit sources)</label>
 </div>
 <button class="btn-primary" onclick="uploadFiles()">Upload Files</button>
 <div class="form-group" style="margin-top:20px">
@@ -319,6 +350,12 @@ input[type="color"]{width:60px;height:40px;padding:2px;cursor:pointer}
 <select id="fileList"></select>
 <button class="btn-warning" onclick="deleteSelectedFile()" style="margin-top:10px">Delete Selected File</button>
 </div>
+<div class="form-group" style="margin-top:20px">
+<label>Internal Flash (.jpk pack, replaces current contents):</label>
+<input type="file" id="flashInput" accept=".jpk" onchange="keepalive()">
+<small style="color:#888" id="flashInfo"></small>
+<button class="btn-primary" onclick="uploadFlash()" style="margin-top:10px">Write to Flash</button>
+</div>
 </div>
 <div class="card">
 <a href="/update" class="btn-primary">Firmware Update</a>
@@ -348,7 +385,16 @@ const html=config.buttons.map((b,i)=>`
 <div class="button-config">
 <div>${i+1}</div>
 <input type="text" id="label${i}" value="${b.label||''}" placeholder="Label" oninput="onButtonChange()">
-<select id="file${i}" onchange="onButtonChange()"></select>
+<select id="file${i}" onchange="onFileChange(${i})"></select>
+<select id="mode${i}" title="When pressed while other jingles play" onchange="onButtonChange()">
+<option value="choke" ${(b.mode||'choke')==='choke'?'selected':''}>Cut others</option>
+<option value="restart" ${b.mode==='restart'?'selected':''}>Restart</option>
+<option value="overlap" ${b.mode==='overlap'?'selected':''}>Overlap</option>
+</select>
+<input type="number" id="startMs${i}" min="0" value="${b.startMs||''}" placeholder="Start ms" title="Skip this much of the file (ms)" oninput="onButtonChange()">
+<input type="number" id="endMs${i}" min="0" value="${b.endMs||''}" placeholder="End ms" title="Stop at this point of the file (ms, empty = end)" oninput="onButtonChange()">
+<button class="btn-small" id="applyTrim${i}" style="visibility:hidden;padding:8px 4px" title="Use the trim proposed from the silence in the file" onclick="applyTrim(${i})">Apply</button>
+<input type="number" id="gainDb${i}" min="-24" max="12" step="0.5" value="${b.gainDb||''}" placeholder="dB" title="Button gain (dB)" oninput="onButtonChange()">
 <input type="color" id="color${i}" value="${b.color||'#4CAF50'}" title="Button Color" oninput="onButtonChange()">
 <input type="color" id="textColor${i}" value="${b.textColor||'#FFFFFF'}" title="Text Color" oninput="onButtonChange()">
 </div>`).join('');
@@ -384,15 +430,49 @@ console.log('Set textColor'+i+' to:',normalizedTextColor);
 }
 }
 }
+let trims={};
+async function loadTrims(){
+try{
+const r=await fetch('/api/catalog');
+if(!r.ok)return;
+const c=await r.json();
+trims={};
+for(const f of c.files)if(f.trimStartMs!==undefined)trims['/jingles/'+f.name]={startMs:f.trimStartMs,endMs:f.trimEndMs};
+}catch(e){console.error(e);}
+}
+// The proposal is only shown; the user's trim changes on Apply alone
+function showTrim(i){
+const t=trims[document.getElementById('file'+i).value];
+document.getElementById('startMs'+i).placeholder=t?'Start '+t.startMs:'Start ms';
+document.getElementById('endMs'+i).placeholder=t&&t.endMs?'End '+t.endMs:'End ms';
+document.getElementById('applyTrim'+i).style.visibility=t?'visible':'hidden';
+}
+function onFileChange(i){
+showTrim(i);
+onButtonChange();
+}
+function applyTrim(i){
+const t=trims[document.getElementById('file'+i).value];
+if(!t)return;
+document.getElementById('startMs'+i).value=t.startMs||'';
+document.getElementById('endMs'+i).value=t.endMs||'';
+onButtonChange();
+}
 async function loadFiles(){
 try{
+await loadTrims();
 const r=await fetch('/api/files');
 if(!r.ok)return;
 const files=await r.json();
+const fr=await fetch('/api/flash');
+const flash=fr.ok?await fr.json():{entries:[]};
+document.getElementById('flashInfo').textContent=flash.available?flash.entries.length+' jingles, '+Math.round(flash.capacity/1024)+' KB partition':'No jingle pack in flash';
+const paths=files.map(f=>'/jingles/'+f).concat(flash.entries.map(e=>'flash:'+e.name));
 for(let i=0;i<8;i++){
 const sel=document.getElementById('file'+i);
 if(sel){
-sel.innerHTML='<option value="">None</option>'+files.map(f=>`<option value="/jingles/${f}" ${config.buttons[i]&&config.buttons[i].file==='/jingles/'+f?'selected':''}>${f}</option>`).join('');
+sel.innerHTML='<option value="">None</option>'+paths.map(p=>`<option value="${p}" ${config.buttons[i]&&config.buttons[i].file===p?'selected':''}>${p.startsWith('flash:')?p:p.substring(9)}</option>`).join('');
+showTrim(i);
 }
 }
 const fileList=document.getElementById('fileList');
@@ -447,10 +527,32 @@ if(!files.length){showStatus('No files selected','#f44336');return;}
 const formData=new FormData();
 for(let f of files)formData.append('files',f);
 showStatus('Uploading...','#2196F3');
-const r=await fetch('/api/upload',{method:'POST',body:formData});
+const adpcm=document.getElementById('adpcmInput').checked?'?adpcm=1':'';
+const r=await fetch('/api/upload'+adpcm,{method:'POST',body:formData});
 showStatus(r.ok?'Uploaded!':'Upload failed',r.ok?'#4CAF50':'#f44336');
-if(r.ok)loadFiles();
 document.getElementById('fileInput').value='';
+if(!r.ok)return;
+loadFiles();
+// The device analyses uploads in the background; then offer the trims
+const names=Array.from(files).map(f=>'/jingles/'+f.name);
+setTimeout(async()=>{
+await loadTrims();
+const found=names.filter(n=>trims[n]).map(n=>n.substring(9)+' '+trims[n].startMs+'-'+(trims[n].endMs||'end')+' ms');
+for(let i=0;i<8;i++)showTrim(i);
+if(found.length)showStatus('Silence found, proposed trim: '+found.join(', '),'#2196F3');
+},3000);
+}
+async function uploadFlash(){
+keepalive();
+const f=document.getElementById('flashInput').files[0];
+if(!f){showStatus('No pack selected','#f44336');return;}
+const formData=new FormData();
+formData.append('pack',f);
+showStatus('Writing flash...','#2196F3');
+const r=await fetch('/api/flash/upload',{method:'POST',body:formData});
+showStatus(r.ok?'Flash written!':'Flash write failed',r.ok?'#4CAF50':'#f44336');
+if(r.ok)loadFiles();
+document.getElementById('flashInput').value='';
 }
 async function exitSettings(){
 await fetch('/api/exit',{method:'POST'});
@@ -473,10 +575,18 @@ btnSaveTimer=setTimeout(async ()=>{
 for(let i=0;i<8;i++){
 const labelEl=document.getElementById('label'+i);
 const fileEl=document.getElementById('file'+i);
+const modeEl=document.getElementById('mode'+i);
+const startEl=document.getElementById('startMs'+i);
+const endEl=document.getElementById('endMs'+i);
+const gainEl=document.getElementById('gainDb'+i);
 const colorEl=document.getElementById('color'+i);
 const textColorEl=document.getElementById('textColor'+i);
 if(labelEl)config.buttons[i].label=labelEl.value;
 if(fileEl)config.buttons[i].file=fileEl.value;
+if(modeEl)config.buttons[i].mode=modeEl.value;
+if(startEl)config.buttons[i].startMs=Math.max(0,parseInt(startEl.value)||0);
+if(endEl)config.buttons[i].endMs=Math.max(0,parseInt(endEl.value)||0);
+if(gainEl)config.buttons[i].gainDb=parseFloat(gainEl.value)||0;
 if(colorEl){
 config.buttons[i].color=colorEl.value;
 console.log('Saved color'+i+':',colorEl.value);
@@ -579,20 +689,28 @@ void SettingsServer::setupRoutes() {
               [this](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
         static String jsonBuffer;
 
+        // Refuse oversized bodies up front instead of buffering them
+        if (total > CONFIG_MAX_JSON_BYTES) {
+            if (index + len == total) request->send(413, "text/plain", "Config too large");
+            return;
+        }
+
         if (index == 0) {
             jsonBuffer = "";
+            jsonBuffer.reserve(total);
         }
 
-        for (size_t i = 0; i < len; i++) {
-            jsonBuffer += (char)data[i];
-        }
+        jsonBuffer.concat((const char*)data, len);
 
         if (index + len == total) {
             JsonDocument doc;
             DeserializationError error = deserializeJson(doc, jsonBuffer);
+            jsonBuffer = "";
 
             if (error) {
                 request->send(400, "text/plain", "Invalid JSON");
+            } else if (!ConfigManager::isValidConfig(doc)) {
+                request->send(400, "text/plain", "Invalid config");
             } else {
                 configMgr->saveConfig(doc);
                 request->send(200, "text/plain", "Config saved");
@@ -624,30 +742,165 @@ void SettingsServer::setupRoutes() {
         configMgr->exitSettingsMode();
     });
 
-    // API: List files on SD card
-    server.on("/api/files", HTTP_GET, [](AsyncWebServerRequest *request) {
-        File root = SD.open("/jingles");
-        if (!root || !root.isDirectory()) {
-            request->send(404, "text/plain", "Directory not found");
-            return;
-        }
-
+    // API: List files on SD card (from the catalog - no directory walk)
+    server.on("/api/files", HTTP_GET, [this](AsyncWebServerRequest *request) {
         String fileList = "[";
-        File file = root.openNextFile();
         bool first = true;
-        while (file) {
-            if (!file.isDirectory()) {
-                if (!first) fileList += ",";
-                fileList += "\"" + String(file.name()) + "\"";
-                first = false;
-            }
-            file = root.openNextFile();
+        for (const JingleCatalog::Entry& e : catalog->entries()) {
+            if (!first) fileList += ",";
+            fileList += "\"" + String(e.name) + "\"";
+            first = false;
         }
         fileList += "]";
 
         request->send(200, "application/json", fileList);
     });
 
+    // API: Catalog details (format, duration, levels) per file
+    server.on("/api/catalog", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        doc["verifying"] = catalog->isVerifying();
+        JsonArray files = doc["files"].to<JsonArray>();
+        for (const JingleCatalog::Entry& e : catalog->entries()) {
+            JsonObject f = files.add<JsonObject>();
+            f["name"] = e.name;
+            f["format"] = e.info.format;
+            f["channels"] = e.info.channels;
+            f["bits"] = e.info.bitsPerSample;
+            f["sampleRate"] = e.info.sampleRate;
+            f["dataOffset"] = e.info.dataOffset;
+            f["dataSize"] = e.info.dataSize;
+            f["durationMs"] = e.durationMs;
+            f["peak"] = e.peak;
+            f["rms"] = e.rms;
+            if (e.loudness != LOUDNESS_UNMEASURED) {
+                f["lufs"] = e.loudness / 10.0f;
+                f["truePeak"] = e.truePeak / 10.0f;
+            }
+            f["leadMs"] = e.leadMs;
+            f["tailMs"] = e.tailMs;
+            uint32_t startMs, endMs;
+            if (JingleCatalog::proposeTrim(e, startMs, endMs)) {
+                f["trimStartMs"] = startMs;
+                f["trimEndMs"] = endMs;
+            }
+        }
+        String json;
+        serializeJson(doc, json);
+        request->send(200, "application/json", json);
+    });
+
+    // API: Re-check the catalog against the card (files copied on a PC)
+    server.on("/api/catalog/rebuild", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        this->resetTimeout();
+        catalog->startVerify();
+        request->send(200, "text/plain", "Catalog rebuild started");
+    });
+
+    // API: Jingle pack in the internal flash partition
+    server.on("/api/flash", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        doc["available"] = flashJingles.isAvailable();
+        doc["capacity"] = flashJingles.capacity();
+        JsonArray entries = doc["entries"].to<JsonArray>();
+        for (const JPackEntry& e : flashJingles.entries()) {
+            JsonObject j = entries.add<JsonObject>();
+            j["name"] = e.name;
+            j["durationMs"] = (uint64_t)e.frames * 1000 / JPACK_SAMPLE_RATE;
+            j["peak"] = e.peak;
+            j["rms"] = e.rms;
+        }
+        String json;
+        serializeJson(doc, json);
+        request->send(200, "application/json", json);
+    });
+
+    // API: Trigger latency histograms from the last Normal Mode session
+    server.on("/api/latency", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        JsonArray bounds = doc["bucketUpperUs"].to<JsonArray>();
+        for (int b = 0; b < LATENCY_BUCKETS; b++) bounds.add(latencyBucketUpperUs(b));
+        JsonArray stages = doc["stages"].to<JsonArray>();
+        for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+            LatencySummary ls = latencySummary(stage);
+            JsonObject st = stages.add<JsonObject>();
+            st["name"] = latencyStageName(stage);
+            st["count"] = ls.count;
+            st["minUs"] = ls.minUs;
+            st["maxUs"] = ls.maxUs;
+            st["p50Us"] = ls.p50Us;
+            st["p95Us"] = ls.p95Us;
+            st["p99Us"] = ls.p99Us;
+            JsonArray buckets = st["buckets"].to<JsonArray>();
+            for (int b = 0; b < LATENCY_BUCKETS; b++) buckets.add(latencyBucketCount(stage, b));
+        }
+        String json;
+        serializeJson(doc, json);
+        request->send(200, "application/json", json);
+    });
+
+    server.on("/api/latency/reset", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        this->resetTimeout();
+        latencyReset();
+        request->send(200, "text/plain", "Latency histograms cleared");
+    });
+
+    // API: A2DP callback profile from the last Normal Mode session
+    server.on("/api/profile", HTTP_GET, [](AsyncWebServerRequest *request) {
+        ProfilerStats ps;
+        profilerSnapshot(ps);
+        JsonDocument doc;
+        doc["calls"] = ps.calls;
+        doc["framesRequested"] = ps.framesRequested;
+        doc["minUs"] = ps.minUs;
+        doc["avgUs"] = ps.avgUs;
+        doc["maxUs"] = ps.maxUs;
+        doc["readUs"] = ps.readUs;
+        doc["processUs"] = ps.processUs;
+        doc["underruns"] = ps.underruns;
+        doc["underrunFrames"] = ps.underrunFrames;
+        doc["paddingFrames"] = ps.paddingFrames;
+        doc["bedUs"] = ps.bedUs;
+        doc["bedCyclesPerFrame"] = ps.bedCyclesPerFrame;
+        JsonArray events = doc["underrunEvents"].to<JsonArray>();
+        for (int i = 0; i < ps.eventCount; i++) {
+            JsonObject e = events.add<JsonObject>();
+            e["timeMs"] = ps.events[i].timeMs;
+            e["voice"] = ps.events[i].voice;
+            e["button"] = ps.events[i].buttonId;
+            e["frames"] = ps.events[i].frames;
+            e["ringFill"] = ps.events[i].ringFill;
+        }
+        String json;
+        serializeJson(doc, json);
+        request->send(200, "application/json", json);
+    });
+
+    server.on("/api/profile/reset", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        this->resetTimeout();
+        profilerReset();
+        request->send(200, "text/plain", "Profile cleared");
+    });
+
+    // API: Replace the flash partition contents with an uploaded .jpk
+    server.on("/api/flash/upload", HTTP_POST,
+              [this](AsyncWebServerRequest *request) {
+                  if (flashUploadOk) {
+                      request->send(200, "text/plain", "Flash written");
+                  } else {
+                      request->send(500, "text/plain", "Flash write failed");
+                  }
+              },
+              [this](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
+                  this->resetTimeout();
+                  if (index == 0) {
+                      Serial.printf("Flash upload start: %s\n", filename.c_str());
+                      flashUploadOk = flashJingles.beginWrite();
+                  }
+                  if (flashUploadOk) flashUploadOk = flashJingles.write(data, len);
+                  if (final) flashUploadOk = flashJingles.endWrite() && flashUploadOk;
+              });
+
     // API: Delete file from SD card
     server.on("/api/files/delete", HTTP_POST, [this](AsyncWebServerRequest *request) {
         this->resetTimeout();
@@ -659,7 +912,13 @@ void SettingsServer::setupRoutes() {
         String filename = request->getParam("filename", true)->value();
         String filepath = "/jingles/" + filename;
 
+        if (filename.indexOf(JPACK_SEPARATOR) >= 0) {
+            request->send(400, "text/plain", "Pack entries can only be deleted with their pack");
+            return;
+        }
+
         if (SD.remove(filepath)) {
+            catalog->remove(filename);
             Serial.println("Deleted file: " + filepath);
             request->send(200, "text/plain", "File deleted");
         } else {
@@ -695,5 +954,13 @@ void SettingsServer::handleFileUpload(AsyncWebServerRequest *request, String fil
     if (final) {
         uploadFile.close();
         Serial.printf("Upload Complete: %s (%d bytes)\n", filename.c_str(), index + len);
+
+        // Optional 4:1 re-encode + catalog record, done later from loop()
+        if (uploadQueue) {
+            UploadJob job;
+            snprintf(job.path, sizeof(job.path), "/jingles/%s", filename.c_str());
+            job.adpcm = request->hasParam("adpcm");
+            xQueueSend(uploadQueue, &job, 0);
+        }
     }
 }
@@ -0,0 +1,104 @@
+// Render benchmarks: host time of the A2DP data callback per output frame
+// on the engine's main paths. Only the callback is timed; the stream task
+// refills the rings between calls, as it would on the other core.
+//
+//   bench_engine [--quick]
+//
+// Host numbers, for comparing changes against each other: the ESP32 runs
+// the same code roughly 20-50x slower.
+
+#include <chrono>
+#include "fixtures.h"
+#include "host_engine.h"
+#include "host_hal.h"
+
+static const int BLOCK_FRAMES = 128;
+static const uint32_t FADE_FRAMES = 100 * 44100 / 1000;  // audio_player.cpp's fade-in
+
+static AudioPlayer player;
+
+struct Timing {
+    uint64_t ns = 0;
+    uint64_t frames = 0;
+};
+
+static void timeBlocks(Timing& t, uint32_t frames) {
+    int16_t out[BLOCK_FRAMES * 2];
+    for (uint32_t done = 0; done < frames; done += BLOCK_FRAMES) {
+        int32_t n = min((uint32_t)BLOCK_FRAMES, frames - done);
+        hostRtosSettle();
+        auto start = std::chrono::steady_clock::now();
+        BluetoothA2DPSource::hostCallback((Frame*)out, n);
+        t.ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        t.frames += n;
+    }
+}
+
+static void drain() {
+    int16_t out[BLOCK_FRAMES * 2];
+    while (player.isPlaying()) hostRenderBlock(out, BLOCK_FRAMES);
+}
+
+static void report(const char* name, const Timing& t) {
+    double nsPerFrame = t.frames ? (double)t.ns / t.frames : 0;
+    printf("%-12s %9llu %10.1f %14.0f %10.0fx\n", name, (unsigned long long)t.frames, nsPerFrame,
+           nsPerFrame ? 1e9 / nsPerFrame : 0, nsPerFrame ? 1e9 / nsPerFrame / 44100 : 0);
+}
+
+// Steady state of a clip between its fades
+static Timing benchClip(const char* path, uint32_t frames) {
+    Timing t;
+    int16_t out[BLOCK_FRAMES * 2];
+    player.playFile(path);
+    for (uint32_t done = 0; done < FADE_FRAMES; done += BLOCK_FRAMES) hostRenderBlock(out, BLOCK_FRAMES);
+    timeBlocks(t, frames);
+    player.stop();
+    drain();
+    return t;
+}
+
+// Fade-in ramps only, replayed from the clip cache
+static Timing benchFade(const char* path, int plays) {
+    Timing t;
+    for (int i = 0; i < plays; i++) {
+        player.playFile(path);
+        timeBlocks(t, FADE_FRAMES - FADE_FRAMES % BLOCK_FRAMES);
+        player.stop();
+        drain();
+    }
+    return t;
+}
+
+static Timing benchTestTone() {
+    Timing t;
+    player.playTestSound();
+    timeBlocks(t, 44100 - 44100 % BLOCK_FRAMES);
+    drain();
+    return t;
+}
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && !strcmp(argv[1], "--quick");
+    uint32_t seconds = quick ? 1 : 20;
+    uint32_t frames = seconds * 44100;
+    uint32_t clipFrames = frames + 2 * FADE_FRAMES;
+
+    if (!hostEngineBegin(player, 1024 * 1024)) {
+        printf("Host engine setup failed\n");
+        return 1;
+    }
+    const std::string dir = hostSdRoot() + "/jingles/";
+    if (!writeWavFile(dir + "stereo.wav", fixtureSignal(clipFrames, 2, 16), 2, 16, 44100) ||
+        !writeWavFile(dir + "mono.wav", fixtureSignal(clipFrames, 1, 16), 1, 16, 44100) ||
+        !writeWavFile(dir + "fade.wav", fixtureSignal(FADE_FRAMES * 3, 2, 16), 2, 16, 44100)) {
+        printf("Fixture setup failed\n");
+        return 1;
+    }
+
+    printf("%-12s %9s %10s %14s %11s\n", "path", "frames", "ns/frame", "frames/sec", "realtime");
+    report("stereo", benchClip("/jingles/stereo.wav", frames));
+    report("mono", benchClip("/jingles/mono.wav", frames));
+    report("fade", benchFade("/jingles/fade.wav", quick ? 2 : 200));
+    report("test_tone", benchTestTone());
+    return 0;
+}
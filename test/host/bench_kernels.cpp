@@ -0,0 +1,179 @@
+// Kernel benchmarks: the DSP building blocks of the audio callback timed
+// on their own, on host data. Reports host ns and cycles per 44.1kHz
+// output frame (cycles from the x86 TSC, "-" elsewhere); on the ESP32 the
+// same numbers come from AudioPlayer::getMixerStats() and the profiler.
+//
+//   bench_kernels [--quick]
+
+#include <unistd.h>
+#include <chrono>
+#include <vector>
+#include <SD.h>
+#include "audio_mixer.h"
+#include "fixtures.h"
+#include "ima_adpcm.h"
+#include "pin_config.h"
+#include "resampler.h"
+#include "wav_format.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+static const int BLOCK_FRAMES = 256;  // audio_player.cpp's MIX_BLOCK_FRAMES
+static volatile int32_t sink;         // Keeps results observable
+
+struct Timing {
+    double nsPerFrame;
+    double cyclesPerFrame;
+};
+
+// Run fn(), which produces `frames` output frames, `reps` times. Best of
+// a few trials, so a scheduler hiccup doesn't show up as a slow kernel.
+template <typename Fn>
+static Timing timeFrames(uint64_t frames, int reps, Fn fn) {
+    fn();  // Warm caches and branch predictors
+    Timing best = {1e30, 1e30};
+    for (int trial = 0; trial < 5; trial++) {
+        auto start = std::chrono::steady_clock::now();
+#if HAVE_TSC
+        uint64_t tsc = __rdtsc();
+#endif
+        for (int r = 0; r < reps; r++) fn();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best.nsPerFrame = std::min(best.nsPerFrame, ns / (frames * reps));
+#if HAVE_TSC
+        best.cyclesPerFrame = std::min(best.cyclesPerFrame, (double)(__rdtsc() - tsc) / (frames * reps));
+#endif
+    }
+    return best;
+}
+
+static void report(const char* name, const Timing& t) {
+    char cycles[16] = "-";
+    if (HAVE_TSC) snprintf(cycles, sizeof(cycles), "%.1f", t.cyclesPerFrame);
+    printf("%-22s %10.2f %12s %14.0f\n", name, t.nsPerFrame, cycles, 1e9 / t.nsPerFrame);
+}
+
+// Clear, accumulate each voice at a non-unity gain, saturate to int16: the
+// per-block mix of the callback for 1 to 8 voices
+static void benchMixer(int reps) {
+    const int maxVoices = 8;
+    std::vector<std::vector<int16_t>> voices;
+    for (int v = 0; v < maxVoices; v++) {
+        std::vector<int32_t> s = fixtureSignal(BLOCK_FRAMES, 2, 16, v + 1);
+        voices.emplace_back(s.begin(), s.end());
+    }
+    std::vector<int32_t> acc(BLOCK_FRAMES * 2);
+    std::vector<int16_t> out(BLOCK_FRAMES * 2);
+
+    for (int n : {1, 2, 4, 8}) {
+        Timing t = timeFrames(BLOCK_FRAMES, reps, [&] {
+            mixClear(acc.data(), BLOCK_FRAMES * 2);
+            for (int v = 0; v < n; v++) mixAccumulate(acc.data(), voices[v].data(), 22938, BLOCK_FRAMES * 2);
+            mixToInt16(acc.data(), out.data(), BLOCK_FRAMES * 2);
+            sink = sink + out[n];
+        });
+        char name[32];
+        snprintf(name, sizeof(name), "mix %d voice%s", n, n > 1 ? "s" : "");
+        report(name, t);
+    }
+}
+
+// Push / pull through the polyphase filter the way renderVoice() does, per
+// quality level, for an upsampled and a downsampled rate
+static void benchResampler(int reps) {
+    static const char* qualityName[] = {"low", "medium", "high"};  // By Resampler::Quality
+    for (uint32_t rate : {22050u, 48000u}) {
+        const uint32_t inFrames = rate / 10;  // 100ms
+        std::vector<int32_t> s = fixtureSignal(inFrames, 2, 16, rate);
+        std::vector<int16_t> in(s.begin(), s.end());
+        std::vector<int16_t> out(BLOCK_FRAMES * 2);
+
+        for (int q = Resampler::QUALITY_LOW; q <= Resampler::QUALITY_HIGH; q++) {
+            Resampler rs;
+            rs.configure(rate, 44100, (Resampler::Quality)q);
+            uint64_t produced = 0;
+            auto run = [&] {
+                produced = 0;
+                uint32_t fed = 0;
+                while (fed < inFrames) {
+                    int n = min(rs.space(), (int)(inFrames - fed));
+                    rs.push(&in[fed * 2], n);
+                    fed += n;
+                    while (int got = rs.pull(out.data(), BLOCK_FRAMES)) produced += got;
+                }
+                sink = sink + out[0];
+            };
+            run();
+            Timing t = timeFrames(produced, reps, run);
+            char name[32];
+            snprintf(name, sizeof(name), "resample %u %s", (unsigned)rate, qualityName[q]);
+            report(name, t);
+        }
+    }
+}
+
+// Decode IMA-ADPCM in the stream task's read sizes (AUDIO_STREAM_CHUNK_BYTES
+// of ring space at a time), mono and stereo, per decoded frame. Fixtures
+// are encoded by the firmware's own encoder on a scratch SD directory.
+static void benchAdpcm(int reps) {
+    char dir[] = "/tmp/jingle_bench_XXXXXX";
+    if (!mkdtemp(dir)) return;
+    SD.hostMount(dir);
+
+    for (uint16_t channels = 1; channels <= 2; channels++) {
+        const uint32_t frames = 44100;
+        std::string name = "/adpcm" + std::to_string(channels);
+        std::vector<uint8_t> data;
+        WavInfo info;
+        if (writeWavFile(dir + name + ".wav", fixtureSignal(frames, channels, 16, channels), channels, 16, 44100) &&
+            imaAdpcmEncodeFile((name + ".wav").c_str(), (name + ".ima").c_str())) {
+            File f = SD.open((name + ".ima").c_str());
+            if (f && wavReadInfo(f, info)) {
+                data.resize(info.dataSize);
+                data.resize(f.read(data.data(), data.size()));
+            }
+            f.close();
+            SD.remove((name + ".wav").c_str());
+            SD.remove((name + ".ima").c_str());
+        }
+        if (data.empty()) {
+            printf("ADPCM fixture failed\n");
+            continue;
+        }
+
+        const int maxFrames = AUDIO_STREAM_CHUNK_BYTES / (channels * 2);
+        std::vector<int16_t> pcm(AUDIO_STREAM_CHUNK_BYTES / 2);  // audio_player.cpp's adpcmBuf
+        ImaAdpcmDecoder dec;
+        uint64_t decoded = 0;
+        auto run = [&] {
+            dec.begin(info.channels, info.blockAlign);
+            decoded = 0;
+            for (size_t at = 0; at < data.size();) {
+                size_t want = min(dec.nextReadSize(maxFrames, AUDIO_STREAM_CHUNK_BYTES), data.size() - at);
+                if (want == 0) break;
+                decoded += dec.decode(&data[at], want, pcm.data());
+                at += want;
+            }
+            sink = sink + pcm[0];
+        };
+        run();
+        Timing t = timeFrames(decoded, reps, run);
+        report(channels == 1 ? "adpcm decode mono" : "adpcm decode stereo", t);
+    }
+    rmdir(dir);
+}
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && !strcmp(argv[1], "--quick");
+    int reps = quick ? 10 : 20000;  // Blocks per trial
+
+    printf("%-22s %10s %12s %14s\n", "kernel", "ns/frame", "cycles/frame", "frames/sec");
+    benchMixer(reps);
+    benchResampler(max(1, reps / 200));
+    benchAdpcm(max(1, reps / 1000));
+    return 0;
+}
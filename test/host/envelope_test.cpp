@@ -0,0 +1,107 @@
+// AudioEnvelope golden values: the Q15 ramps are integer-only, so every
+// host and the ESP32 must produce exactly these samples
+//
+//   envelope_test
+
+#include <stdio.h>
+#include "audio_envelope.h"
+
+static int failures = 0;
+
+static void expect(const char* what, long got, long want) {
+    if (got == want) return;
+    printf("FAIL %s: %ld, expected %ld\n", what, got, want);
+    failures++;
+}
+
+// Run frames of full-scale input through env, returning the output of
+// frame `at` (the last one if at < 0)
+static int16_t runFrames(AudioEnvelope& env, int frames, int16_t in, int at = -1) {
+    int16_t picked = 0;
+    for (int f = 0; f < frames; f++) {
+        int16_t frame[2] = {in, in};
+        env.apply(frame, 1);
+        if (frame[0] != frame[1]) expect("channels equal", frame[1], frame[0]);
+        if (f == at || (at < 0 && f == frames - 1)) picked = frame[0];
+    }
+    return picked;
+}
+
+// 100ms fade-in at 44.1kHz, the engine's default
+static void rampEndpoints() {
+    AudioEnvelope env;
+    env.start(0, AudioEnvelope::UNITY, 4410);
+    expect("fade-in frame 0", runFrames(env, 1, 32767), 0);
+    expect("fade-in frame 1", runFrames(env, 1, 32767), 6);
+    expect("fade-in frame 2205", runFrames(env, 2204, 32767), 16382);
+    expect("fade-in frame 4409", runFrames(env, 2204, 32767), 32759);
+    expect("fade-in ramping at its last frame", env.isRamping(), 0);
+    expect("fade-in lands on unity", env.gain(), AudioEnvelope::UNITY);
+    expect("unity passes through", runFrames(env, 1, 32767), 32767);
+
+    // Block size doesn't matter: one apply() of the whole ramp, same samples
+    AudioEnvelope block;
+    int16_t buf[4411 * 2];
+    for (int16_t& s : buf) s = 32767;
+    block.start(0, AudioEnvelope::UNITY, 4410);
+    block.apply(buf, 4411);
+    expect("block frame 1", buf[2], 6);
+    expect("block frame 2205", buf[2205 * 2], 16382);
+    expect("block frame 4409", buf[4409 * 2], 32759);
+    expect("block frame 4410", buf[4410 * 2], 32767);
+}
+
+// Cut half-way through the fade-in: the fade-out starts where the gain is
+static void retriggerMidRamp() {
+    AudioEnvelope env;
+    env.start(0, AudioEnvelope::UNITY, 4410);
+    runFrames(env, 2205, 0);
+    expect("mid-ramp gain", env.gain(), 16383);
+
+    AudioEnvelope linear = env;
+    linear.rampTo(0, 4410);
+    expect("linear cut frame 0", runFrames(linear, 1, 32767), 16382);
+    expect("linear cut frame 4409", runFrames(linear, 4409, 32767), 2);
+    expect("linear cut at zero", runFrames(linear, 1, 32767), 0);
+
+    // Retrigger crossfade: switching to equal-power keeps the sounding gain
+    // (within the quarter-sine table's interpolation) and re-maps the position
+    env.setShape(AudioEnvelope::SHAPE_EQUAL_POWER);
+    expect("equal-power position", env.gain(), 10922);
+    env.rampTo(0, 882);
+    expect("crossfade frame 0", runFrames(env, 1, 32767), 16380);
+    expect("crossfade frame 441", runFrames(env, 441, 32767), 8479);
+    expect("crossfade frame 881", runFrames(env, 440, 32767), 17);
+    expect("crossfade frame 882", runFrames(env, 1, 32767), 0);
+}
+
+// A release from unity is silent after exactly its frame count
+static void releaseToZero() {
+    static const int16_t fullScale[] = {32767, -32768};
+    for (int16_t in : fullScale) {
+        AudioEnvelope env;
+        env.rampTo(0, 4410);
+        int firstZero = -1;
+        int16_t first = 0, last = 0;
+        for (int f = 0; f < 4420; f++) {
+            int16_t frame[2] = {in, in};
+            env.apply(frame, 1);
+            if (f == 0) first = frame[0];
+            if (f == 4409) last = frame[0];
+            if (frame[0] == 0 && firstZero < 0) firstZero = f;
+            if (firstZero >= 0 && frame[0] != 0) expect("silent after release", frame[0], 0);
+        }
+        expect("release frame 0", first, in);
+        expect("release frame 4409", last, in > 0 ? 6 : -7);
+        expect("release frames to zero", firstZero, 4410);
+        expect("release gain", env.gain(), 0);
+    }
+}
+
+int main() {
+    rampEndpoints();
+    retriggerMidRamp();
+    releaseToZero();
+    printf("%d failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
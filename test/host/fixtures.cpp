@@ -0,0 +1,64 @@
+#include "fixtures.h"
+#include <stdio.h>
+
+std::vector<int32_t> fixtureSignal(uint32_t frames, uint16_t channels, uint16_t bitsPerSample, uint32_t seed) {
+    const int32_t full = (1 << (bitsPerSample - 1)) - 1;
+    const int32_t amp = full / 2;  // Each of the two parts, so the sum never clips
+    std::vector<int32_t> out(frames * channels);
+    uint32_t lcg = seed;
+    for (uint32_t i = 0; i < frames; i++) {
+        for (uint16_t c = 0; c < channels; c++) {
+            uint32_t period = 100 + 37 * c;  // 441Hz / 321Hz at 44.1kHz
+            uint32_t p = i % period;
+            int64_t tri = p < period / 2 ? (int64_t)p * 4 - period : (int64_t)(period - p) * 4 - period;
+            lcg = lcg * 1664525u + 1013904223u;
+            int32_t noise = (int32_t)(lcg >> 8) % (amp / 8 + 1);
+            out[i * channels + c] = (int32_t)(tri * amp / period) + noise;
+        }
+    }
+    return out;
+}
+
+static void put16(FILE* f, uint32_t v) {
+    fputc(v & 0xFF, f);
+    fputc((v >> 8) & 0xFF, f);
+}
+
+static void put32(FILE* f, uint32_t v) {
+    put16(f, v & 0xFFFF);
+    put16(f, v >> 16);
+}
+
+bool writeWavFile(const std::string& path, const std::vector<int32_t>& samples, uint16_t channels,
+                  uint16_t bitsPerSample, uint32_t sampleRate) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    uint16_t bytes = bitsPerSample / 8;
+    uint32_t dataSize = (uint32_t)samples.size() * bytes;
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + dataSize);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16);
+    put16(f, 1);
+    put16(f, channels);
+    put32(f, sampleRate);
+    put32(f, sampleRate * channels * bytes);
+    put16(f, channels * bytes);
+    put16(f, bitsPerSample);
+    fwrite("data", 1, 4, f);
+    put32(f, dataSize);
+    for (int32_t s : samples) {
+        for (uint16_t b = 0; b < bytes; b++) fputc(((uint32_t)s >> (8 * b)) & 0xFF, f);
+    }
+    return fclose(f) == 0;
+}
+
+uint32_t crc32(const void* data, size_t len, uint32_t crc) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
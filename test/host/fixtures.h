@@ -0,0 +1,22 @@
+#ifndef HOST_FIXTURES_H
+#define HOST_FIXTURES_H
+
+// Deterministic test audio for the host harnesses: integer-only signal
+// generators (the same bits on every host) and a WAV writer
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Interleaved samples at full scale for the bit depth: triangle waves of a
+// different period per channel plus a little LCG noise
+std::vector<int32_t> fixtureSignal(uint32_t frames, uint16_t channels, uint16_t bitsPerSample,
+                                   uint32_t seed = 1);
+
+// PCM WAV (16 / 24 bit) of samples. Returns false if the file can't be written.
+bool writeWavFile(const std::string& path, const std::vector<int32_t>& samples, uint16_t channels,
+                  uint16_t bitsPerSample, uint32_t sampleRate);
+
+uint32_t crc32(const void* data, size_t len, uint32_t crc = 0);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef HOST_FUZZ_H
+#define HOST_FUZZ_H
+
+// Shared by the fuzz targets. Each target defines LLVMFuzzerTestOneInput()
+// and runs under libFuzzer (JINGLE_FUZZ with Clang) or fuzz_main.cpp.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+// A parser broke a promise it makes to its callers: report and crash, so
+// the fuzzer keeps the input
+#define FUZZ_CHECK(cond)                                                              \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            fprintf(stderr, "%s:%d: FUZZ_CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            abort();                                                                  \
+        }                                                                             \
+    } while (0)
+
+// Mounts SD on a scratch directory (with /jingles) the first time
+void fuzzMountSd();
+
+// Replaces the scratch SD file at path with data
+bool fuzzWriteFile(const char* path, const uint8_t* data, size_t size);
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+#endif
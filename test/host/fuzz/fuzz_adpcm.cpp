@@ -0,0 +1,45 @@
+// IMA-ADPCM decoder on arbitrary data, read the way the stream task and
+// the catalog do: nextReadSize() bytes (or fewer) at a time into a buffer
+// of exactly maxFrames frames.
+//
+// Input: channels (1 byte), blockAlign (2, little endian), maxFrames (1),
+// then the compressed stream. The decoder is only ever set up with a
+// blockAlign that passed validBlockAlign(), so others are skipped.
+
+#include "fuzz.h"
+#include <vector>
+#include "ima_adpcm.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size < 4) return 0;
+    uint16_t channels = 1 + (data[0] & 1);
+    uint16_t blockAlign = data[1] | (data[2] << 8);
+    int maxFrames = 1 + data[3] * 8;
+    data += 4;
+    size -= 4;
+    if (!ImaAdpcmDecoder::validBlockAlign(channels, blockAlign)) return 0;
+
+    const size_t maxBytes = 2048;  // AUDIO_STREAM_CHUNK_BYTES
+    std::vector<int16_t> out(maxFrames * channels);
+    ImaAdpcmDecoder dec;
+    dec.begin(channels, blockAlign);
+
+    uint32_t spb = ImaAdpcmDecoder::samplesPerBlock(channels, blockAlign);
+    uint64_t frames = 0;
+    size_t at = 0;
+    while (at < size) {
+        size_t want = dec.nextReadSize(maxFrames, maxBytes);
+        FUZZ_CHECK(want <= maxBytes);
+        if (want == 0) break;
+        // Short reads (end of file, SD error) hand over less than asked
+        size_t n = std::min(want, size - at);
+        if (n > 1 && (data[at] & 0xF0) == 0xF0) n = 1 + data[at] % n;
+        int got = dec.decode(data + at, n, out.data());
+        FUZZ_CHECK(got >= 0 && got <= maxFrames);
+        frames += got;
+        at += n;
+    }
+    // Never more frames than whole and partial blocks can hold
+    FUZZ_CHECK(frames <= ((uint64_t)size / blockAlign + 1) * spb);
+    return 0;
+}
@@ -0,0 +1,23 @@
+#include "fuzz.h"
+#include <SD.h>
+#include <filesystem>
+
+static std::string sdRoot;
+
+void fuzzMountSd() {
+    if (!sdRoot.empty()) return;
+    char dir[] = "/tmp/jingle_fuzz_XXXXXX";
+    if (!mkdtemp(dir)) abort();
+    sdRoot = dir;
+    atexit([] { std::filesystem::remove_all(sdRoot); });
+    SD.hostMount(dir);
+    SD.mkdir("/jingles");
+}
+
+bool fuzzWriteFile(const char* path, const uint8_t* data, size_t size) {
+    File f = SD.open(path, FILE_WRITE);
+    if (!f) return false;
+    bool ok = f.write(data, size) == size;
+    f.close();
+    return ok;
+}
@@ -0,0 +1,63 @@
+// The stored config as ConfigManager reads it at boot (NVS string → JSON →
+// shape check/repair → the getters the rest of the firmware calls), and the
+// same bytes as the web UI posts them: whatever repairConfig() leaves must
+// pass isValidConfig(). Needs ArduinoJson (ARDUINOJSON_DIR)
+
+#include "fuzz.h"
+#include "config_manager.h"
+#include "pin_config.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    fuzzMountSd();
+    // NVS strings end at the first NUL
+    std::string json((const char*)data, strnlen((const char*)data, size));
+
+    Preferences prefs;
+    prefs.begin("jinglebox", false);
+    prefs.putString("config", String(json));
+    prefs.end();
+
+    ConfigManager config;
+    config.begin();
+    config.loadConfig();
+    FUZZ_CHECK(ConfigManager::isValidConfig(config.getConfig()));
+    for (int id = -1; id <= 8; id++) {
+        String files[AUDIO_SEQUENCE_MAX];
+        FUZZ_CHECK(config.getButtonSequence(id, files, AUDIO_SEQUENCE_MAX) <= AUDIO_SEQUENCE_MAX);
+        uint32_t start, end;
+        if (config.getButtonLoop(id, start, end)) FUZZ_CHECK(start <= end);
+        if (config.getButtonTrim(id, start, end)) FUZZ_CHECK(end == 0 || start < end);
+        int gain = config.getButtonGainDb(id);
+        FUZZ_CHECK(gain >= -240 && gain <= 120);
+        config.getButtonFile(id);
+        config.getButtonColor(id);
+        config.getButtonMode(id);
+        config.getButtonChokeGroup(id);
+    }
+    config.getBTDeviceName();
+    config.getBTDeviceMac();
+    config.getBrightness();
+    config.getTouchThreshold();
+    config.getResampleQuality();
+    config.getClipCacheKB();
+    config.getTriggerOnPress();
+    config.getRetriggerMs();
+    config.getCrossfadeMs();
+    int lufs = config.getLoudnessTarget();
+    FUZZ_CHECK(lufs == 0 || (lufs >= -400 && lufs <= -50));
+    config.getBedFile();
+    config.getBedLevel();
+    config.getDuckDb();
+    config.getDuckAttackMs();
+    config.getDuckReleaseMs();
+    config.getBTVolume();
+
+    if (size <= CONFIG_MAX_JSON_BYTES) {
+        JsonDocument doc;
+        if (!deserializeJson(doc, json) && doc.is<JsonObject>()) {
+            if (!ConfigManager::isValidConfig(doc)) ConfigManager::repairConfig(doc);
+            FUZZ_CHECK(ConfigManager::isValidConfig(doc));
+        }
+    }
+    return 0;
+}
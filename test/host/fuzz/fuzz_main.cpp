@@ -0,0 +1,190 @@
+// Driver for the fuzz targets where libFuzzer is not available (GCC, the
+// ctest smoke run): replays every corpus file given, directories
+// recursively, then optionally runs N mutations of them, and reports the
+// parse throughput of both passes.
+//
+//   fuzz_<target> [--mutate N] [--seed S] [--max-len BYTES] <file or dir>...
+//
+// If an input crashes the target, it is written to crash-input in the
+// working directory first, for replaying (fuzz_<target> crash-input) or
+// adding to the corpus.
+
+#include "fuzz.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+// Sanitizer reports end in abort(), so the SIGABRT handler saves the input
+extern "C" const char* __asan_default_options() { return "abort_on_error=1"; }
+extern "C" const char* __ubsan_default_options() { return "abort_on_error=1:print_stacktrace=1"; }
+
+static std::vector<uint8_t> current;  // Input being run, for the crash dump
+
+static void dumpInput() {
+    int fd = open("crash-input", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+    (void)!write(fd, current.data(), current.size());
+    close(fd);
+    static const char msg[] = "Input written to crash-input\n";
+    (void)!write(2, msg, sizeof(msg) - 1);
+}
+
+static void onSignal(int sig) {
+    dumpInput();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+// Leaves signals a sanitizer already handles to its report
+static void catchSignal(int sig) {
+    struct sigaction old;
+    if (sigaction(sig, nullptr, &old) == 0 && old.sa_handler == SIG_DFL) signal(sig, onSignal);
+}
+
+struct Throughput {
+    uint64_t inputs = 0;
+    uint64_t bytes = 0;
+    double seconds = 0;
+};
+
+static void run(const std::vector<uint8_t>& input, Throughput& t) {
+    current = input;
+    auto start = std::chrono::steady_clock::now();
+    LLVMFuzzerTestOneInput(current.data(), current.size());
+    t.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    t.inputs++;
+    t.bytes += input.size();
+}
+
+static void report(const char* pass, const Throughput& t) {
+    if (!t.inputs) return;
+    printf("%-8s %8llu inputs %10llu bytes %8.2fs %10.0f inputs/s %8.2f MB/s\n", pass,
+           (unsigned long long)t.inputs, (unsigned long long)t.bytes, t.seconds, t.inputs / t.seconds,
+           t.bytes / t.seconds / 1e6);
+}
+
+// ── Mutations ────────────────────────────────────────────────────────────────
+
+static uint64_t rngState = 1;
+
+static uint32_t rnd(uint32_t n) {  // 0..n-1, xorshift64*
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return n ? (uint32_t)((rngState * 0x2545F4914F6CDD1Dull) >> 32) % n : 0;
+}
+
+// Header fields are where parsers go wrong: sizes, counts and offsets
+// pushed to their edges
+static uint32_t interesting(size_t size) {
+    static const uint32_t values[] = {0, 1, 2, 4, 8, 16, 0x7F, 0x80, 0xFF, 0x100, 0x7FFF, 0x8000, 0xFFFF,
+                                      0x10000, 0x7FFFFFFF, 0x80000000u, 0xFFFFFFFFu, 44100, 48000};
+    uint32_t pick = rnd(sizeof(values) / sizeof(values[0]) + 2);
+    if (pick == sizeof(values) / sizeof(values[0])) return (uint32_t)size;
+    if (pick > sizeof(values) / sizeof(values[0])) return (uint32_t)size - rnd(16);
+    return values[pick];
+}
+
+static void mutate(std::vector<uint8_t>& d, size_t maxLen) {
+    for (int n = 1 + rnd(4); n > 0; n--) {
+        size_t size = d.size();
+        switch (rnd(7)) {
+            case 0:  // Flip a bit
+                if (size) d[rnd(size)] ^= 1 << rnd(8);
+                break;
+            case 1:  // Random byte
+                if (size) d[rnd(size)] = (uint8_t)rnd(256);
+                break;
+            case 2:  // Edge value in a 16-bit field
+                if (size >= 2) {
+                    size_t at = rnd(size - 1);
+                    uint32_t v = interesting(size);
+                    d[at] = v & 0xFF;
+                    d[at + 1] = (v >> 8) & 0xFF;
+                }
+                break;
+            case 3:  // Edge value in a 32-bit field
+                if (size >= 4) {
+                    size_t at = rnd(size - 3);
+                    uint32_t v = interesting(size);
+                    for (int b = 0; b < 4; b++) d[at + b] = (v >> (8 * b)) & 0xFF;
+                }
+                break;
+            case 4:  // Truncate
+                d.resize(rnd(size + 1));
+                break;
+            case 5:  // Drop a slice
+                if (size) {
+                    size_t at = rnd(size);
+                    d.erase(d.begin() + at, d.begin() + at + rnd(size - at + 1));
+                }
+                break;
+            case 6:  // Repeat a slice (chunk lists, tables)
+                if (size) {
+                    size_t at = rnd(size);
+                    size_t len = 1 + rnd(std::min(size - at, (size_t)256));
+                    std::vector<uint8_t> slice(d.begin() + at, d.begin() + at + len);
+                    d.insert(d.begin() + rnd(size + 1), slice.begin(), slice.end());
+                }
+                break;
+        }
+    }
+    if (d.size() > maxLen) d.resize(maxLen);
+}
+
+// ── Main ─────────────────────────────────────────────────────────────────────
+
+static void addInputs(const std::filesystem::path& path, std::vector<std::vector<uint8_t>>& corpus) {
+    std::vector<std::filesystem::path> files;
+    if (std::filesystem::is_directory(path)) {
+        for (auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+            if (entry.is_regular_file()) files.push_back(entry.path());
+        }
+        std::sort(files.begin(), files.end());  // Same order, same mutations
+    } else {
+        files.push_back(path);
+    }
+    for (auto& f : files) {
+        std::ifstream in(f, std::ios::binary);
+        corpus.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+}
+
+int main(int argc, char** argv) {
+    uint64_t mutations = 0;
+    size_t maxLen = 64 * 1024;
+    std::vector<std::vector<uint8_t>> corpus;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--mutate") && i + 1 < argc) mutations = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) rngState = strtoull(argv[++i], nullptr, 10) * 2 + 1;
+        else if (!strcmp(argv[i], "--max-len") && i + 1 < argc) maxLen = strtoull(argv[++i], nullptr, 10);
+        else addInputs(argv[i], corpus);
+    }
+    if (corpus.empty()) {
+        printf("usage: %s [--mutate N] [--seed S] [--max-len BYTES] <file or dir>...\n", argv[0]);
+        return 2;
+    }
+
+    signal(SIGABRT, onSignal);
+    catchSignal(SIGSEGV);
+    catchSignal(SIGFPE);
+    catchSignal(SIGBUS);
+
+    Throughput replay, mutated;
+    for (const auto& input : corpus) run(input, replay);
+    for (uint64_t n = 0; n < mutations; n++) {
+        std::vector<uint8_t> input = corpus[rnd(corpus.size())];
+        mutate(input, maxLen);
+        run(input, mutated);
+    }
+    report("replay", replay);
+    report("mutated", mutated);
+    return 0;
+}
@@ -0,0 +1,45 @@
+// Jingle packs: the table of contents from a file (SD) and from memory
+// (flash partition image), an entry lookup, and the catalog's pack pass
+
+#include "fuzz.h"
+#include <SD.h>
+#include "jingle_catalog.h"
+#include "jingle_pack.h"
+
+static JingleCatalog catalog;
+
+static void checkToc(const std::vector<JPackEntry>& toc, size_t size) {
+    FUZZ_CHECK(toc.size() <= JPACK_MAX_ENTRIES);
+    for (const JPackEntry& e : toc) {
+        FUZZ_CHECK(memchr(e.name, 0, JPACK_NAME_LEN) != nullptr);
+        FUZZ_CHECK((uint64_t)e.offset + e.size <= size);
+        FUZZ_CHECK((uint64_t)e.frames * JPACK_CHANNELS * 2 <= e.size);
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    fuzzMountSd();
+
+    std::vector<JPackEntry> toc;
+    if (packParseToc(data, size, toc)) checkToc(toc, size);
+
+    if (!fuzzWriteFile("/jingles/fuzz.jpk", data, size)) return 0;
+    File file = SD.open("/jingles/fuzz.jpk");
+    std::vector<JPackEntry> fileToc;
+    if (file && packReadToc(file, fileToc)) {
+        checkToc(fileToc, size);
+        if (!fileToc.empty()) {
+            WavInfo info;
+            if (packFindEntry(file, fileToc[0].name, info)) {
+                FUZZ_CHECK((uint64_t)info.dataOffset + info.dataSize <= size);
+                FUZZ_CHECK(file.position() == info.dataOffset);
+            }
+        }
+    }
+    file.close();
+
+    static bool begun = catalog.begin() || true;
+    (void)begun;
+    catalog.update("fuzz.jpk");
+    return 0;
+}
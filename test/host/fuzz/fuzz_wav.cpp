@@ -0,0 +1,37 @@
+// WAV headers as they reach the firmware: the parser itself, then the two
+// consumers that read the whole file on the header's word - the catalog
+// analysis (every upload and card scan) and the ADPCM upload converter
+
+#include "fuzz.h"
+#include <SD.h>
+#include "ima_adpcm.h"
+#include "jingle_catalog.h"
+#include "wav_format.h"
+
+static JingleCatalog catalog;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    fuzzMountSd();
+    if (!fuzzWriteFile("/jingles/fuzz.wav", data, size)) return 0;
+
+    File file = SD.open("/jingles/fuzz.wav");
+    WavInfo info;
+    if (file && wavReadInfo(file, info)) {
+        FUZZ_CHECK((uint64_t)info.dataOffset + info.dataSize <= size);
+        FUZZ_CHECK(file.position() == info.dataOffset);
+        FUZZ_CHECK(info.channels > 0 && info.blockAlign > 0 && info.sampleRate > 0);
+        FUZZ_CHECK(info.loopEnd == 0 || (info.loopStart < info.loopEnd && info.loopEnd <= info.frames));
+        if (info.format == WAV_FORMAT_IMA_ADPCM) {
+            FUZZ_CHECK(ImaAdpcmDecoder::validBlockAlign(info.channels, info.blockAlign));
+        } else {
+            FUZZ_CHECK((uint64_t)info.frames * info.blockAlign <= info.dataSize);
+        }
+    }
+    file.close();
+
+    static bool begun = catalog.begin() || true;
+    (void)begun;
+    catalog.update("fuzz.wav");
+    imaAdpcmEncodeFile("/jingles/fuzz.wav", "/jingles/fuzz.ima");
+    return 0;
+}
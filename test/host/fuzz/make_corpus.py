@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""Write the fuzz seed corpus (test/host/fuzz/corpus/<target>/).
+
+Small valid inputs that reach every branch of the parsers: each WAV
+format and chunk the firmware knows, ADPCM streams for both channel
+counts, packs as the pack builder writes them, and configs that use every
+button field. The fuzzers mutate from here. Deterministic, so the corpus
+only changes when this script does.
+
+Usage: python3 test/host/fuzz/make_corpus.py
+"""
+import json
+import os
+import struct
+
+OUT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "corpus")
+
+
+def signal(frames, channels, seed):
+    """Integer-only test signal: a sawtooth per channel."""
+    out = []
+    for i in range(frames):
+        for c in range(channels):
+            out.append(((i * (97 + 31 * c) + seed * 1000) % 65536) - 32768)
+    return out
+
+
+def chunk(tag, body):
+    pad = b"\0" if len(body) & 1 else b""
+    return tag + struct.pack("<I", len(body)) + body + pad
+
+
+def riff(*chunks):
+    body = b"WAVE" + b"".join(chunks)
+    return b"RIFF" + struct.pack("<I", len(body)) + body
+
+
+def fmt(format_tag, channels, rate, bits, block_align, extra=b""):
+    return chunk(b"fmt ", struct.pack("<HHIIHH", format_tag, channels, rate, rate * block_align,
+                                      block_align, bits) + extra)
+
+
+def smpl(start, end):
+    header = struct.pack("<9I", 0, 0, 22676, 60, 0, 0, 0, 1, 0)
+    loop = struct.pack("<6I", 0, 0, start, end - 1, 0, 0)  # End inclusive
+    return chunk(b"smpl", header + loop)
+
+
+def pcm16(samples):
+    return struct.pack("<%dh" % len(samples), *samples)
+
+
+def pcm24(samples):
+    return b"".join(struct.pack("<i", s * 256)[:3] for s in samples)
+
+
+def float32(samples):
+    return b"".join(struct.pack("<f", s / 32768.0) for s in samples)
+
+
+def adpcm_blocks(channels, block_align, blocks, seed):
+    """IMA-ADPCM blocks: valid headers, arbitrary nibbles."""
+    out = bytearray()
+    for b in range(blocks):
+        for c in range(channels):
+            out += struct.pack("<hBB", (b * 1000 + c * 300) % 30000, (b * 7 + c + seed) % 89, 0)
+        for i in range(block_align - 4 * channels):
+            out.append((i * 37 + b * 11 + seed) & 0xFF)
+    return bytes(out)
+
+
+def wavs():
+    s2 = signal(64, 2, 1)
+    s1 = signal(64, 1, 2)
+    ext_guid = struct.pack("<H", 1) + b"\0\0\0\0\x10\0\x80\0\0\xaa\0\x38\x9b\x71"
+    extensible = struct.pack("<HHI", 22, 16, 3) + ext_guid
+    yield "pcm16_stereo.wav", riff(fmt(1, 2, 44100, 16, 4), chunk(b"data", pcm16(s2)))
+    yield "pcm16_mono_22k.wav", riff(fmt(1, 1, 22050, 16, 2), chunk(b"data", pcm16(s1)))
+    yield "pcm24_48k.wav", riff(fmt(1, 2, 48000, 24, 6), chunk(b"data", pcm24(s2)))
+    yield "float32.wav", riff(fmt(3, 2, 44100, 32, 8), chunk(b"data", float32(s2)))
+    yield "extensible.wav", riff(fmt(0xFFFE, 2, 44100, 16, 4, extensible), chunk(b"data", pcm16(s2)))
+    yield "list_smpl.wav", riff(fmt(1, 2, 44100, 16, 4), chunk(b"LIST", b"INFOISFT\x03\0\0\0ab\0"),
+                                chunk(b"data", pcm16(s2)), smpl(8, 56))
+    yield "odd_data.wav", riff(fmt(1, 1, 44100, 8, 1), chunk(b"data", bytes(range(0, 255, 4))),
+                               chunk(b"junk", b"x"))
+    yield "unsized_data.wav", riff(fmt(1, 2, 44100, 16, 4)) + b"data" + b"\xff\xff\xff\xff" + pcm16(s2)
+    ima_fmt = struct.pack("<HH", 2, 505)
+    yield "ima_mono.wav", riff(fmt(0x11, 1, 44100, 4, 256, ima_fmt), chunk(b"fact", struct.pack("<I", 900)),
+                               chunk(b"data", adpcm_blocks(1, 256, 2, 1)), smpl(100, 800))
+    yield "ima_stereo.wav", riff(fmt(0x11, 2, 22050, 4, 512, ima_fmt),
+                                 chunk(b"data", adpcm_blocks(2, 512, 2, 2)))
+    # Headers the parser has to refuse or survive: blockAlign too small for
+    # the sample format, a second fmt after data, no sample rate, and a rate
+    # far below anything the engine plays
+    yield "bad_block_align.wav", riff(fmt(1, 2, 44100, 16, 1), chunk(b"data", pcm16(s2)))
+    yield "bad_second_fmt.wav", riff(fmt(1, 2, 44100, 16, 4), chunk(b"data", pcm16(s2)),
+                                     fmt(0x11, 2, 44100, 4, 9))
+    yield "bad_rate_zero.wav", riff(fmt(1, 2, 0, 16, 4), chunk(b"data", pcm16(s2)))
+    yield "bad_rate_low.wav", riff(fmt(1, 1, 68, 8, 1), chunk(b"data", bytes(range(0, 255, 4))))
+
+
+def adpcm():
+    # channels-1, blockAlign (LE), maxFrames = 1 + byte * 8, then blocks
+    yield "mono_256.bin", struct.pack("<BHB", 0, 256, 63) + adpcm_blocks(1, 256, 3, 3)
+    yield "stereo_512.bin", struct.pack("<BHB", 1, 512, 127) + adpcm_blocks(2, 512, 2, 4)
+    yield "mono_small.bin", struct.pack("<BHB", 0, 12, 0) + adpcm_blocks(1, 12, 8, 5)
+    yield "stereo_partial.bin", struct.pack("<BHB", 1, 1024, 255) + adpcm_blocks(2, 1024, 2, 6)[:1500]
+
+
+def pack(entries):
+    """A pack as tools/pack_builder writes it."""
+    header_size, entry_size, align = 32, 48, 512
+    offset = header_size + entry_size * len(entries)
+    toc = b""
+    payloads = []
+    for name, samples in entries:
+        offset = (offset + align - 1) // align * align
+        data = pcm16(samples)
+        peak = min(max(abs(s) for s in samples), 32767)
+        toc += struct.pack("<32sIIIHH", name.encode(), offset, len(data), len(samples) // 2, peak, 1000)
+        payloads.append((offset, data))
+        offset += len(data)
+    image = bytearray(offset)
+    image[header_size:header_size + len(toc)] = toc
+    for at, data in payloads:
+        image[at:at + len(data)] = data
+    image[0:header_size] = struct.pack("<IHHIHHII8s", 0x4B41504A, 1, len(entries), 44100, 2, 16,
+                                       header_size, offset, b"")
+    return bytes(image)
+
+
+def packs():
+    yield "two.jpk", pack([("intro", signal(100, 2, 1)), ("outro", signal(37, 2, 2))])
+    yield "one.jpk", pack([("a", signal(256, 2, 3))])
+    yield "empty.jpk", pack([])
+
+
+def configs():
+    full = {
+        "btDevice": "T10", "btDeviceMac": "00:11:22:33:44:55", "btVolume": 80,
+        "brightness": 200, "touchThreshold": 200, "resampleQuality": "high",
+        "clipCacheKB": 512, "triggerOn": "press", "retriggerMs": 40, "crossfadeMs": 30,
+        "loudnessTarget": -16, "bedFile": "/jingles/bed.wav", "bedLevel": 40,
+        "duckDb": -12, "duckAttackMs": 50, "duckReleaseMs": 800,
+        "buttons": [
+            {"id": 0, "label": "Intro", "file": "/jingles/intro.wav", "color": "#FF5733",
+             "mode": "restart", "chokeGroup": 1, "gainDb": -3.5, "startMs": 100, "endMs": 900},
+            {"id": 1, "file": "/jingles/show.jpk#outro", "loop": True, "mode": "overlap"},
+            {"id": 2, "file": "flash:beep", "loop": [100, 4000], "then": ["/jingles/a.wav", "/jingles/b.wav"]},
+            {"id": 7, "file": "/jingles/sound8.wav", "mode": "choke", "gainDb": 6},
+        ],
+    }
+    yield "full.json", json.dumps(full, indent=2).encode()
+    yield "minimal.json", b'{"buttons":[{"id":0,"file":"/jingles/sound1.wav"}]}'
+    yield "repair.json", json.dumps({"buttons": [
+        {"id": 0, "file": "/jingles/ok.wav", "loop": [1], "startMs": -5, "gainDb": "loud", "then": "x"},
+        3, "x", {"id": 1, "mode": 7, "gainDb": 40, "then": [1, "/jingles/ok.wav"]},
+    ]}).encode()
+    yield "not_object.json", b'[1,2,3]'
+
+
+def write(target, files):
+    path = os.path.join(OUT, target)
+    os.makedirs(path, exist_ok=True)
+    for name, data in files:
+        with open(os.path.join(path, name), "wb") as f:
+            f.write(data)
+
+
+if __name__ == "__main__":
+    write("wav", wavs())
+    write("adpcm", adpcm())
+    write("pack", packs())
+    write("config", configs())
@@ -0,0 +1,223 @@
+// Golden-PCM harness: plays fixture WAVs through the firmware's audio
+// engine, pulling the output through the A2DP data callback, and checks
+// every scenario against golden/render.txt: a CRC32 per 4096 output frames
+// (interleaved int16, little-endian host).
+//
+//   golden_render [--update] [golden dir]
+//
+// A mismatch writes the scenario's output to <name>.raw (44.1kHz stereo
+// int16) in the working directory to listen to or diff. --update rewrites
+// the goldens after a change that is meant to alter the output.
+
+#include <map>
+#include <sstream>
+#include <fstream>
+#include "audio_mixer.h"
+#include "fixtures.h"
+#include "host_engine.h"
+
+#ifndef HOST_GOLDEN_DIR
+#define HOST_GOLDEN_DIR "golden"
+#endif
+
+static const int BLOCK_FRAMES = 128;     // What the A2DP stack asks for at a time
+static const int CRC_FRAMES = 4096;
+static const uint32_t MAX_FRAMES = 10 * 44100;
+static const uint32_t FADE_FRAMES = 100 * 44100 / 1000;  // audio_player.cpp's fade-in / fade-out
+
+static AudioPlayer player;
+static std::map<std::string, std::vector<uint32_t>> expected;  // Scenario -> chunk CRCs
+static std::map<std::string, std::vector<uint32_t>> actual;
+static int failures = 0;
+static bool updating = false;
+
+static void fail(const char* scenario, const char* what) {
+    printf("FAIL %s: %s\n", scenario, what);
+    failures++;
+}
+
+static void render(std::vector<int16_t>& out, uint32_t frames) {
+    size_t at = out.size();
+    out.resize(at + frames * 2);
+    for (uint32_t done = 0; done < frames; done += BLOCK_FRAMES) {
+        hostRenderBlock(&out[at + done * 2], min((uint32_t)BLOCK_FRAMES, frames - done));
+    }
+}
+
+static void renderUntilIdle(std::vector<int16_t>& out) {
+    while (player.isPlaying() && out.size() / 2 < MAX_FRAMES) render(out, BLOCK_FRAMES);
+}
+
+static void check(const char* scenario, const std::vector<int16_t>& pcm) {
+    std::vector<uint32_t>& crcs = actual[scenario];
+    size_t frames = pcm.size() / 2;
+    for (size_t at = 0; at < frames; at += CRC_FRAMES) {
+        crcs.push_back(crc32(&pcm[at * 2], min((size_t)CRC_FRAMES, frames - at) * 4));
+    }
+    crcs.insert(crcs.begin(), (uint32_t)frames);
+    if (updating) return;
+
+    auto it = expected.find(scenario);
+    if (it == expected.end()) return fail(scenario, "no golden");
+    if (it->second == crcs) {
+        printf("ok   %s (%u frames)\n", scenario, (unsigned)frames);
+        return;
+    }
+    char what[96];
+    if (it->second[0] != crcs[0]) {
+        snprintf(what, sizeof(what), "%u frames, golden has %u", (unsigned)frames, (unsigned)it->second[0]);
+    } else {
+        size_t chunk = 1;
+        while (chunk < crcs.size() && it->second[chunk] == crcs[chunk]) chunk++;
+        snprintf(what, sizeof(what), "differs from frame %u", (unsigned)((chunk - 1) * CRC_FRAMES));
+    }
+    fail(scenario, what);
+    std::ofstream((std::string(scenario) + ".raw").c_str(), std::ios::binary)
+        .write((const char*)pcm.data(), pcm.size() * sizeof(int16_t));
+}
+
+static bool loadGoldens(const std::string& path) {
+    std::ifstream in(path.c_str());
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string name;
+        fields >> name;
+        std::vector<uint32_t>& crcs = expected[name];
+        uint32_t v;
+        fields >> std::dec >> v;
+        crcs.push_back(v);
+        while (fields >> std::hex >> v) crcs.push_back(v);
+    }
+    return true;
+}
+
+static bool saveGoldens(const std::string& path) {
+    std::ofstream out(path.c_str());
+    out << "# scenario  output frames  CRC32 of each " << CRC_FRAMES << " frames (golden_render --update)\n";
+    for (auto& s : actual) {
+        out << s.first << ' ' << std::dec << s.second[0] << std::hex;
+        for (size_t i = 1; i < s.second.size(); i++) out << ' ' << s.second[i];
+        out << '\n';
+    }
+    return (bool)out;
+}
+
+// ── Fixtures ─────────────────────────────────────────────────────────────────
+
+static const uint32_t CLIP_FRAMES_44K = 22050;  // 0.5s
+static std::vector<int32_t> stereo16;
+
+static bool writeFixtures() {
+    const std::string dir = hostSdRoot() + "/jingles/";
+    stereo16 = fixtureSignal(CLIP_FRAMES_44K, 2, 16, 1);
+    return writeWavFile(dir + "stereo16.wav", stereo16, 2, 16, 44100) &&
+           writeWavFile(dir + "mono16_22k.wav", fixtureSignal(11025, 1, 16, 2), 1, 16, 22050) &&
+           writeWavFile(dir + "stereo24_48k.wav", fixtureSignal(24000, 2, 24, 3), 2, 24, 48000) &&
+           writeWavFile(dir + "stereo16_22k.wav", fixtureSignal(11025, 2, 16, 4), 2, 16, 22050) &&
+           imaAdpcmEncodeFile("/jingles/stereo16_22k.wav", "/jingles/adpcm.wav");
+}
+
+// ── Scenarios ────────────────────────────────────────────────────────────────
+
+// A 44.1kHz 16-bit stereo clip at unity gain is copied bit for bit between
+// the fades: the whole chain (ring, convert, envelope, mix) is lossless
+static void passthrough(const char* scenario, const std::vector<int16_t>& pcm) {
+    for (uint32_t i = FADE_FRAMES * 2; i < (CLIP_FRAMES_44K - FADE_FRAMES) * 2; i++) {
+        if (pcm[i] != stereo16[i]) return fail(scenario, "not bit exact between the fades");
+    }
+}
+
+static void playOne(const char* scenario, const char* path) {
+    std::vector<int16_t> pcm;
+    if (!player.playFile(path)) return fail(scenario, "playFile() failed");
+    renderUntilIdle(pcm);
+    check(scenario, pcm);
+    if (!strcmp(scenario, "stereo16") || !strcmp(scenario, "stereo16_cached")) passthrough(scenario, pcm);
+}
+
+static void trimmed() {
+    std::vector<int16_t> pcm;
+    AudioSource src = parseAudioSource("/jingles/stereo16.wav");
+    if (!player.playFile(src, 0, TRIGGER_RESTART, 0, MIX_UNITY_GAIN, 0, 100, 300)) {
+        return fail("trimmed", "playFile() failed");
+    }
+    renderUntilIdle(pcm);
+    check("trimmed", pcm);
+}
+
+static void retrigger() {
+    std::vector<int16_t> pcm;
+    AudioSource src = parseAudioSource("/jingles/stereo24_48k.wav");
+    player.setCrossfade(20);
+    bool ok = player.playFile(src, 1, TRIGGER_RESTART, 0, MIX_UNITY_GAIN);
+    render(pcm, 4410);
+    ok = ok && player.playFile(src, 1, TRIGGER_RESTART, 0, MIX_UNITY_GAIN);
+    player.setCrossfade(0);
+    if (!ok) return fail("retrigger", "playFile() failed");
+    renderUntilIdle(pcm);
+    check("retrigger", pcm);
+}
+
+static void overlap() {
+    std::vector<int16_t> pcm;
+    AudioSource a = parseAudioSource("/jingles/mono16_22k.wav");
+    AudioSource b = parseAudioSource("/jingles/adpcm.wav");
+    bool ok = player.playFile(a, 2, TRIGGER_OVERLAP, 0, MIX_UNITY_GAIN / 2);
+    render(pcm, 2048);
+    ok = ok && player.playFile(b, 3, TRIGGER_OVERLAP, 0, MIX_UNITY_GAIN / 2);
+    if (!ok) return fail("overlap", "playFile() failed");
+    renderUntilIdle(pcm);
+    check("overlap", pcm);
+}
+
+// The tone is float sin(): checked for shape, not against a golden
+static void testTone() {
+    std::vector<int16_t> pcm;
+    if (!player.playTestSound()) return fail("test_tone", "playTestSound() failed");
+    render(pcm, 44100 + BLOCK_FRAMES);
+    int peak = 0;
+    for (uint32_t i = 0; i < 44100 * 2; i++) peak = max(peak, abs((int)pcm[i]));
+    bool silentAfter = std::all_of(pcm.begin() + 44100 * 2, pcm.end(), [](int16_t s) { return s == 0; });
+    if (peak < 15900 || peak > 16000 || !silentAfter) return fail("test_tone", "not a 1s tone at 16000");
+    printf("ok   test_tone\n");
+}
+
+int main(int argc, char** argv) {
+    std::string dir = HOST_GOLDEN_DIR;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--update")) updating = true;
+        else dir = argv[i];
+    }
+    const std::string goldens = dir + "/render.txt";
+    if (!loadGoldens(goldens) && !updating) {
+        printf("No goldens at %s (run with --update)\n", goldens.c_str());
+        return 1;
+    }
+    if (!hostEngineBegin(player, 1024 * 1024) || !writeFixtures()) {
+        printf("Host engine setup failed\n");
+        return 1;
+    }
+
+    playOne("stereo16", "/jingles/stereo16.wav");
+    playOne("stereo16_cached", "/jingles/stereo16.wav");  // Second play comes from the clip cache
+    playOne("mono16_22k", "/jingles/mono16_22k.wav");
+    playOne("stereo24_48k", "/jingles/stereo24_48k.wav");
+    playOne("adpcm", "/jingles/adpcm.wav");
+    trimmed();
+    retrigger();
+    overlap();
+    testTone();
+
+    if (actual["stereo16"] != actual["stereo16_cached"]) fail("stereo16_cached", "differs from the SD play");
+
+    if (updating) {
+        if (!saveGoldens(goldens)) return 1;
+        printf("Wrote %s\n", goldens.c_str());
+        return 0;
+    }
+    printf("%d failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
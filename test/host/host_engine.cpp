@@ -0,0 +1,30 @@
+#include "host_engine.h"
+#include "host_hal.h"
+#include <TFT_eSPI.h>
+#include <stdlib.h>
+#include <filesystem>
+
+TFT_eSPI tft;  // main.cpp's display, drawn on by the Bluetooth scan only
+
+static std::string sdRoot;
+
+const std::string& hostSdRoot() { return sdRoot; }
+
+bool hostEngineBegin(AudioPlayer& player, size_t clipCacheBytes) {
+    char dir[] = "/tmp/jingle_host_XXXXXX";
+    if (!mkdtemp(dir)) return false;
+    sdRoot = dir;
+    atexit([] { std::filesystem::remove_all(sdRoot); });
+    SD.hostMount(dir);
+    if (!SD.begin() || !SD.mkdir("/jingles")) return false;
+
+    hostRtosDeterministic(true);
+    hostSkipDelays(true);  // begin() waits a second for the link
+    if (clipCacheBytes) player.setClipCacheBudget(clipCacheBytes);
+    return player.begin("host") && BluetoothA2DPSource::hostCallback;
+}
+
+void hostRenderBlock(int16_t* out, int32_t frameCount) {
+    hostRtosSettle();
+    BluetoothA2DPSource::hostCallback((Frame*)out, frameCount);
+}
@@ -0,0 +1,21 @@
+#ifndef HOST_ENGINE_H
+#define HOST_ENGINE_H
+
+// The firmware's AudioPlayer on the host shims, set up the same way for
+// every harness: SD on a scratch directory, A2DP "connected", the stream
+// task woken only by notifications
+
+#include <string>
+#include "audio_player.h"
+
+// Creates the scratch SD card (with /jingles) and starts the player
+bool hostEngineBegin(AudioPlayer& player, size_t clipCacheBytes = 0);
+
+// Host path of the scratch SD card's root
+const std::string& hostSdRoot();
+
+// One A2DP data request of frameCount frames, after the stream task has
+// caught up with everything the last one made room for
+void hostRenderBlock(int16_t* out, int32_t frameCount);
+
+#endif
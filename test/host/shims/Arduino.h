@@ -0,0 +1,168 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Host shim of the ESP32 Arduino core: just what the audio engine and the
+// parsers use, backed by the C++ standard library (see host_arduino.cpp)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <ctype.h>
+#include <string>
+#include <algorithm>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+
+using std::min;
+using std::max;
+
+#define PROGMEM
+#define IRAM_ATTR
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+bool psramFound();
+void* ps_malloc(size_t size);
+
+class String {
+public:
+    String() {}
+    String(const char* c) : s(c ? c : "") {}
+    String(const std::string& str) : s(str) {}
+    explicit String(char c) : s(1, c) {}
+    explicit String(int v) : s(std::to_string(v)) {}
+    explicit String(unsigned v) : s(std::to_string(v)) {}
+    explicit String(long v) : s(std::to_string(v)) {}
+    explicit String(unsigned long v) : s(std::to_string(v)) {}
+    explicit String(long long v) : s(std::to_string(v)) {}
+    explicit String(unsigned long long v) : s(std::to_string(v)) {}
+    explicit String(double v, unsigned decimals = 2) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        s = buf;
+    }
+
+    const char* c_str() const { return s.c_str(); }
+    unsigned length() const { return (unsigned)s.size(); }
+    bool isEmpty() const { return s.empty(); }
+    bool reserve(unsigned size) { s.reserve(size); return true; }
+    char charAt(unsigned i) const { return i < s.size() ? s[i] : 0; }
+    char operator[](unsigned i) const { return charAt(i); }
+    char& operator[](unsigned i) { return s[i]; }
+
+    String substring(unsigned from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+    String substring(unsigned from, unsigned to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= s.size()) return String();
+        return String(s.substr(from, std::min<size_t>(to, s.size()) - from));
+    }
+    int indexOf(char c, unsigned from = 0) const { return pos(s.find(c, from)); }
+    int indexOf(const String& str, unsigned from = 0) const { return pos(s.find(str.s, from)); }
+    int lastIndexOf(char c) const { return pos(s.rfind(c)); }
+    int lastIndexOf(const String& str) const { return pos(s.rfind(str.s)); }
+    bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+    bool endsWith(const String& suffix) const {
+        return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+    }
+    bool equals(const String& o) const { return s == o.s; }
+    bool equalsIgnoreCase(const String& o) const {
+        return s.size() == o.s.size() &&
+               std::equal(s.begin(), s.end(), o.s.begin(), [](char a, char b) { return tolower(a) == tolower(b); });
+    }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return (float)atof(s.c_str()); }
+    void toLowerCase() { for (char& c : s) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (char& c : s) c = (char)toupper((unsigned char)c); }
+    void trim() {
+        size_t a = s.find_first_not_of(" \t\r\n");
+        size_t b = s.find_last_not_of(" \t\r\n");
+        s = (a == std::string::npos) ? std::string() : s.substr(a, b - a + 1);
+    }
+    void replace(const String& from, const String& to) {
+        if (from.s.empty()) return;
+        for (size_t p = s.find(from.s); p != std::string::npos; p = s.find(from.s, p + to.s.size())) {
+            s.replace(p, from.s.size(), to.s);
+        }
+    }
+    void remove(unsigned index, unsigned count = (unsigned)-1) { if (index < s.size()) s.erase(index, count); }
+    bool concat(const String& o) { s += o.s; return true; }
+    bool concat(const char* c, unsigned len) { s.append(c, len); return true; }
+
+    String& operator+=(const String& o) { s += o.s; return *this; }
+    String& operator+=(const char* o) { s += o; return *this; }
+    String& operator+=(char c) { s += c; return *this; }
+    String& operator+=(int v) { s += std::to_string(v); return *this; }
+    String& operator+=(unsigned v) { s += std::to_string(v); return *this; }
+    String& operator+=(long v) { s += std::to_string(v); return *this; }
+    String& operator+=(unsigned long v) { s += std::to_string(v); return *this; }
+
+    bool operator==(const String& o) const { return s == o.s; }
+    bool operator!=(const String& o) const { return s != o.s; }
+    bool operator==(const char* o) const { return s == (o ? o : ""); }
+    bool operator!=(const char* o) const { return !(*this == o); }
+    bool operator<(const String& o) const { return s < o.s; }
+
+private:
+    std::string s;
+    static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+};
+
+inline String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+inline String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, char b) { String r(a); r += b; return r; }
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) { return write(&c, 1); }
+    virtual size_t write(const uint8_t* buf, size_t len) = 0;
+    size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(double v, int decimals = 2) { return printf("%.*f", decimals, v); }
+    template <typename T> size_t println(const T& v) { return print(v) + println(); }
+    size_t println(double v, int decimals) { return print(v, decimals) + println(); }
+    size_t println() { return print("\n"); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    virtual void flush() {}
+};
+
+// Serial goes to stdout only with HOST_SERIAL=1 in the environment, so
+// benchmarks and test logs stay readable
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    size_t write(const uint8_t* buf, size_t len) override;
+    using Print::write;
+    int available() { return 0; }
+    int read() { return -1; }
+};
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+    void restart();
+    uint32_t getCycleCount();  // Host time in cycles of a 240 MHz core
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getFreeHeap() { return 200 * 1024; }
+    uint32_t getMinFreeHeap() { return 200 * 1024; }
+    uint32_t getMaxAllocHeap() { return 100 * 1024; }
+    uint32_t getPsramSize() { return 0; }
+    uint32_t getFreePsram() { return 0; }
+};
+extern EspClass ESP;
+
+#endif
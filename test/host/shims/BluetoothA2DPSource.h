@@ -0,0 +1,34 @@
+#ifndef HOST_BLUETOOTH_A2DP_SOURCE_H
+#define HOST_BLUETOOTH_A2DP_SOURCE_H
+
+// Host shim of ESP32-A2DP's source: keeps the data callback so a harness
+// can pull audio through it like the Bluetooth stack would
+
+#include "Arduino.h"
+
+typedef uint8_t esp_bd_addr_t[6];
+
+struct Frame {
+    int16_t channel1;
+    int16_t channel2;
+};
+
+typedef int32_t (*music_data_frames_cb_t)(Frame* data, int32_t frameCount);
+
+class BluetoothA2DPSource {
+public:
+    void set_data_callback_in_frames(music_data_frames_cb_t cb) { hostCallback = cb; }
+    void set_auto_reconnect(esp_bd_addr_t addr) { (void)addr; }
+    void set_auto_reconnect(bool enabled) { (void)enabled; }
+    void start(const char* name) { (void)name; }
+    void end(bool releaseMemory = false) { (void)releaseMemory; }
+    bool is_connected() { return hostConnected; }
+    void set_volume(uint8_t volume) { hostVolume = volume; }
+
+    // Host only: what the last instance registered, and the link state
+    static music_data_frames_cb_t hostCallback;
+    static bool hostConnected;
+    static uint8_t hostVolume;
+};
+
+#endif
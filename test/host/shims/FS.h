@@ -0,0 +1,76 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+// Host shim of the Arduino FS API: File over stdio, each FS mounted on a
+// host directory (see hostMount())
+
+#include "Arduino.h"
+#include <time.h>
+#include <memory>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct HostFileImpl;
+
+class File : public Print {
+public:
+    File() {}
+    explicit File(std::shared_ptr<HostFileImpl> impl) : impl(impl) {}
+
+    operator bool() const;
+    size_t size();
+    size_t position();
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    int available();
+    int read();
+    size_t read(uint8_t* buf, size_t len);
+    int peek();
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t len) override;
+    void flush() override;
+    void close();
+    bool isDirectory();
+    File openNextFile();
+    const char* name() const;
+    const char* path() const;
+    time_t getLastWrite();
+
+private:
+    std::shared_ptr<HostFileImpl> impl;
+};
+
+namespace fs {
+using ::File;
+
+class FS {
+public:
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    File open(const String& path, const char* mode = FILE_READ, bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+    bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+    bool mkdir(const char* path);
+    bool mkdir(const String& path) { return mkdir(path.c_str()); }
+    bool rmdir(const char* path);
+    size_t totalBytes() { return 1u << 30; }
+    size_t usedBytes() { return 0; }
+
+    // Host only: directory this file system lives in, "" = unmounted
+    void hostMount(const char* dir) { root = dir ? dir : ""; }
+
+protected:
+    std::string root;
+    std::string hostPath(const char* path) const;
+};
+}  // namespace fs
+
+#endif
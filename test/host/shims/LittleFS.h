@@ -0,0 +1,13 @@
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include "FS.h"
+
+class LittleFSFS : public fs::FS {
+public:
+    bool begin(bool formatOnFail = false);
+    void end() {}
+};
+extern LittleFSFS LittleFS;
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+// Host shim of the NVS Preferences API, one in-memory store per process
+
+#include "Arduino.h"
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end() {}
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+    bool getBool(const char* key, bool defaultValue = false);
+    size_t putBool(const char* key, bool value);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    size_t putUInt(const char* key, uint32_t value);
+    String getString(const char* key, const String& defaultValue = String());
+    size_t putString(const char* key, const String& value);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+    size_t putBytes(const char* key, const void* value, size_t len);
+
+private:
+    std::string ns;
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef HOST_SD_H
+#define HOST_SD_H
+
+#include "FS.h"
+#include "SPI.h"
+
+class SDFS : public fs::FS {
+public:
+    bool begin(uint8_t ssPin = 5, SPIClass& spi = SPI, uint32_t frequency = 4000000);
+    void end() {}
+    uint64_t cardSize() { return 1ull << 30; }
+};
+extern SDFS SD;
+
+#endif
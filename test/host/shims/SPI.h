@@ -0,0 +1,16 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include "Arduino.h"
+
+#define HSPI 2
+#define VSPI 3
+
+class SPIClass {
+public:
+    SPIClass(int bus = 0) { (void)bus; }
+    void begin(int sck = -1, int miso = -1, int mosi = -1, int ss = -1) { (void)sck; (void)miso; (void)mosi; (void)ss; }
+};
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef HOST_TFT_ESPI_H
+#define HOST_TFT_ESPI_H
+
+// Host shim of the display driver: draws nothing
+
+#include "Arduino.h"
+
+#define TFT_BLACK 0x0000
+#define TFT_NAVY 0x000F
+#define TFT_BLUE 0x001F
+#define TFT_GREEN 0x07E0
+#define TFT_CYAN 0x07FF
+#define TFT_RED 0xF800
+#define TFT_ORANGE 0xFDA0
+#define TFT_YELLOW 0xFFE0
+#define TFT_WHITE 0xFFFF
+#define TFT_DARKGREY 0x7BEF
+#define TFT_LIGHTGREY 0xD69A
+#define TL_DATUM 0
+#define TR_DATUM 2
+#define MC_DATUM 4
+
+class TFT_eSPI {
+public:
+    template <typename... A> void init(A...) {}
+    template <typename... A> void setRotation(A...) {}
+    uint8_t getRotation() { return 0; }
+    template <typename... A> void fillScreen(A...) {}
+    template <typename... A> void fillRect(A...) {}
+    template <typename... A> void fillRoundRect(A...) {}
+    template <typename... A> void drawRoundRect(A...) {}
+    template <typename... A> void setTextColor(A...) {}
+    template <typename... A> void setTextDatum(A...) {}
+    template <typename... A> void setTextSize(A...) {}
+    template <typename... A> void drawString(A...) {}
+};
+
+#endif
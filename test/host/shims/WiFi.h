@@ -0,0 +1,17 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include "Arduino.h"
+
+#define WIFI_OFF 0
+#define WIFI_STA 1
+#define WIFI_AP 2
+
+class WiFiClass {
+public:
+    void mode(int m) { (void)m; }
+    bool softAP(const char* ssid, const char* pass = nullptr) { (void)ssid; (void)pass; return true; }
+};
+extern WiFiClass WiFi;
+
+#endif
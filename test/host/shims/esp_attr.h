@@ -0,0 +1,8 @@
+#ifndef HOST_ESP_ATTR_H
+#define HOST_ESP_ATTR_H
+
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+#define DRAM_ATTR
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef HOST_ESP_BT_H
+#define HOST_ESP_BT_H
+
+#include "esp_err.h"
+
+bool btStarted();
+bool btStart();
+bool btStop();
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef HOST_ESP_BT_MAIN_H
+#define HOST_ESP_BT_MAIN_H
+
+#include "esp_err.h"
+
+esp_err_t esp_bluedroid_init();
+esp_err_t esp_bluedroid_enable();
+esp_err_t esp_bluedroid_disable();
+esp_err_t esp_bluedroid_deinit();
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef HOST_ESP_GAP_BT_API_H
+#define HOST_ESP_GAP_BT_API_H
+
+// Host shim: discovery starts and never finds anything
+
+#include "esp_err.h"
+#include "BluetoothA2DPSource.h"
+
+typedef enum { ESP_BT_GAP_DISC_RES_EVT, ESP_BT_GAP_DISC_STATE_CHANGED_EVT } esp_bt_gap_cb_event_t;
+typedef enum {
+    ESP_BT_GAP_DEV_PROP_BDNAME = 1,
+    ESP_BT_GAP_DEV_PROP_COD,
+    ESP_BT_GAP_DEV_PROP_RSSI,
+    ESP_BT_GAP_DEV_PROP_EIR
+} esp_bt_gap_dev_prop_type_t;
+typedef struct {
+    esp_bt_gap_dev_prop_type_t type;
+    int len;
+    void* val;
+} esp_bt_gap_dev_prop_t;
+typedef union {
+    struct {
+        esp_bd_addr_t bda;
+        int num_prop;
+        esp_bt_gap_dev_prop_t* prop;
+    } disc_res;
+    struct {
+        int state;
+    } disc_st_chg;
+} esp_bt_gap_cb_param_t;
+typedef void (*esp_bt_gap_cb_t)(esp_bt_gap_cb_event_t event, esp_bt_gap_cb_param_t* param);
+
+#define ESP_BT_GAP_DISCOVERY_STOPPED 0
+#define ESP_BT_GAP_DISCOVERY_STARTED 1
+#define ESP_BT_CONNECTABLE 1
+#define ESP_BT_GENERAL_DISCOVERABLE 2
+#define ESP_BT_INQ_MODE_GENERAL_INQUIRY 0
+
+esp_err_t esp_bt_gap_register_callback(esp_bt_gap_cb_t callback);
+esp_err_t esp_bt_gap_set_scan_mode(int connectable, int discoverable);
+esp_err_t esp_bt_gap_start_discovery(int mode, int inqLen, int numRsps);
+esp_err_t esp_bt_gap_cancel_discovery();
+
+#endif
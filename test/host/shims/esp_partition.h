@@ -0,0 +1,35 @@
+#ifndef HOST_ESP_PARTITION_H
+#define HOST_ESP_PARTITION_H
+
+// Host shim: the partition table is empty, so find_first() never matches
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0, ESP_PARTITION_TYPE_DATA = 1 } esp_partition_type_t;
+typedef int esp_partition_subtype_t;
+#define ESP_PARTITION_SUBTYPE_ANY 0xff
+
+typedef struct {
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+} esp_partition_t;
+
+typedef uint32_t esp_partition_mmap_handle_t;
+typedef enum { ESP_PARTITION_MMAP_DATA } esp_partition_mmap_memory_t;
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label);
+esp_err_t esp_partition_mmap(const esp_partition_t* part, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void** ptr,
+                             esp_partition_mmap_handle_t* handle);
+void esp_partition_munmap(esp_partition_mmap_handle_t handle);
+esp_err_t esp_partition_erase_range(const esp_partition_t* part, size_t offset, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t* part, size_t offset, const void* src, size_t size);
+esp_err_t esp_partition_read(const esp_partition_t* part, size_t offset, void* dst, size_t size);
+
+#endif
@@ -0,0 +1,203 @@
+// Arduino core and ESP-IDF shim: time, Serial, ESP, heap caps, NVS and
+// the Bluetooth calls the engine makes, none of which reach hardware
+
+#include "Arduino.h"
+#include "BluetoothA2DPSource.h"
+#include "Preferences.h"
+#include "SPI.h"
+#include "WiFi.h"
+#include "esp_bt.h"
+#include "esp_bt_main.h"
+#include "esp_gap_bt_api.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "host_hal.h"
+#include "nvs_flash.h"
+#include <stdarg.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI;
+WiFiClass WiFi;
+
+music_data_frames_cb_t BluetoothA2DPSource::hostCallback = nullptr;
+bool BluetoothA2DPSource::hostConnected = true;
+uint8_t BluetoothA2DPSource::hostVolume = 0;
+
+static const auto startTime = std::chrono::steady_clock::now();
+
+static uint64_t elapsedNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long millis() { return (unsigned long)(elapsedNs() / 1000000); }
+unsigned long micros() { return (unsigned long)(elapsedNs() / 1000); }
+int64_t esp_timer_get_time() { return (int64_t)(elapsedNs() / 1000); }
+void yield() { std::this_thread::yield(); }
+
+void delay(unsigned long ms) {
+    // vTaskDelay() is what honours hostSkipDelays()
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+uint32_t EspClass::getCycleCount() { return (uint32_t)(elapsedNs() * 240 / 1000); }
+
+void EspClass::restart() {
+    fprintf(stderr, "ESP.restart() called\n");
+    exit(1);
+}
+
+size_t Print::printf(const char* fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write((const uint8_t*)buf, min((size_t)n, sizeof(buf) - 1));
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t len) {
+    static const bool enabled = getenv("HOST_SERIAL") && atoi(getenv("HOST_SERIAL"));
+    if (enabled) fwrite(buf, 1, len, stdout);
+    return len;
+}
+
+// No PSRAM: every cap is the same host heap
+bool psramFound() { return false; }
+void* ps_malloc(size_t size) { return malloc(size); }
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+    (void)caps;
+    return malloc(size);
+}
+void heap_caps_free(void* ptr) { free(ptr); }
+size_t heap_caps_get_free_size(uint32_t caps) {
+    (void)caps;
+    return 200 * 1024;
+}
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    (void)caps;
+    return 100 * 1024;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    (void)type;
+    (void)subtype;
+    (void)label;
+    return nullptr;
+}
+esp_err_t esp_partition_mmap(const esp_partition_t*, size_t, size_t, esp_partition_mmap_memory_t, const void**,
+                             esp_partition_mmap_handle_t*) {
+    return ESP_ERR_NOT_FOUND;
+}
+void esp_partition_munmap(esp_partition_mmap_handle_t) {}
+esp_err_t esp_partition_erase_range(const esp_partition_t*, size_t, size_t) { return ESP_ERR_NOT_FOUND; }
+esp_err_t esp_partition_write(const esp_partition_t*, size_t, const void*, size_t) { return ESP_ERR_NOT_FOUND; }
+esp_err_t esp_partition_read(const esp_partition_t*, size_t, void*, size_t) { return ESP_ERR_NOT_FOUND; }
+
+bool btStarted() { return false; }
+bool btStart() { return true; }
+bool btStop() { return true; }
+esp_err_t esp_bluedroid_init() { return ESP_OK; }
+esp_err_t esp_bluedroid_enable() { return ESP_OK; }
+esp_err_t esp_bluedroid_disable() { return ESP_OK; }
+esp_err_t esp_bluedroid_deinit() { return ESP_OK; }
+esp_err_t esp_bt_gap_register_callback(esp_bt_gap_cb_t) { return ESP_OK; }
+esp_err_t esp_bt_gap_set_scan_mode(int, int) { return ESP_OK; }
+esp_err_t esp_bt_gap_start_discovery(int, int, int) { return ESP_OK; }
+esp_err_t esp_bt_gap_cancel_discovery() { return ESP_OK; }
+
+// ── NVS ──────────────────────────────────────────────────────────────────────
+
+static std::mutex nvsMutex;
+static std::map<std::string, std::vector<uint8_t>> nvs;  // "namespace/key" -> value
+
+static std::vector<uint8_t>* nvsFind(const std::string& key) {
+    auto it = nvs.find(key);
+    return it == nvs.end() ? nullptr : &it->second;
+}
+
+esp_err_t nvs_flash_erase_partition(const char* label) {
+    (void)label;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    nvs.clear();
+    return ESP_OK;
+}
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    (void)readOnly;
+    ns = std::string(name) + "/";
+    return true;
+}
+
+bool Preferences::clear() {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    for (auto it = nvs.begin(); it != nvs.end();) {
+        it = it->first.compare(0, ns.size(), ns) == 0 ? nvs.erase(it) : std::next(it);
+    }
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return nvs.erase(ns + key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return nvsFind(ns + key) != nullptr;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    std::vector<uint8_t>* v = nvsFind(ns + key);
+    return v ? v->size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    std::vector<uint8_t>* v = nvsFind(ns + key);
+    if (!v || v->size() > maxLen) return 0;
+    memcpy(buf, v->data(), v->size());
+    return v->size();
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    nvs[ns + key].assign((const uint8_t*)value, (const uint8_t*)value + len);
+    return len;
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+    uint8_t v;
+    return getBytes(key, &v, 1) == 1 ? v != 0 : defaultValue;
+}
+
+size_t Preferences::putBool(const char* key, bool value) {
+    uint8_t v = value;
+    return putBytes(key, &v, 1);
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    uint32_t v;
+    return getBytes(key, &v, sizeof(v)) == sizeof(v) ? v : defaultValue;
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    std::vector<uint8_t>* v = nvsFind(ns + key);
+    return v ? String(std::string(v->begin(), v->end())) : defaultValue;
+}
+
+size_t Preferences::putString(const char* key, const String& value) {
+    return putBytes(key, value.c_str(), value.length());
+}
@@ -0,0 +1,163 @@
+// FS / SD shim: files and directories under the directory the harness
+// mounted the file system on
+
+#include "FS.h"
+#include "LittleFS.h"
+#include "SD.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+SDFS SD;
+LittleFSFS LittleFS;
+
+struct HostFileImpl {
+    FILE* fp = nullptr;
+    bool dir = false;
+    std::string path;                  // As the firmware sees it
+    std::string hostPath;
+    std::vector<std::string> entries;  // Directory listing, sorted
+    size_t nextEntry = 0;
+    const fs::FS* owner = nullptr;
+
+    ~HostFileImpl() {
+        if (fp) fclose(fp);
+    }
+};
+
+static std::string baseName(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+File::operator bool() const { return impl && (impl->fp || impl->dir); }
+
+size_t File::size() {
+    if (!impl || !impl->fp) return 0;
+    struct stat st;
+    fflush(impl->fp);
+    return fstat(fileno(impl->fp), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+size_t File::position() { return impl && impl->fp ? (size_t)ftell(impl->fp) : 0; }
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!impl || !impl->fp) return false;
+    static const int whence[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return fseek(impl->fp, (long)pos, whence[mode]) == 0;
+}
+
+int File::available() {
+    if (!impl || !impl->fp) return 0;
+    return (int)(size() - position());
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::read(uint8_t* buf, size_t len) { return impl && impl->fp ? fread(buf, 1, len, impl->fp) : 0; }
+
+int File::peek() {
+    if (!impl || !impl->fp) return -1;
+    int c = fgetc(impl->fp);
+    if (c != EOF) ungetc(c, impl->fp);
+    return c == EOF ? -1 : c;
+}
+
+size_t File::write(const uint8_t* buf, size_t len) { return impl && impl->fp ? fwrite(buf, 1, len, impl->fp) : 0; }
+
+void File::flush() {
+    if (impl && impl->fp) fflush(impl->fp);
+}
+
+void File::close() { impl.reset(); }
+
+bool File::isDirectory() { return impl && impl->dir; }
+
+File File::openNextFile() {
+    if (!impl || !impl->dir || impl->nextEntry >= impl->entries.size()) return File();
+    std::string child = impl->path;
+    if (child.empty() || child.back() != '/') child += '/';
+    child += impl->entries[impl->nextEntry++];
+    return const_cast<fs::FS*>(impl->owner)->open(child.c_str());
+}
+
+const char* File::name() const {
+    static thread_local std::string n;
+    n = impl ? baseName(impl->path) : "";
+    return n.c_str();
+}
+
+const char* File::path() const { return impl ? impl->path.c_str() : ""; }
+
+time_t File::getLastWrite() {
+    if (!impl) return 0;
+    struct stat st;
+    return stat(impl->hostPath.c_str(), &st) == 0 ? st.st_mtime : 0;
+}
+
+namespace fs {
+
+std::string FS::hostPath(const char* path) const {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    return root + p;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    (void)create;
+    if (root.empty() || !path) return File();
+    auto impl = std::make_shared<HostFileImpl>();
+    impl->path = path;
+    impl->hostPath = hostPath(path);
+    impl->owner = this;
+
+    struct stat st;
+    if (stat(impl->hostPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        DIR* d = opendir(impl->hostPath.c_str());
+        if (!d) return File();
+        while (struct dirent* e = readdir(d)) {
+            if (strcmp(e->d_name, ".") && strcmp(e->d_name, "..")) impl->entries.push_back(e->d_name);
+        }
+        closedir(d);
+        std::sort(impl->entries.begin(), impl->entries.end());
+        impl->dir = true;
+        return File(impl);
+    }
+
+    const char* m = !strcmp(mode, FILE_WRITE) ? "w+b" : !strcmp(mode, FILE_APPEND) ? "a+b" : "rb";
+    impl->fp = fopen(impl->hostPath.c_str(), m);
+    return impl->fp ? File(impl) : File();
+}
+
+bool FS::exists(const char* path) {
+    struct stat st;
+    return !root.empty() && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) { return !root.empty() && ::unlink(hostPath(path).c_str()) == 0; }
+
+bool FS::rename(const char* from, const char* to) {
+    return !root.empty() && ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) { return !root.empty() && ::mkdir(hostPath(path).c_str(), 0755) == 0; }
+
+bool FS::rmdir(const char* path) { return !root.empty() && ::rmdir(hostPath(path).c_str()) == 0; }
+
+}  // namespace fs
+
+bool SDFS::begin(uint8_t ssPin, SPIClass& spi, uint32_t frequency) {
+    (void)ssPin;
+    (void)spi;
+    (void)frequency;
+    return !root.empty();
+}
+
+bool LittleFSFS::begin(bool formatOnFail) {
+    (void)formatOnFail;
+    return !root.empty();
+}
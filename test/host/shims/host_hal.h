@@ -0,0 +1,21 @@
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+// Host-only controls of the shims, for harnesses and benchmarks
+
+#include <stdint.h>
+
+// Stream tasks wake only when notified, never on a timeout, so how far
+// they get between two render() calls no longer depends on the host
+// scheduler. Set before the tasks are created.
+void hostRtosDeterministic(bool on);
+
+// Kick every task and wait until each is blocked in ulTaskNotifyTake()
+// again with nothing pending: all the work the last call made possible
+// is done
+void hostRtosSettle();
+
+// delay() / vTaskDelay() return at once (benchmarks, begin()'s connect wait)
+void hostSkipDelays(bool on);
+
+#endif
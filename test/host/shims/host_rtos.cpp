@@ -0,0 +1,154 @@
+// FreeRTOS shim: one std::thread per task, task notifications as a counter
+// under a condition variable, mutexes as counting semaphores
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "host_hal.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct HostTask {
+    std::mutex m;
+    std::condition_variable cv;
+    uint32_t notify = 0;
+    bool waiting = false;  // Blocked in ulTaskNotifyTake()
+    bool done = false;
+};
+
+struct HostSemaphore {
+    std::mutex m;
+    std::condition_variable cv;
+    int count = 1;
+};
+
+namespace {
+struct TaskExit {};  // vTaskDelete(nullptr) unwinds the task's thread
+
+std::mutex tasksMutex;
+std::vector<HostTask*> tasks;  // Never freed: handles stay valid to the end
+thread_local HostTask* currentTask = nullptr;
+bool deterministic = false;
+bool skipDelays = false;
+auto startTime = std::chrono::steady_clock::now();
+
+void sleepTicks(TickType_t ticks) {
+    if (skipDelays) {
+        std::this_thread::yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+}  // namespace
+
+void hostRtosDeterministic(bool on) { deterministic = on; }
+void hostSkipDelays(bool on) { skipDelays = on; }
+
+void hostRtosSettle() {
+    std::vector<HostTask*> all;
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        all = tasks;
+    }
+    for (HostTask* t : all) {
+        std::unique_lock<std::mutex> lock(t->m);
+        if (t->done) continue;
+        t->notify++;
+        t->cv.notify_all();
+        t->cv.wait(lock, [t] { return t->done || (t->waiting && t->notify == 0); });
+    }
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackBytes, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    (void)name;
+    (void)stackBytes;
+    (void)priority;
+    (void)core;
+    HostTask* t = new HostTask;
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        tasks.push_back(t);
+    }
+    if (handle) *handle = t;
+    std::thread([t, fn, param] {
+        currentTask = t;
+        try {
+            fn(param);
+        } catch (const TaskExit&) {
+        }
+        std::lock_guard<std::mutex> lock(t->m);
+        t->done = true;
+        t->cv.notify_all();
+    }).detach();
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (!task || task == currentTask) throw TaskExit();
+    // Another task: not needed by the engine, the thread runs on detached
+}
+
+void vTaskDelay(TickType_t ticks) { sleepTicks(ticks); }
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - startTime).count();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    HostTask* t = currentTask;
+    if (!t) {
+        sleepTicks(ticks == portMAX_DELAY ? 1 : ticks);
+        return 0;
+    }
+    std::unique_lock<std::mutex> lock(t->m);
+    if (t->notify == 0) {
+        t->waiting = true;
+        t->cv.notify_all();  // hostRtosSettle() may be waiting for this
+        auto woken = [t] { return t->notify > 0; };
+        if (deterministic || ticks == portMAX_DELAY) {
+            t->cv.wait(lock, woken);
+        } else {
+            t->cv.wait_for(lock, std::chrono::milliseconds(ticks), woken);
+        }
+        t->waiting = false;
+    }
+    uint32_t count = t->notify;
+    if (count) t->notify = clearOnExit ? 0 : count - 1;
+    return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (!task) return pdFAIL;
+    std::lock_guard<std::mutex> lock(task->m);
+    task->notify++;
+    task->cv.notify_all();
+    return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new HostSemaphore; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(sem->m);
+    auto free = [sem] { return sem->count > 0; };
+    if (ticks == portMAX_DELAY) {
+        sem->cv.wait(lock, free);
+    } else if (!sem->cv.wait_for(lock, std::chrono::milliseconds(ticks), free)) {
+        return pdFALSE;
+    }
+    sem->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    std::lock_guard<std::mutex> lock(sem->m);
+    sem->count++;
+    sem->cv.notify_one();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) { delete sem; }
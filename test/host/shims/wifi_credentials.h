@@ -0,0 +1,8 @@
+#ifndef WIFI_CREDENTIALS_H
+#define WIFI_CREDENTIALS_H
+
+// Host build: no network, placeholders only
+#define WIFI_SSID "host"
+#define WIFI_PASSWORD "host"
+
+#endif
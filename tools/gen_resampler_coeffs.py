@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""Generate include/resampler_coeffs.h (polyphase FIR tables for Resampler).
+
+Kaiser-windowed sinc, one table per quality level and per cutoff:
+  *_UP   - input rate <= 44.1 kHz, cutoff at 0.45 x input rate
+  *_DOWN - 48 kHz input, cutoff at 0.45 x 44.1 kHz
+Every phase is normalised to sum to exactly 16384 (unity DC gain, Q14 so
+the centre tap of the unity phase still fits in int16).
+
+Usage: python3 tools/gen_resampler_coeffs.py > include/resampler_coeffs.h
+"""
+import math
+
+QUALITIES = [
+    # name,   taps, phase_bits, kaiser beta
+    ("LOW",    2,    6,         None),   # Linear interpolation
+    ("MEDIUM", 8,    5,         6.0),
+    ("HIGH",   16,   6,         8.0),
+]
+CUTOFFS = [("UP", 0.45), ("DOWN", 0.45 * 44100 / 48000)]
+
+
+def bessel_i0(x):
+    total, term, k = 1.0, 1.0, 1
+    while term > 1e-12 * total:
+        term *= (x / (2 * k)) ** 2
+        total += term
+        k += 1
+    return total
+
+
+def phase_coeffs(taps, d, fc, beta):
+    if beta is None:
+        return [1.0 - d, d]
+    half = taps / 2
+    c = half - 1 + d
+    out = []
+    for k in range(taps):
+        x = k - c
+        s = 2 * fc * (math.sin(2 * math.pi * fc * x) / (2 * math.pi * fc * x) if x else 1.0)
+        r = x / half
+        w = bessel_i0(beta * math.sqrt(max(0.0, 1 - r * r))) / bessel_i0(beta)
+        out.append(s * w)
+    return out
+
+
+def quantise(coeffs):
+    total = sum(coeffs)
+    q = [int(round(c / total * 16384)) for c in coeffs]
+    # Push the rounding error into the largest tap so the sum is exact
+    q[max(range(len(q)), key=lambda i: abs(q[i]))] += 16384 - sum(q)
+    return q
+
+
+def main():
+    print("// Generated by tools/gen_resampler_coeffs.py - do not edit")
+    print("#ifndef RESAMPLER_COEFFS_H")
+    print("#define RESAMPLER_COEFFS_H")
+    print()
+    print("#include <stdint.h>")
+    print()
+    print("// const tables land in flash (.rodata/DROM), not in DRAM")
+    for name, taps, bits, beta in QUALITIES:
+        print()
+        print("#define RS_%s_TAPS %d" % (name, taps))
+        print("#define RS_%s_PHASE_BITS %d" % (name, bits))
+        for cname, fc in CUTOFFS:
+            if beta is None and cname == "DOWN":
+                continue
+            print("static const int16_t RS_%s_%s[%d * %d] = {" % (name, cname, 1 << bits, taps))
+            for p in range(1 << bits):
+                q = quantise(phase_coeffs(taps, p / (1 << bits), fc, beta))
+                print("    " + ", ".join("%d" % v for v in q) + ",")
+            print("};")
+    print()
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,298 @@
+// Jingle pack builder: converts a folder of WAV files into one *.jpk pack
+// (see include/jingle_pack_format.h). Every entry is resampled to 44.1 kHz,
+// converted to stereo s16 with TPDF dither and stored sector aligned, so
+// the firmware only ever does one seek and linear reads per jingle.
+//
+// Usage: jpack_build <wav folder> <out.jpk>
+
+#include "jingle_pack_format.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const int RESAMPLE_HALF_TAPS = 32;   // Zero crossings each side
+static const double RESAMPLE_BETA = 9.0;    // Kaiser window
+
+struct Clip {
+    std::string name;
+    std::vector<int16_t> pcm;  // Interleaved stereo at 44.1 kHz
+    uint16_t peak = 0;
+    uint16_t rms = 0;
+};
+
+// ── WAV reading ───────────────────────────────────────────────────────────────
+
+static uint16_t le16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t le32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+// Decode any PCM / float WAV to stereo float in [-1, 1)
+static bool readWav(const fs::path& path, std::vector<float>& stereo, uint32_t& rate, std::string& err) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (file.size() < 12 || memcmp(file.data(), "RIFF", 4) != 0 || memcmp(file.data() + 8, "WAVE", 4) != 0) {
+        err = "not a RIFF/WAVE file";
+        return false;
+    }
+
+    uint16_t format = 0, channels = 0, bits = 0, blockAlign = 0;
+    const uint8_t* data = nullptr;
+    size_t dataSize = 0;
+
+    for (size_t off = 12; off + 8 <= file.size();) {
+        const uint8_t* chunk = file.data() + off;
+        uint32_t size = le32(chunk + 4);
+        size_t avail = file.size() - off - 8;
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16 && avail >= 16) {
+            format = le16(chunk + 8);
+            channels = le16(chunk + 10);
+            rate = le32(chunk + 12);
+            blockAlign = le16(chunk + 20);
+            bits = le16(chunk + 22);
+            if (format == 0xFFFE && size >= 40 && avail >= 40) format = le16(chunk + 32);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            data = chunk + 8;
+            dataSize = std::min<size_t>(size ? size : avail, avail);
+            break;
+        }
+        off += 8 + (size_t)size + (size & 1);
+    }
+
+    if (!data || channels == 0 || rate == 0 || blockAlign != channels * bits / 8) {
+        err = "missing or inconsistent fmt/data chunk";
+        return false;
+    }
+    bool isFloat = (format == 3 && (bits == 32 || bits == 64));
+    if (!isFloat && !(format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32))) {
+        err = "unsupported sample format " + std::to_string(format) + "/" + std::to_string(bits) + "-bit";
+        return false;
+    }
+
+    size_t frames = dataSize / blockAlign;
+    int bytes = bits / 8;
+    stereo.resize(frames * 2);
+    for (size_t f = 0; f < frames; f++) {
+        float ch[2] = {0, 0};
+        for (int c = 0; c < channels; c++) {
+            const uint8_t* p = data + f * blockAlign + c * bytes;
+            float s;
+            if (isFloat && bits == 32) {
+                uint32_t u = le32(p);
+                memcpy(&s, &u, 4);
+            } else if (isFloat) {
+                uint64_t u = le32(p) | ((uint64_t)le32(p + 4) << 32);
+                double d;
+                memcpy(&d, &u, 8);
+                s = (float)d;
+            } else if (bits == 8) {
+                s = (p[0] - 128) / 128.0f;
+            } else if (bits == 16) {
+                s = (int16_t)le16(p) / 32768.0f;
+            } else if (bits == 24) {
+                s = (int32_t)((p[0] << 8) | (p[1] << 16) | ((uint32_t)p[2] << 24)) / 2147483648.0f;
+            } else {
+                s = (int32_t)le32(p) / 2147483648.0f;
+            }
+            // Mono goes to both sides, extra channels fold into L/R
+            if (channels == 1) {
+                ch[0] = ch[1] = s;
+            } else {
+                ch[c & 1] += (c < 2) ? s : s * 0.5f;
+            }
+        }
+        stereo[2 * f] = ch[0];
+        stereo[2 * f + 1] = ch[1];
+    }
+    return true;
+}
+
+// ── Conversion ────────────────────────────────────────────────────────────────
+
+static double besselI0(double x) {
+    double total = 1.0, term = 1.0;
+    for (int k = 1; term > 1e-12 * total; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        total += term;
+    }
+    return total;
+}
+
+// Kaiser-windowed sinc, evaluated directly (offline, so no tables needed)
+static std::vector<float> resample(const std::vector<float>& in, uint32_t inRate, uint32_t outRate) {
+    if (inRate == outRate) return in;
+
+    size_t inFrames = in.size() / 2;
+    size_t outFrames = (size_t)((double)inFrames * outRate / inRate);
+    double ratio = (double)inRate / outRate;
+    double cutoff = 0.95 * std::min(1.0, (double)outRate / inRate);  // Relative to input Nyquist
+    double halfWidth = RESAMPLE_HALF_TAPS / cutoff;
+    double i0Beta = besselI0(RESAMPLE_BETA);
+
+    std::vector<float> out(outFrames * 2);
+    for (size_t o = 0; o < outFrames; o++) {
+        double centre = o * ratio;
+        long first = (long)std::ceil(centre - halfWidth);
+        long last = (long)std::floor(centre + halfWidth);
+        double acc[2] = {0, 0};
+        for (long i = std::max(first, 0L); i <= last && i < (long)inFrames; i++) {
+            double x = i - centre;
+            double t = x / halfWidth;
+            double window = besselI0(RESAMPLE_BETA * std::sqrt(std::max(0.0, 1 - t * t))) / i0Beta;
+            double arg = M_PI * x * cutoff;
+            double sinc = (x == 0) ? 1.0 : std::sin(arg) / arg;
+            double w = cutoff * sinc * window;
+            acc[0] += w * in[2 * i];
+            acc[1] += w * in[2 * i + 1];
+        }
+        out[2 * o] = (float)acc[0];
+        out[2 * o + 1] = (float)acc[1];
+    }
+    return out;
+}
+
+static void quantize(const std::vector<float>& in, Clip& clip) {
+    uint32_t rng = 0x9E3779B9u;
+    auto uniform = [&rng]() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng / 4294967296.0;
+    };
+
+    double sumSquares = 0;
+    uint32_t peak = 0;
+    clip.pcm.resize(in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        double v = in[i] * 32768.0 + (uniform() - uniform());  // TPDF, +-1 LSB
+        long s = std::lround(v);
+        s = std::max(-32768L, std::min(32767L, s));
+        clip.pcm[i] = (int16_t)s;
+        peak = std::max<uint32_t>(peak, (uint32_t)std::labs(s));
+        sumSquares += (double)s * s;
+    }
+    clip.peak = (uint16_t)std::min<uint32_t>(peak, 32767);
+    clip.rms = in.empty() ? 0 : (uint16_t)std::sqrt(sumSquares / in.size());
+}
+
+static std::string entryName(const fs::path& path) {
+    std::string name = path.stem().string();
+    for (char& c : name) {
+        if (c == '/' || c == '\\' || c == '#') c = '_';
+    }
+    if (name.size() >= JPACK_NAME_LEN) name.resize(JPACK_NAME_LEN - 1);
+    return name;
+}
+
+// ── Pack writing ──────────────────────────────────────────────────────────────
+
+static uint32_t alignUp(uint32_t v) {
+    return (v + JPACK_ALIGN - 1) / JPACK_ALIGN * JPACK_ALIGN;
+}
+
+static bool writePack(const fs::path& out, const std::vector<Clip>& clips) {
+    std::vector<JPackEntry> toc(clips.size());
+    uint32_t offset = alignUp(sizeof(JPackHeader) + clips.size() * sizeof(JPackEntry));
+    for (size_t i = 0; i < clips.size(); i++) {
+        JPackEntry& e = toc[i];
+        memset(&e, 0, sizeof(e));
+        strncpy(e.name, clips[i].name.c_str(), JPACK_NAME_LEN - 1);
+        e.offset = offset;
+        e.size = clips[i].pcm.size() * sizeof(int16_t);
+        e.frames = clips[i].pcm.size() / 2;
+        e.peak = clips[i].peak;
+        e.rms = clips[i].rms;
+        if ((uint64_t)offset + alignUp(e.size) > UINT32_MAX) {
+            fprintf(stderr, "Pack would exceed 4 GB\n");
+            return false;
+        }
+        offset += alignUp(e.size);
+    }
+
+    JPackHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = JPACK_MAGIC;
+    hdr.version = JPACK_VERSION;
+    hdr.entryCount = clips.size();
+    hdr.sampleRate = JPACK_SAMPLE_RATE;
+    hdr.channels = JPACK_CHANNELS;
+    hdr.bitsPerSample = 16;
+    hdr.tocOffset = sizeof(JPackHeader);
+    hdr.totalSize = offset;
+
+    // One sequential pass, so the copy on the card ends up contiguous
+    std::ofstream f(out, std::ios::binary | std::ios::trunc);
+    static const char zeros[JPACK_ALIGN] = {};
+    f.write((const char*)&hdr, sizeof(hdr));
+    f.write((const char*)toc.data(), toc.size() * sizeof(JPackEntry));
+    f.write(zeros, toc.empty() ? alignUp(sizeof(hdr)) - sizeof(hdr)
+                               : toc[0].offset - sizeof(hdr) - toc.size() * sizeof(JPackEntry));
+    for (size_t i = 0; i < clips.size(); i++) {
+        f.write((const char*)clips[i].pcm.data(), toc[i].size);
+        f.write(zeros, alignUp(toc[i].size) - toc[i].size);
+    }
+    return f.good();
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <wav folder> <out.jpk>\n", argv[0]);
+        return 2;
+    }
+
+    uint16_t probe = 1;
+    if (*(uint8_t*)&probe != 1) {
+        fprintf(stderr, "Big-endian hosts are not supported\n");
+        return 1;
+    }
+
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(argv[1])) {
+        std::string ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (entry.is_regular_file() && ext == ".wav") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());  // Deterministic pack layout
+
+    if (files.size() > JPACK_MAX_ENTRIES) {
+        fprintf(stderr, "Too many files (%zu, max %d)\n", files.size(), JPACK_MAX_ENTRIES);
+        return 1;
+    }
+
+    std::vector<Clip> clips;
+    for (const fs::path& path : files) {
+        std::vector<float> stereo;
+        uint32_t rate = 0;
+        std::string err;
+        if (!readWav(path, stereo, rate, err)) {
+            fprintf(stderr, "Skipping %s: %s\n", path.filename().string().c_str(), err.c_str());
+            continue;
+        }
+
+        Clip clip;
+        clip.name = entryName(path);
+        for (const Clip& other : clips) {
+            if (other.name == clip.name) {
+                fprintf(stderr, "Duplicate entry name '%s'\n", clip.name.c_str());
+                return 1;
+            }
+        }
+        quantize(resample(stereo, rate, JPACK_SAMPLE_RATE), clip);
+        printf("%-31s %6u Hz -> %7zu frames, peak %5u, rms %5u\n", clip.name.c_str(), rate,
+               clip.pcm.size() / 2, clip.peak, clip.rms);
+        clips.push_back(std::move(clip));
+    }
+
+    if (!writePack(argv[2], clips)) {
+        fprintf(stderr, "Failed to write %s\n", argv[2]);
+        return 1;
+    }
+    printf("Wrote %s (%zu entries)\n", argv[2], clips.size());
+    return 0;
+}